@@ -0,0 +1,329 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the calendar queue pending event set for the Discrete Event
+*     Simulation system.  See calendar_queue.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <algorithm>
+#include <limits>
+
+#include "calendar_queue.hpp"
+
+// Smallest number of buckets the calendar will shrink to.  Must be a power
+// of two.
+constexpr static size_t kMinBuckets = 2;
+// Day width used until there are enough events to estimate a better one.
+constexpr static SimTime::SimTick kInitialWidth = 1;
+// Number of events, from the front of the queue, used to estimate the day
+// width when resizing.
+constexpr static size_t kWidthSampleSize = 25;
+// Marks "min_bucket_" as invalid
+constexpr static size_t kNoBucket = std::numeric_limits<size_t>::max();
+// Largest representable tick count
+constexpr static SimTime::SimTick kMaxTicks =
+                           std::numeric_limits<SimTime::SimTick>::max();
+
+
+// Adds "addend" to "ticks", saturating at the largest tick count rather
+// than wrapping around.
+//
+// Returns - the saturated sum
+static SimTime::SimTick SaturatingAdd(SimTime::SimTick ticks,
+                                      SimTime::SimTick addend) {
+  return (ticks > kMaxTicks - addend) ? kMaxTicks : ticks + addend;
+}
+
+
+// Returns - the tick count of "event"
+static SimTime::SimTick EventTicks(const SimBaseEvent *event) {
+  return event->event_time().ticks();
+}
+
+
+// Start out with the smallest calendar.  It will grow as events arrive.
+CalendarQueue::CalendarQueue() : buckets_(kMinBuckets),
+                                 bucket_mask_(kMinBuckets - 1),
+                                 bucket_width_(kInitialWidth), size_(0),
+                                 cursor_bucket_(0),
+                                 cursor_top_(kInitialWidth),
+                                 min_bucket_(kNoBucket),
+                                 grow_threshold_(2 * kMinBuckets),
+                                 shrink_threshold_(0) {
+}
+
+
+// The queue doesn't own the events, so there is nothing to clean up
+// beyond the bucket array.
+CalendarQueue::~CalendarQueue() {
+}
+
+
+// Adds an event to its bucket, and moves the search cursor back if the
+// new event is earlier than the current day.  Doubles the number of
+// buckets if the queue has grown too large for the calendar.
+//
+// "new_event" - the event to place in the queue
+void CalendarQueue::Push(SimBaseEvent *new_event) {
+  const SimTime::SimTick ticks = EventTicks(new_event);
+  Insert(new_event);
+  ++size_;
+  // "cursor_top_ - bucket_width_" is the start of the cursor's day, unless
+  // the top saturated, in which case the comparison is merely
+  // conservative.
+  if ((cursor_top_ >= bucket_width_) &&
+      (ticks < cursor_top_ - bucket_width_)) {
+    SetCursor(ticks);
+    min_bucket_ = kNoBucket;
+  } else if ((min_bucket_ != kNoBucket) &&
+             (ticks < EventTicks(buckets_[min_bucket_].front()))) {
+    // A new earliest event
+    min_bucket_ = kNoBucket;
+  }
+  if (size_ > grow_threshold_) {
+    Resize(2 * buckets_.size());
+  }
+}
+
+
+// Removes the event at the front of the earliest bucket.  Halves the
+// number of buckets if the queue has shrunk too small for the calendar.
+//
+// Returns - the earliest event
+SimBaseEvent *CalendarQueue::PopMin() {
+  SimBaseEvent *min_event = buckets_[FindMinBucket()].PopFront();
+  --size_;
+  min_bucket_ = kNoBucket;
+  if ((size_ < shrink_threshold_) && (buckets_.size() > kMinBuckets)) {
+    Resize(buckets_.size() / 2);
+  }
+  return min_event;
+}
+
+
+// Returns - the earliest event, without removing it.
+SimBaseEvent *CalendarQueue::PeekMin() {
+  return buckets_[FindMinBucket()].front();
+}
+
+
+// Events can only be in the bucket for their time, and carry their own
+// links, so the event is unlinked from that bucket directly.
+//
+// "event" - the event to remove
+// Returns - "true" if the event was in the queue
+bool CalendarQueue::Remove(SimBaseEvent *event) {
+  Bucket &bucket = buckets_[BucketIndex(EventTicks(event))];
+  if (!bucket.Contains(event)) {
+    return false;
+  }
+  bucket.Erase(event);
+  --size_;
+  min_bucket_ = kNoBucket;
+  if ((size_ < shrink_threshold_) && (buckets_.size() > kMinBuckets)) {
+    Resize(buckets_.size() / 2);
+  }
+  return true;
+}
+
+
+// Gathers the buckets, then sorts on time.  The sort is stable, and events
+// with the same time share a bucket, so FIFO order is preserved.
+//
+// "events" - receives the ordered events.
+void CalendarQueue::OrderedEvents(std::vector<SimBaseEvent *> *events) const {
+  events->clear();
+  events->reserve(size_);
+  for (const Bucket &bucket : buckets_) {
+    for (SimBaseEvent *event = bucket.front(); event != nullptr;
+         event = EventChain::Next(event)) {
+      events->push_back(event);
+    }
+  }
+  std::stable_sort(events->begin(), events->end(),
+                   [](const SimBaseEvent *left, const SimBaseEvent *right) {
+                     return left->EarlierThan(*right);
+                   });
+}
+
+
+// Deletes every event and empties the buckets.  The calendar geometry is
+// left alone.
+void CalendarQueue::Clear() {
+  for (Bucket &bucket : buckets_) {
+    SimBaseEvent *event = bucket.front();
+    while (event != nullptr) {
+      SimBaseEvent *next = EventChain::Next(event);
+      delete event;
+      event = next;
+    }
+  }
+  Discard();
+}
+
+
+// Empties the buckets without touching the events.  The calendar geometry
+// is left alone.
+void CalendarQueue::Discard() {
+  for (Bucket &bucket : buckets_) {
+    bucket.Reset();
+  }
+  size_ = 0;
+  min_bucket_ = kNoBucket;
+}
+
+
+// Points the search cursor at the day that contains "ticks".
+//
+// "ticks" - a time in the day that the cursor should point to
+void CalendarQueue::SetCursor(SimTime::SimTick ticks) {
+  cursor_bucket_ = BucketIndex(ticks);
+  cursor_top_ = SaturatingAdd(ticks - (ticks % bucket_width_),
+                              bucket_width_);
+}
+
+
+// Walks the calendar one day at a time, starting at the cursor.  The first
+// bucket whose front event falls within the current day holds the
+// earliest event.  If a whole year passes without finding one, the events
+// are sparse compared to the day width, so fall back to a direct search
+// of the front of every bucket.
+//
+// Returns - the index of the bucket holding the earliest event
+size_t CalendarQueue::FindMinBucket() {
+  if (min_bucket_ != kNoBucket) {
+    return min_bucket_;
+  }
+  size_t index = cursor_bucket_;
+  SimTime::SimTick top = cursor_top_;
+  for (size_t day = 0; day < buckets_.size(); ++day) {
+    const Bucket &bucket = buckets_[index];
+    if (!bucket.empty() && (EventTicks(bucket.front()) < top)) {
+      cursor_bucket_ = index;
+      cursor_top_ = top;
+      min_bucket_ = index;
+      return index;
+    }
+    index = (index + 1) & bucket_mask_;
+    top = SaturatingAdd(top, bucket_width_);
+  }
+
+  // Direct search.  Events with the same time share a bucket, so the
+  // fronts of the buckets all have different times.
+  SimTime::SimTick min_ticks = kMaxTicks;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    if (!buckets_[i].empty() &&
+        ((min_bucket_ == kNoBucket) ||
+         (EventTicks(buckets_[i].front()) < min_ticks))) {
+      min_bucket_ = i;
+      min_ticks = EventTicks(buckets_[i].front());
+    }
+  }
+  SetCursor(min_ticks);
+  return min_bucket_;
+}
+
+
+// Inserts "new_event" into its bucket after all events with the same, or
+// earlier, times.  The scan starts at the back of the bucket, since new
+// events tend to be later than those already queued.
+//
+// "new_event" - the event to place in the queue
+void CalendarQueue::Insert(SimBaseEvent *new_event) {
+  const SimTime::SimTick ticks = EventTicks(new_event);
+  Bucket &bucket = buckets_[BucketIndex(ticks)];
+  // "position" is the event to insert in front of, or nullptr for the end
+  SimBaseEvent *position = nullptr;
+  SimBaseEvent *before = bucket.back();
+  while ((before != nullptr) && (EventTicks(before) > ticks)) {
+    position = before;
+    before = EventChain::Prev(before);
+  }
+  bucket.InsertBefore(position, new_event);
+}
+
+
+// Moves every event into a new set of buckets.  Old buckets are emptied in
+// index order, and each one from front to back, so events with the same
+// time (which all come from the same old bucket) keep their FIFO order.
+//
+// "new_count" - number of buckets for the new calendar.  Must be a power
+//       of two.
+void CalendarQueue::Resize(size_t new_count) {
+  const SimTime::SimTick new_width = EstimateWidth();
+  std::vector<Bucket> old_buckets(new_count);
+  old_buckets.swap(buckets_);
+  bucket_mask_ = new_count - 1;
+  bucket_width_ = new_width;
+
+  SimTime::SimTick min_ticks = kMaxTicks;
+  for (Bucket &old_bucket : old_buckets) {
+    while (!old_bucket.empty()) {
+      SimBaseEvent *event = old_bucket.PopFront();
+      min_ticks = std::min(min_ticks, EventTicks(event));
+      Insert(event);
+    }
+  }
+
+  // Brown's thresholds, which leave some hysteresis between growing and
+  // shrinking.
+  grow_threshold_ = 2 * new_count;
+  shrink_threshold_ = (new_count > 4) ? (new_count / 2 - 2) : 0;
+  SetCursor((size_ > 0) ? min_ticks : cursor_top_ - 1);
+  min_bucket_ = kNoBucket;
+}
+
+
+// Brown's estimate: average the separation between the earliest events,
+// recompute the average without the separations that are more than twice
+// the first average, then use three times the result.
+//
+// Returns - the new day width in ticks, at least one.
+SimTime::SimTick CalendarQueue::EstimateWidth() const {
+  if (size_ < 2) {
+    return bucket_width_;
+  }
+  std::vector<SimTime::SimTick> ticks;
+  ticks.reserve(size_);
+  for (const Bucket &bucket : buckets_) {
+    for (const SimBaseEvent *event = bucket.front(); event != nullptr;
+         event = EventChain::Next(event)) {
+      ticks.push_back(EventTicks(event));
+    }
+  }
+  const size_t sample_size = std::min(size_, kWidthSampleSize);
+  std::partial_sort(ticks.begin(), ticks.begin() + sample_size, ticks.end());
+
+  const long double average =
+      static_cast<long double>(ticks[sample_size - 1] - ticks[0]) /
+      (sample_size - 1);
+  long double total = 0.0L;
+  size_t count = 0;
+  for (size_t i = 1; i < sample_size; ++i) {
+    const SimTime::SimTick separation = ticks[i] - ticks[i - 1];
+    if (separation <= 2.0L * average) {
+      total += separation;
+      ++count;
+    }
+  }
+  if ((count == 0) || (total <= 0.0L)) {
+    // All of the sampled events share a time, so there is nothing to go
+    // on.  Keep the current width.
+    return bucket_width_;
+  }
+  const long double width = 3.0L * total / count;
+  if (width >= static_cast<long double>(kMaxTicks)) {
+    return kMaxTicks;
+  }
+  return std::max(static_cast<SimTime::SimTick>(width),
+                  static_cast<SimTime::SimTick>(1));
+}
@@ -0,0 +1,132 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the calendar queue pending event set for the
+*     Discrete Event Simulation system.
+*     CalendarQueue follows R. Brown's calendar queue (CACM, 1988).  Time is
+*     divided into "days" of a fixed width, in SimTicks, and a "year" of
+*     days is mapped onto a circular array of buckets.  Each bucket holds
+*     its events in time order, so with a well chosen day width, both
+*     insertion and removal of the earliest event are amortized O(1).
+*
+*     The queue resizes itself as it grows and shrinks.  On each resize the
+*     bucket count is doubled or halved, and the day width is re-estimated
+*     from the spacing of the earliest events in the queue.
+*
+*     Events with the same time always share a bucket, and are kept in the
+*     order in which they were pushed (FIFO).
+*
+*     Each bucket is an EventChain, linked through the events themselves,
+*     so neither pushing, popping nor resizing allocates anything per
+*     event, and removing a given event is O(1).
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_CALENDAR_QUEUE_HPP_
+#define SIM_DESIM_CALENDAR_QUEUE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "event_chain.hpp"
+#include "pending_event_set.hpp"
+
+
+class CalendarQueue : public PendingEventSet {
+ public:
+  CalendarQueue();
+  virtual ~CalendarQueue();
+
+  // PendingEventSet interface.  See pending_event_set.hpp for details.
+  virtual void Push(SimBaseEvent *new_event);
+  virtual SimBaseEvent *PopMin();
+  virtual SimBaseEvent *PeekMin();
+  virtual bool Remove(SimBaseEvent *event);
+  virtual size_t Size() const { return size_; }
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const;
+  virtual void Clear();
+  virtual void Discard();
+
+#ifdef TEST_HARNESS
+  // Test accessors for the current calendar geometry
+  //
+  // Returns - the number of buckets / the width of each bucket in ticks
+  size_t bucket_count() const { return buckets_.size(); }
+  SimTime::SimTick bucket_width() const { return bucket_width_; }
+#endif
+
+ private:
+  // Each bucket holds the events for one "day" of each "year", in time
+  // order.
+  typedef EventChain Bucket;
+
+  // Returns - the index of the bucket that holds events at "ticks"
+  size_t BucketIndex(SimTime::SimTick ticks) const {
+    return static_cast<size_t>(ticks / bucket_width_) & bucket_mask_;
+  }
+
+  // Points the search cursor at the day that contains "ticks".
+  void SetCursor(SimTime::SimTick ticks);
+
+  // Locates the bucket holding the earliest event, advancing the search
+  // cursor to it.
+  //
+  // Returns - the index of the bucket at the front of which is the
+  //       earliest event.  The queue must not be empty.
+  size_t FindMinBucket();
+
+  // Inserts "new_event" into its bucket after all events with the same,
+  // or earlier, times.  The event must not be in any bucket.
+  void Insert(SimBaseEvent *new_event);
+
+  // Rebuilds the calendar with "new_count" buckets, and a day width
+  // estimated from the current contents.
+  void Resize(size_t new_count);
+
+  // Estimates a good day width from the spacing of the earliest events in
+  // the queue.
+  //
+  // Returns - the new day width in ticks, at least one.
+  SimTime::SimTick EstimateWidth() const;
+
+  // The circular array of buckets.  The count is always a power of two,
+  // so the bucket index can be computed with a mask.
+  std::vector<Bucket> buckets_;
+  // "buckets_.size() - 1"
+  size_t bucket_mask_;
+  // Width of each day in ticks
+  SimTime::SimTick bucket_width_;
+  // Number of events in the queue
+  size_t size_;
+
+  // The search cursor: the bucket where the search for the earliest event
+  // starts, and the (exclusive) upper tick bound of the current day in
+  // that bucket.  No event in the queue is earlier than the start of that
+  // day.
+  size_t cursor_bucket_;
+  SimTime::SimTick cursor_top_;
+
+  // Bucket found by the most recent FindMinBucket(), or "kNoBucket" if a
+  // push or pop has invalidated it.
+  size_t min_bucket_;
+
+  // Queue sizes that trigger a resize
+  size_t grow_threshold_;
+  size_t shrink_threshold_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(CalendarQueue);
+}; // class CalendarQueue
+
+#endif   // SIM_DESIM_CALENDAR_QUEUE_HPP_
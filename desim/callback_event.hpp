@@ -0,0 +1,120 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the callback event for the Discrete Event
+*     Simulation system.
+*     A CallbackEvent runs an arbitrary callable (a lambda, a function
+*     pointer, a functor) when it is dispatched, so a model can schedule a
+*     follow-up action without writing a SimBaseEvent subclass for it.  See
+*     SimExec::ScheduleCallback().
+*
+*     Callables of up to "kInlineSize" bytes are stored inside the event
+*     itself, so scheduling one costs no more than the event, which comes
+*     from the EventPool (or the current EventArena) like any other.
+*     Larger callables spill to the heap, as std::function would.
+*
+*     The event always has the same size, whatever it holds, and it is a
+*     single type, so it can be listed in an EventRegistry.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_CALLBACK_EVENT_HPP_
+#define SIM_DESIM_CALLBACK_EVENT_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+
+
+class CallbackEvent final : public SimBaseEvent {
+ public:
+  // Type id for EventRegistry
+  static const uint16_t kEventTypeId = kFirstLibraryEventType;
+  // Largest callable stored inside the event
+  static const size_t kInlineSize = 48;
+
+  // "event_time" - time at which the event is scheduled
+  // "callable" - called with no arguments when the event is dispatched.
+  //       It is moved, or copied, into the event, and destroyed with it.
+  template <typename Callable>
+  CallbackEvent(const SimTime &event_time, Callable &&callable)
+      : SimBaseEvent(event_time, kEventTypeId) {
+    typedef typename std::decay<Callable>::type Stored;
+    Store<Stored>(std::forward<Callable>(callable),
+                  std::integral_constant<bool,
+                      (sizeof(Stored) <= kInlineSize) &&
+                      (alignof(Stored) <= alignof(std::max_align_t))>());
+  }
+  // Destroys the callable, whether or not it was ever called.
+  virtual ~CallbackEvent() { destroy_(storage_); }
+
+  // Calls the callable
+  virtual void Dispatch() const { invoke_(storage_); }
+
+  // Returns - "true" if the callable is stored inside the event, "false"
+  //       if it spilled to the heap
+  bool stored_inline() const { return stored_inline_; }
+
+ private:
+  // Moves "callable" into the event.
+  template <typename Stored, typename Callable>
+  void Store(Callable &&callable, std::true_type) {
+    new (storage_) Stored(std::forward<Callable>(callable));
+    invoke_ = &InvokeInline<Stored>;
+    destroy_ = &DestroyInline<Stored>;
+    stored_inline_ = true;
+  }
+  // Moves "callable" to the heap, and keeps a pointer to it in the event.
+  template <typename Stored, typename Callable>
+  void Store(Callable &&callable, std::false_type) {
+    new (storage_) Stored *(new Stored(std::forward<Callable>(callable)));
+    invoke_ = &InvokeSpilled<Stored>;
+    destroy_ = &DestroySpilled<Stored>;
+    stored_inline_ = false;
+  }
+
+  // Call and destroy a callable of type "Stored", held in "storage"
+  template <typename Stored>
+  static void InvokeInline(void *storage) {
+    (*static_cast<Stored *>(storage))();
+  }
+  template <typename Stored>
+  static void DestroyInline(void *storage) {
+    static_cast<Stored *>(storage)->~Stored();
+  }
+  template <typename Stored>
+  static void InvokeSpilled(void *storage) {
+    (**static_cast<Stored **>(storage))();
+  }
+  template <typename Stored>
+  static void DestroySpilled(void *storage) {
+    delete *static_cast<Stored **>(storage);
+  }
+
+  // The callable, or a pointer to it if it spilled.  Mutable, since
+  // Dispatch() is const but the callable needn't be.
+  alignas(std::max_align_t) mutable unsigned char storage_[kInlineSize];
+  // Functions that know the type of the callable in "storage_"
+  void (*invoke_)(void *storage);
+  void (*destroy_)(void *storage);
+  bool stored_inline_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(CallbackEvent);
+}; // class CallbackEvent
+
+#endif   // SIM_DESIM_CALLBACK_EVENT_HPP_
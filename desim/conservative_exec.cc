@@ -0,0 +1,122 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the conservative parallel executive for the Discrete Event
+*     Simulation system.  See conservative_exec.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <sstream>
+#include <thread>
+
+#include "conservative_exec.hpp"
+#include "common_messages.hpp"
+#include "pending_event_set.hpp"
+
+
+// "lp_count" - number of LPs, at least one
+// "event_set_name" - name of the pending event set for each LP
+ConservativeExec::ConservativeExec(uint32_t lp_count,
+                                   const std::string &event_set_name)
+    : null_messages_(0) {
+  if (lp_count == 0) {
+    UtilFatalErrorAndDie("ConservativeExec needs at least one LP.");
+  }
+  for (uint32_t id = 0; id < lp_count; ++id) {
+    PendingEventSet *event_set = PendingEventSet::NewEventSet(event_set_name);
+    if (event_set == nullptr) {
+      UtilFatalErrorAndDie("Unknown pending event set: \"" + event_set_name +
+                           "\".\nKnown sets: " +
+                           PendingEventSet::KnownNames());
+    }
+    lps_.push_back(new LogicalProcess(id, lp_count, event_set));
+  }
+}
+
+
+ConservativeExec::~ConservativeExec() {
+  for (LogicalProcess *lp : lps_) {
+    delete lp;
+  }
+}
+
+
+// "from" / "to" - indices of the sending and receiving LPs
+// "lookahead" - least delay for events sent over the link
+void ConservativeExec::AddLink(uint32_t from, uint32_t to,
+                               SimTime::UserTime lookahead) {
+  const SimTick lookahead_ticks = SimTime(lookahead).ticks();
+  if ((from >= lps_.size()) || (to >= lps_.size()) || (from == to) ||
+      (lookahead_ticks == 0)) {
+    std::stringstream message;
+    message << "Invalid link from LP " << from << " to LP " << to
+            << " with lookahead " << lookahead << ".\nBoth LPs must exist, "
+               "be different, and the lookahead must be positive.";
+    UtilFatalErrorAndDie(message.str());
+  }
+  lps_[from]->AddOutLink(lps_[to], lookahead_ticks);
+}
+
+
+// One thread per LP.  With a single LP there is nothing to synchronize,
+// so it runs on the calling thread.
+//
+// "run_until_tm" - time at which the run ends
+// Returns - the time when the simulation ended
+SimTime ConservativeExec::Run(const SimTime &run_until_tm) {
+  const SimTick end = run_until_tm.ticks();
+  if (lps_.size() == 1) {
+    RunLp(lps_[0], end);
+  } else {
+    std::vector<std::thread> threads;
+    for (LogicalProcess *lp : lps_) {
+      threads.push_back(std::thread(&ConservativeExec::RunLp, this, lp, end));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+  SimTime last_time(0.0);
+  for (LogicalProcess *lp : lps_) {
+    if (last_time.EarlierThan(lp->curr_time())) {
+      last_time = lp->curr_time();
+    }
+  }
+  return last_time.AsEarlyAs(run_until_tm) ? last_time : run_until_tm;
+}
+
+
+// Each pass drains the inbox, dispatches what is safe, and then, if the
+// LP isn't done, promises its receivers as much as it can and waits for
+// its senders to do the same.  Once every sender has promised nothing up
+// to the end of the run, the LP is done, and promises that it won't send
+// anything more, which lets its receivers finish too.
+//
+// "lp" - the LP to run
+// "end" - time at which the run ends, in ticks
+void ConservativeExec::RunLp(LogicalProcess *lp, SimTick end) {
+  LogicalProcess::current_ = lp;
+  uint64_t null_messages = 0;
+  for (;;) {
+    uint64_t version;
+    const SimTick safe = lp->DrainInbox(&version);
+    lp->DispatchUntil(safe, end);
+    if (safe > end) {
+      break;
+    }
+    const SimTick next = lp->NextEventTicks();
+    null_messages += lp->PromiseAll((next < safe) ? next : safe);
+    lp->WaitForInbox(version);
+  }
+  lp->PromiseAll(LogicalProcess::kNever);
+  LogicalProcess::current_ = nullptr;
+  null_messages_ += null_messages;
+}
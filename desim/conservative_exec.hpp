@@ -0,0 +1,101 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the conservative parallel executive for the
+*     Discrete Event Simulation system.
+*     ConservativeExec runs a model partitioned into logical processes (see
+*     LogicalProcess), each on its own thread.  The LPs are kept in step
+*     with Chandy-Misra-Bryant null messages: an LP only dispatches events
+*     earlier than the least promise on its incoming links, and, whenever
+*     it has to wait, it promises its receivers that it won't send anything
+*     earlier than its own next event time (or its safe time, if that is
+*     earlier) plus the lookahead of the link.  Since every lookahead is
+*     positive, the promises keep growing and the run cannot deadlock.
+*
+*     Every event is dispatched in time order on its own LP, so the model
+*     reaches the same results as in a sequential run, with one caveat:
+*     events at exactly the same time on one LP, that arrived from
+*     different LPs, may be dispatched in either order.  Models whose
+*     results depend on that order should break ties themselves.
+*
+*     With one LP, the model runs on the calling thread, exactly as it
+*     would with SimExec.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_CONSERVATIVE_EXEC_HPP_
+#define SIM_DESIM_CONSERVATIVE_EXEC_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "logical_process.hpp"
+
+
+class ConservativeExec {
+ public:
+  // Creates the LPs, each with its own pending event set.  A fatal error
+  // is generated if "event_set_name" is not recognized.
+  //
+  // "lp_count" - number of LPs, at least one
+  // "event_set_name" - name of the pending event set for each LP, as
+  //       known to PendingEventSet::NewEventSet()
+  explicit ConservativeExec(uint32_t lp_count,
+                            const std::string &event_set_name = "HEAP");
+  // Deletes the LPs, and any events they still hold.
+  ~ConservativeExec();
+
+  // Declares that LP "from" may send events to LP "to".  A fatal error is
+  // generated if either LP doesn't exist, or the lookahead isn't positive.
+  //
+  // "from" / "to" - indices of the sending and receiving LPs
+  // "lookahead" - least delay between the sender's current time and the
+  //       time of any event it sends over the link
+  void AddLink(uint32_t from, uint32_t to, SimTime::UserTime lookahead);
+
+  // Returns - the LP with index "id", for scheduling the initial events
+  LogicalProcess *lp(uint32_t id) { return lps_[id]; }
+  // Returns - the number of LPs
+  uint32_t lp_count() const { return static_cast<uint32_t>(lps_.size()); }
+
+  // Runs every LP on its own thread until all of them are done.  As with
+  // SimExec, events later than "run_until_tm" are not dispatched.
+  //
+  // "run_until_tm" - time at which the run ends
+  // Returns - the time when the simulation ended: the time of the last
+  //       event dispatched, or "run_until_tm", whichever is earlier.
+  SimTime Run(const SimTime &run_until_tm);
+
+  // Returns - the number of null messages, i.e. promises not carried by
+  //       an event, that let a receiver advance
+  uint64_t null_message_count() const { return null_messages_; }
+
+ private:
+  typedef LogicalProcess::SimTick SimTick;
+
+  // The null message loop for one LP, on its own thread.
+  //
+  // "lp" - the LP to run
+  // "end" - time at which the run ends, in ticks
+  void RunLp(LogicalProcess *lp, SimTick end);
+
+  std::vector<LogicalProcess *> lps_;
+  std::atomic<uint64_t> null_messages_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(ConservativeExec);
+}; // class ConservativeExec
+
+#endif   // SIM_DESIM_CONSERVATIVE_EXEC_HPP_
@@ -0,0 +1,145 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the work-stealing thread pool for the Discrete Event
+*     Simulation system.  See dispatch_pool.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include "dispatch_pool.hpp"
+#include "common_messages.hpp"
+
+
+// "thread_count" - number of threads that run tasks, at least two
+DispatchPool::DispatchPool(unsigned thread_count)
+    : task_(nullptr), remaining_(0), generation_(0), stopping_(false),
+      steals_(0) {
+  if (thread_count < 2) {
+    UtilFatalErrorAndDie("DispatchPool needs at least two threads.");
+  }
+  for (unsigned queue = 0; queue < thread_count; ++queue) {
+    queues_.push_back(new TaskQueue);
+  }
+  for (unsigned worker = 0; worker + 1 < thread_count; ++worker) {
+    threads_.push_back(std::thread(&DispatchPool::WorkerLoop, this, worker));
+  }
+}
+
+
+DispatchPool::~DispatchPool() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+  for (TaskQueue *queue : queues_) {
+    delete queue;
+  }
+}
+
+
+// Each thread is dealt a contiguous block, so that neighbouring tasks,
+// which often touch neighbouring data, tend to run on the same thread.
+//
+// "task_count" - number of tasks
+// "task" - called with the number of each task
+void DispatchPool::RunTasks(size_t task_count,
+                            const std::function<void(size_t)> &task) {
+  if (task_count == 0) {
+    return;
+  }
+  // Both are set before any task can be taken, since taking one goes
+  // through the same mutex as dealing it.
+  task_ = &task;
+  remaining_.store(task_count);
+  const size_t queue_count = queues_.size();
+  size_t next_task = 0;
+  for (size_t queue = 0; queue < queue_count; ++queue) {
+    const size_t block_end = (task_count * (queue + 1)) / queue_count;
+    std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+    for (; next_task < block_end; ++next_task) {
+      queues_[queue]->tasks.push_back(next_task);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    ++generation_;
+  }
+  wake_.notify_all();
+  RunAvailableTasks(static_cast<unsigned>(queue_count - 1));
+  // The last tasks may still be running on other threads
+  while (remaining_.load() != 0) {
+    std::this_thread::yield();
+  }
+}
+
+
+// "worker" - index of the thread's own TaskQueue
+void DispatchPool::WorkerLoop(unsigned worker) {
+  uint64_t seen_generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_.wait(lock, [this, seen_generation] {
+        return stopping_ || (generation_ != seen_generation);
+      });
+      if (stopping_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+    RunAvailableTasks(worker);
+  }
+}
+
+
+// "worker" - index of the calling thread's own TaskQueue
+void DispatchPool::RunAvailableTasks(unsigned worker) {
+  size_t task;
+  while (TakeTask(worker, &task)) {
+    (*task_)(task);
+    remaining_.fetch_sub(1);
+  }
+}
+
+
+// Thieves take from the back, so that they take the tasks the owner would
+// reach last.
+//
+// "worker" - index of the calling thread's own TaskQueue
+// "task" - receives the number of the task
+// Returns - "false" if every queue was empty
+bool DispatchPool::TakeTask(unsigned worker, size_t *task) {
+  {
+    TaskQueue *own = queues_[worker];
+    std::lock_guard<std::mutex> lock(own->mutex);
+    if (!own->tasks.empty()) {
+      *task = own->tasks.front();
+      own->tasks.pop_front();
+      return true;
+    }
+  }
+  const size_t queue_count = queues_.size();
+  for (size_t offset = 1; offset < queue_count; ++offset) {
+    TaskQueue *victim = queues_[(worker + offset) % queue_count];
+    std::lock_guard<std::mutex> lock(victim->mutex);
+    if (!victim->tasks.empty()) {
+      *task = victim->tasks.back();
+      victim->tasks.pop_back();
+      ++steals_;
+      return true;
+    }
+  }
+  return false;
+}
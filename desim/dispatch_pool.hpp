@@ -0,0 +1,114 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the work-stealing thread pool that the
+*     simulation executive uses to dispatch independent events at the same
+*     time in parallel, in the Discrete Event Simulation system.
+*     A DispatchPool runs a numbered set of tasks on its threads, and on
+*     the calling thread, and returns once every task is done.  The tasks
+*     are dealt out in contiguous blocks, one block per thread.  Each
+*     thread works through its own block from the front, and, once it runs
+*     out, steals from the back of the others' blocks, so a few long tasks
+*     don't leave the rest of the threads idle.
+*
+*     Between calls, the pool's threads sleep.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_DISPATCH_POOL_HPP_
+#define SIM_DESIM_DISPATCH_POOL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "basic_defs.hpp"
+
+
+class DispatchPool {
+ public:
+  // Starts "thread_count" - 1 threads.  The thread that calls RunTasks()
+  // is the last one.
+  //
+  // "thread_count" - number of threads that run tasks, at least two
+  explicit DispatchPool(unsigned thread_count);
+  // Stops, and joins, the pool's threads.
+  ~DispatchPool();
+
+  // Returns - number of threads that run tasks, including the caller's
+  unsigned thread_count() const {
+    return static_cast<unsigned>(queues_.size());
+  }
+
+  // Runs "task" once for each number from 0 to "task_count" - 1, on the
+  // pool's threads and the calling thread, in no particular order.
+  // Returns once every task is done.  Only one thread may call this at a
+  // time.
+  //
+  // "task_count" - number of tasks
+  // "task" - called with the number of each task
+  void RunTasks(size_t task_count, const std::function<void(size_t)> &task);
+
+  // Returns - tasks that a thread took from another's block, for tuning
+  uint64_t steal_count() const { return steals_; }
+
+ private:
+  // The tasks dealt to one thread, guarded by "mutex"
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  // Loop of each of the pool's threads.
+  //
+  // "worker" - index of the thread's own TaskQueue
+  void WorkerLoop(unsigned worker);
+
+  // Runs tasks until none are left to take.
+  //
+  // "worker" - index of the calling thread's own TaskQueue
+  void RunAvailableTasks(unsigned worker);
+
+  // Takes a task, from the front of the thread's own queue, or, failing
+  // that, from the back of another's.
+  //
+  // "worker" - index of the calling thread's own TaskQueue
+  // "task" - receives the number of the task
+  // Returns - "false" if every queue was empty
+  bool TakeTask(unsigned worker, size_t *task);
+
+  // One queue per thread.  The calling thread's is the last.
+  std::vector<TaskQueue *> queues_;
+  std::vector<std::thread> threads_;
+
+  // The current call's task, and the number of its tasks not yet done
+  const std::function<void(size_t)> *task_;
+  std::atomic<size_t> remaining_;
+
+  // Wakes the pool's threads for each call, and to stop them
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  uint64_t generation_;
+  bool stopping_;
+
+  std::atomic<uint64_t> steals_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(DispatchPool);
+}; // class DispatchPool
+
+#endif   // SIM_DESIM_DISPATCH_POOL_HPP_
@@ -0,0 +1,80 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the run-scoped memory arena for simulation events in the
+*     Discrete Event Simulation system.  See event_arena.hpp for an
+*     overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <new>
+
+#include "event_arena.hpp"
+
+const size_t EventArena::kDefaultChunkSize;
+const size_t EventArena::kAlignment;
+
+thread_local EventArena *EventArena::current_ = nullptr;
+
+
+// No chunk is allocated until the first allocation.
+//
+// "teardown" - how the executive disposes of queued events at teardown
+// "chunk_size" - size of the first chunk in bytes
+EventArena::EventArena(TeardownMode teardown, size_t chunk_size)
+    : teardown_(teardown),
+      next_chunk_size_((chunk_size < kAlignment) ? kAlignment : chunk_size),
+      chunk_start_(nullptr), next_(nullptr), chunk_end_(nullptr),
+      bytes_used_(0) {
+}
+
+
+// One free per chunk, whatever was allocated from them.
+EventArena::~EventArena() {
+  for (Chunk &chunk : chunks_) {
+    ::operator delete(chunk.start);
+  }
+}
+
+
+// "memory" - the memory to check
+// Returns - "true" if "memory" is inside one of the arena's chunks
+bool EventArena::Contains(const void *memory) const {
+  const char *address = static_cast<const char *>(memory);
+  for (size_t i = chunks_.size(); i > 0; --i) {
+    const Chunk &chunk = chunks_[i - 1];
+    if ((address >= chunk.start) && (address < chunk.start + chunk.size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Chunks double in size, so the number of chunks grows with the log of
+// the memory used.  The rest of the old chunk is abandoned.
+// "::operator new" returns memory aligned for any type, which covers
+// "kAlignment".
+//
+// "size" - number of bytes needed, already rounded to "kAlignment"
+void EventArena::NewChunk(size_t size) {
+  while (next_chunk_size_ < size) {
+    next_chunk_size_ *= 2;
+  }
+  Chunk chunk = {static_cast<char *>(::operator new(next_chunk_size_)),
+                 next_chunk_size_};
+  chunks_.push_back(chunk);
+  bytes_used_ += next_ - chunk_start_;
+  chunk_start_ = chunk.start;
+  next_ = chunk.start;
+  chunk_end_ = chunk.start + chunk.size;
+  next_chunk_size_ *= 2;
+}
@@ -0,0 +1,128 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the run-scoped memory arena for simulation
+*     events in the Discrete Event Simulation system.
+*     An EventArena is a monotonic buffer: memory is handed out from the
+*     front of a large chunk, and is never given back one allocation at a
+*     time.  When a chunk is used up, a new one, twice the size, is
+*     started.  The whole arena is released at once, in O(chunks), when it
+*     is deleted.
+*
+*     While an arena is current, every event created with "new" (see
+*     SimBaseEvent) comes from it, and deleting such an event runs its
+*     destructor but keeps the memory.  Passing an arena to SimExec::Init()
+*     makes it current for the whole run.  Event types may also place
+*     payload data in the current arena with Allocate().
+*
+*     An arena created with "kDiscardEvents" also lets the executive skip
+*     the destructors of the events still queued at teardown: the pending
+*     event set simply forgets them, and their memory goes with the chunks.
+*     That is only correct if those events own nothing outside the arena,
+*     so it is for event types whose destructors have nothing to do.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_ARENA_HPP_
+#define SIM_DESIM_EVENT_ARENA_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+
+
+class EventArena {
+ public:
+  // What happens to the events still queued when the run is torn down.
+  // "kDestroyEvents" - each one is deleted, so its destructor runs
+  // "kDiscardEvents" - none of them is touched
+  enum TeardownMode { kDestroyEvents, kDiscardEvents };
+
+  // Size of the first chunk, unless the caller asks for another
+  static const size_t kDefaultChunkSize = 1 << 20;
+  // Alignment of every allocation, suitable for any event
+  static const size_t kAlignment = 16;
+
+  // "teardown" - how the executive disposes of queued events at teardown
+  // "chunk_size" - size of the first chunk in bytes.  Later chunks double.
+  explicit EventArena(TeardownMode teardown = kDestroyEvents,
+                      size_t chunk_size = kDefaultChunkSize);
+  // Releases every chunk.  Must not be current when deleted.
+  ~EventArena();
+
+  // Allocates memory from the front of the current chunk.
+  //
+  // "size" - number of bytes needed
+  // Returns - the memory, aligned to "kAlignment".  Throws std::bad_alloc
+  //       if the heap is exhausted.
+  void *Allocate(size_t size) {
+    const size_t rounded = (size + kAlignment - 1) & ~(kAlignment - 1);
+    if (rounded > static_cast<size_t>(chunk_end_ - next_)) {
+      NewChunk(rounded);
+    }
+    void *memory = next_;
+    next_ += rounded;
+    return memory;
+  }
+
+  // Checks whether memory came from this arena.  The newest chunk, which
+  // holds most live events, is checked first.
+  //
+  // "memory" - the memory to check
+  // Returns - "true" if "memory" is inside one of the arena's chunks
+  bool Contains(const void *memory) const;
+
+  // Returns - how the executive should dispose of queued events
+  TeardownMode teardown() const { return teardown_; }
+  // Returns - the number of chunks allocated so far
+  size_t chunk_count() const { return chunks_.size(); }
+  // Returns - the number of bytes handed out so far, including padding
+  size_t bytes_used() const { return bytes_used_ + (next_ - chunk_start_); }
+
+  // The arena that events are allocated from on the calling thread.
+  //
+  // Returns - the current arena, or nullptr if events come from the
+  //       EventPool
+  static EventArena *current() { return current_; }
+  // "arena" - the arena to make current, or nullptr for none
+  static void set_current(EventArena *arena) { current_ = arena; }
+
+ private:
+  // One chunk, as allocated from the heap
+  struct Chunk {
+    char *start;
+    size_t size;
+  };
+
+  // Starts a new chunk big enough for "size" bytes.
+  void NewChunk(size_t size);
+
+  TeardownMode teardown_;
+  // Size of the next chunk to allocate
+  size_t next_chunk_size_;
+  // Every chunk, oldest first
+  std::vector<Chunk> chunks_;
+  // The unused part of the newest chunk is ["next_", "chunk_end_")
+  char *chunk_start_;
+  char *next_;
+  char *chunk_end_;
+  // Bytes handed out from the chunks before the newest
+  size_t bytes_used_;
+
+  // The calling thread's current arena
+  static thread_local EventArena *current_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(EventArena);
+}; // class EventArena
+
+#endif   // SIM_DESIM_EVENT_ARENA_HPP_
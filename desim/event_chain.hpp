@@ -0,0 +1,148 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the intrusive event list used by the pending
+*     event sets of the Discrete Event Simulation system.
+*     An EventChain links events together through pointers carried in
+*     SimBaseEvent itself, rather than through list nodes allocated for
+*     each event, as std::list would.  Placing an event in a chain, or
+*     taking it out, never allocates, and removing an event from the middle
+*     of a chain is O(1).
+*
+*     The chain doesn't own its events.  An event may only be in one chain
+*     at a time, which is always the case for events in a pending event
+*     set.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_CHAIN_HPP_
+#define SIM_DESIM_EVENT_CHAIN_HPP_
+
+#include <cstddef>
+
+#include "basic_defs.hpp"
+#include "sim_base_event.hpp"
+
+
+class EventChain {
+ public:
+  EventChain() : head_(nullptr), tail_(nullptr), size_(0) {};
+  ~EventChain() {};
+
+  // Returns - "true" if the chain has no events
+  bool empty() const { return head_ == nullptr; }
+  // Returns - the number of events in the chain
+  size_t size() const { return size_; }
+  // Returns - the first / last event in the chain, or nullptr if the chain
+  //       is empty
+  SimBaseEvent *front() const { return head_; }
+  SimBaseEvent *back() const { return tail_; }
+
+  // Used to walk a chain in either direction.
+  //
+  // "event" - an event in a chain
+  // Returns - the event after / before "event", or nullptr if there is
+  //       none
+  static SimBaseEvent *Next(const SimBaseEvent *event) {
+    return event->next_link_;
+  }
+  static SimBaseEvent *Prev(const SimBaseEvent *event) {
+    return event->prev_link_;
+  }
+
+  // Adds an event to the end of the chain.
+  //
+  // "event" - the event to add.  Must not be in any chain.
+  void PushBack(SimBaseEvent *event) { InsertBefore(nullptr, event); }
+
+  // Adds an event to the chain ahead of another one.
+  //
+  // "position" - the event to insert in front of, or nullptr to add
+  //       "event" to the end of the chain
+  // "event" - the event to add.  Must not be in any chain.
+  void InsertBefore(SimBaseEvent *position, SimBaseEvent *event) {
+    SimBaseEvent *before = (position == nullptr) ? tail_ :
+                                                   position->prev_link_;
+    event->prev_link_ = before;
+    event->next_link_ = position;
+    if (before == nullptr) {
+      head_ = event;
+    } else {
+      before->next_link_ = event;
+    }
+    if (position == nullptr) {
+      tail_ = event;
+    } else {
+      position->prev_link_ = event;
+    }
+    ++size_;
+  }
+
+  // Takes an event out of the chain, and clears its links.
+  //
+  // "event" - the event to remove.  Must be in this chain.
+  void Erase(SimBaseEvent *event) {
+    if (event->prev_link_ == nullptr) {
+      head_ = event->next_link_;
+    } else {
+      event->prev_link_->next_link_ = event->next_link_;
+    }
+    if (event->next_link_ == nullptr) {
+      tail_ = event->prev_link_;
+    } else {
+      event->next_link_->prev_link_ = event->prev_link_;
+    }
+    event->prev_link_ = nullptr;
+    event->next_link_ = nullptr;
+    --size_;
+  }
+
+  // Removes the first event.  The chain must not be empty.
+  //
+  // Returns - the event that was first in the chain
+  SimBaseEvent *PopFront() {
+    SimBaseEvent *event = head_;
+    Erase(event);
+    return event;
+  }
+
+  // Checks for an event in O(1).  Relies on events that aren't in a chain
+  // having clear links, which Erase() guarantees, and on the event not
+  // being in some other chain.
+  //
+  // "event" - the event to look for
+  // Returns - "true" if "event" is in this chain
+  bool Contains(const SimBaseEvent *event) const {
+    return (event->prev_link_ == nullptr) ? (head_ == event) :
+                                            (event->prev_link_->next_link_ ==
+                                             event);
+  }
+
+  // Forgets every event in the chain, without touching the events.  Used
+  // once the events have been deleted.
+  void Reset() {
+    head_ = nullptr;
+    tail_ = nullptr;
+    size_ = 0;
+  }
+
+ private:
+  // First and last events in the chain
+  SimBaseEvent *head_;
+  SimBaseEvent *tail_;
+  // Number of events in the chain
+  size_t size_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(EventChain);
+}; // class EventChain
+
+#endif   // SIM_DESIM_EVENT_CHAIN_HPP_
@@ -0,0 +1,200 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the pending event heap for the Discrete Event Simulation
+*     system.  See event_heap.hpp for a description of the ordering
+*     guarantees.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "event_heap.hpp"
+
+const unsigned int EventHeap::kDefaultArity;
+
+// "arity" - number of children for each node in the heap.  Anything less
+//       than a binary heap doesn't make sense, so small values are raised
+//       to 2.
+EventHeap::EventHeap(unsigned int arity)
+    : arity_((arity < 2) ? 2 : arity), next_sequence_(0) {
+}
+
+
+// The heap doesn't own the events, so there is nothing to clean up
+// beyond the storage for the nodes.
+EventHeap::~EventHeap() {
+}
+
+
+// Appends the new event as a leaf, then sifts it up to its proper place.
+//
+// "new_event" - the event to place in the heap
+void EventHeap::Push(SimBaseEvent *new_event) {
+  HeapNode node = {new_event->event_time(), next_sequence_++, new_event};
+  heap_.push_back(node);
+  SiftUp(heap_.size() - 1);
+}
+
+
+// The new nodes are appended as leaves.  Sifting each one up costs
+// O(k log n), while rebuilding the whole heap from the bottom up (Floyd's
+// method) costs O(n + k), so the heap is rebuilt when the batch is larger
+// than the heap it is joining.  The sequence numbers keep the batch in
+// FIFO order either way.
+//
+// "events" - the events to place in the heap
+void EventHeap::PushBatch(const std::vector<SimBaseEvent *> &events) {
+  const size_t old_size = heap_.size();
+  heap_.reserve(old_size + events.size());
+  for (SimBaseEvent *event : events) {
+    HeapNode node = {event->event_time(), next_sequence_++, event};
+    event->heap_index_ = heap_.size();
+    heap_.push_back(node);
+  }
+  if (events.size() > old_size) {
+    if (heap_.size() > 1) {
+      for (size_t index = (heap_.size() - 2) / arity_ + 1; index > 0;
+           --index) {
+        SiftDown(index - 1);
+      }
+    }
+  } else {
+    for (size_t index = old_size; index < heap_.size(); ++index) {
+      SiftUp(index);
+    }
+  }
+}
+
+
+// Removes the root, moves the last leaf to the root, then sifts it down
+// to its proper place.
+//
+// Returns - the earliest event
+SimBaseEvent *EventHeap::PopMin() {
+  SimBaseEvent *min_event = heap_.front().event;
+  heap_.front() = heap_.back();
+  heap_.pop_back();
+  if (!heap_.empty()) {
+    SiftDown(0);
+  }
+  return min_event;
+}
+
+
+// Each event records its position in the heap, so it can be found
+// directly.  The last leaf fills the hole, and is then sifted whichever way
+// restores the heap property.
+//
+// "event" - the event to remove
+// Returns - "true" if the event was in this heap
+bool EventHeap::Remove(SimBaseEvent *event) {
+  const size_t index = event->heap_index_;
+  if ((index >= heap_.size()) || (heap_[index].event != event)) {
+    return false;
+  }
+  heap_[index] = heap_.back();
+  heap_.pop_back();
+  if (index < heap_.size()) {
+    if ((index > 0) &&
+        Before(heap_[index], heap_[(index - 1) / arity_])) {
+      SiftUp(index);
+    } else {
+      SiftDown(index);
+    }
+  }
+  return true;
+}
+
+
+// Copies and sorts the nodes, since the heap itself is only partially
+// ordered.
+//
+// "events" - receives the ordered events.
+void EventHeap::OrderedEvents(std::vector<SimBaseEvent *> *events) const {
+  std::vector<HeapNode> sorted(heap_);
+  std::sort(sorted.begin(), sorted.end(), Before);
+  events->clear();
+  events->reserve(sorted.size());
+  for (const HeapNode &node : sorted) {
+    events->push_back(node.event);
+  }
+}
+
+
+// The nodes are discarded without sifting, since the order no longer
+// matters.
+void EventHeap::Clear() {
+  for (HeapNode &node : heap_) {
+    delete node.event;
+  }
+  heap_.clear();
+}
+
+
+// The nodes are plain data, so clearing them is O(1).
+void EventHeap::Discard() {
+  heap_.clear();
+}
+
+
+// Moves the node at "index" toward the root until its parent is no later
+// than it.  The node being moved is held aside, and parents are shifted
+// down into the hole, which halves the number of writes compared to
+// swapping.
+//
+// "index" - position of the node to move
+void EventHeap::SiftUp(size_t index) {
+  HeapNode moving = heap_[index];
+  while (index > 0) {
+    size_t parent = (index - 1) / arity_;
+    if (!Before(moving, heap_[parent])) {
+      break;
+    }
+    heap_[index] = heap_[parent];
+    heap_[index].event->heap_index_ = index;
+    index = parent;
+  }
+  heap_[index] = moving;
+  moving.event->heap_index_ = index;
+}
+
+
+// Moves the node at "index" toward the leaves until none of its children
+// is earlier than it.
+//
+// "index" - position of the node to move
+void EventHeap::SiftDown(size_t index) {
+  const size_t count = heap_.size();
+  HeapNode moving = heap_[index];
+  while (true) {
+    size_t first_child = arity_ * index + 1;
+    if (first_child >= count) {
+      break;
+    }
+    // Find the earliest of this node's children
+    size_t last_child = std::min(first_child + arity_, count);
+    size_t min_child = first_child;
+    for (size_t child = first_child + 1; child < last_child; ++child) {
+      if (Before(heap_[child], heap_[min_child])) {
+        min_child = child;
+      }
+    }
+    if (!Before(heap_[min_child], moving)) {
+      break;
+    }
+    heap_[index] = heap_[min_child];
+    heap_[index].event->heap_index_ = index;
+    index = min_child;
+  }
+  heap_[index] = moving;
+  moving.event->heap_index_ = index;
+}
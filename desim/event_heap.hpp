@@ -0,0 +1,95 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the pending event heap for the Discrete Event
+*     Simulation system.
+*     EventHeap is a contiguous d-ary (4-ary by default) min-heap of events
+*     keyed on the event time and an insertion sequence number.  The
+*     sequence number makes the ordering stable, so events scheduled for the
+*     same time are removed in the order in which they were inserted (FIFO).
+*     Both insertion and removal of the earliest event are O(log n).  Each
+*     event records its position in the heap, so removing an arbitrary
+*     event, to cancel or reschedule it, is also O(log n).
+*     This is the default PendingEventSet used by the simulation executive.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_HEAP_HPP_
+#define SIM_DESIM_EVENT_HEAP_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+
+
+class EventHeap : public PendingEventSet {
+ public:
+  // Default number of children for each node in the heap.  A 4-ary heap
+  // is shallower than a binary heap, and the children of each node tend
+  // to share a cache line, which makes it a good default.
+  static const unsigned int kDefaultArity = 4;
+
+  // "arity" - number of children for each node in the heap.  Values less
+  //       than 2 are treated as 2.
+  explicit EventHeap(unsigned int arity = kDefaultArity);
+  virtual ~EventHeap();
+
+  // PendingEventSet interface.  See pending_event_set.hpp for details.
+  virtual void Push(SimBaseEvent *new_event);
+  virtual void PushBatch(const std::vector<SimBaseEvent *> &events);
+  virtual SimBaseEvent *PopMin();
+  virtual SimBaseEvent *PeekMin() { return heap_.front().event; }
+  virtual bool Remove(SimBaseEvent *event);
+  virtual size_t Size() const { return heap_.size(); }
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const;
+  virtual void Clear();
+  virtual void Discard();
+
+ private:
+  // Each node in the heap caches the sort key alongside the event pointer,
+  // so sifting never has to dereference the events themselves.
+  struct HeapNode {
+    SimTime time;
+    uint64_t sequence;
+    SimBaseEvent *event;
+  };
+
+  // Strict ordering on (time, sequence)
+  //
+  // Returns - "true" if "left" should be dispatched before "right"
+  static bool Before(const HeapNode &left, const HeapNode &right) {
+    return left.time.EarlierThan(right.time) ||
+           (left.time.SameAs(right.time) && left.sequence < right.sequence);
+  }
+
+  // Restore the heap property by moving the node at "index" toward the
+  // root, or toward the leaves, respectively.
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+
+  // Number of children per node
+  const unsigned int arity_;
+  // Sequence number to be given to the next event pushed onto the heap
+  uint64_t next_sequence_;
+  // The nodes, stored contiguously in level order.  The children of the
+  // node at "i" are at "arity_ * i + 1" through "arity_ * i + arity_"
+  std::vector<HeapNode> heap_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(EventHeap);
+}; // class EventHeap
+
+#endif   // SIM_DESIM_EVENT_HEAP_HPP_
@@ -0,0 +1,139 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring a bounded, lock-free, multiple producer / single
+*     consumer queue of events for the Discrete Event Simulation system.
+*     Any number of threads may push events into an EventInbox at once,
+*     while the one thread that owns it (e.g. the thread running a SimExec)
+*     pops them.  Neither side ever takes a lock, or blocks.
+*
+*     The inbox is a ring of cells, each with a sequence number (Vyukov's
+*     bounded queue).  A producer claims a cell by advancing the shared
+*     push position with a compare and swap, fills it, then publishes it
+*     by bumping the cell's sequence.  The consumer only looks at the cell
+*     at its own pop position, so it needs no atomic read-modify-write at
+*     all.  Since the ring is bounded, a push fails when it is full, and
+*     the producer decides whether to retry, wait, or give up.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_INBOX_HPP_
+#define SIM_DESIM_EVENT_INBOX_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "basic_defs.hpp"
+#include "sim_base_event.hpp"
+
+
+class EventInbox {
+ public:
+  // "capacity" - most events the inbox holds at once.  Rounded up to a
+  //       power of two, of at least two.
+  explicit EventInbox(size_t capacity) : dequeue_pos_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    cells_ = new Cell[size];
+    for (size_t cell = 0; cell < size; ++cell) {
+      cells_[cell].sequence.store(cell, std::memory_order_relaxed);
+      cells_[cell].event = nullptr;
+    }
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+  };
+  // Deletes any events still in the inbox.  No producer may still be
+  // pushing.
+  ~EventInbox() {
+    for (SimBaseEvent *event = Pop(); event != nullptr; event = Pop()) {
+      delete event;
+    }
+    delete [] cells_;
+  };
+
+  // Returns - most events the inbox holds at once
+  size_t capacity() const { return mask_ + 1; };
+
+  // Adds an event to the inbox.  May be called from any thread.
+  //
+  // "event" - the event to add.  If it was added, the inbox takes
+  //       responsibility for it.
+  // Returns - "true" if the event was added, "false" if the inbox was full
+  bool Push(SimBaseEvent *event) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t difference =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (difference == 0) {
+        // The cell is free for this position, try to claim it
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // The cell still holds an event from a lap ago: the ring is full
+        return false;
+      } else {
+        // Another producer claimed this position first
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->event = event;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Takes the oldest published event out of the inbox.  Only the thread
+  // that owns the inbox may call this.
+  //
+  // Returns - the event, or nullptr if there is none.  The caller takes
+  //       responsibility for it.  An event whose producer has claimed a
+  //       cell, but not yet published it, holds back the events behind
+  //       it until the next call.
+  SimBaseEvent *Pop() {
+    Cell *cell = &cells_[dequeue_pos_ & mask_];
+    if (cell->sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+      return nullptr;
+    }
+    SimBaseEvent *event = cell->event;
+    // Hand the cell to the producers of the next lap
+    cell->sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+    ++dequeue_pos_;
+    return event;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    SimBaseEvent *event;
+  };
+
+  Cell *cells_;
+  size_t mask_;
+  // Next position to push, shared by the producers.  Kept apart from the
+  // consumer's position, so that they don't share a cache line.
+  char pad_before_[64];
+  std::atomic<size_t> enqueue_pos_;
+  char pad_after_[64];
+  // Next position to pop, used only by the consumer
+  size_t dequeue_pos_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(EventInbox);
+}; // class EventInbox
+
+#endif   // SIM_DESIM_EVENT_INBOX_HPP_
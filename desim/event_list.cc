@@ -0,0 +1,117 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the linked list pending event set for the Discrete Event
+*     Simulation system.  See event_list.hpp for details.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "event_list.hpp"
+
+
+// The list doesn't own the events, so there is nothing to clean up.
+EventList::~EventList() {
+}
+
+
+// Events are inserted in time order.  If times are identical, the event is
+// inserted after all other events already in the list at the same time.
+// The scan starts at the earliest event and searches forward for the
+// proper insertion point.
+//
+// "new_event" - the event to place in the list
+void EventList::Push(SimBaseEvent *new_event) {
+  // Walk the event queue as long as the time of the events is earlier
+  // than, or equal to, the new event's time.
+  SimBaseEvent *position = event_queue_.front();
+  while ((position != nullptr) && position->AsEarlyAs(*new_event)) {
+    position = EventChain::Next(position);
+  }
+  // By this point, "position" is either the first event with a time later
+  // than the new event, or nullptr at the end of the list.
+  // "InsertBefore()" handles both cases, including the empty list.
+  event_queue_.InsertBefore(position, new_event);
+}
+
+
+// Rather than scanning once per event, the batch is sorted, then merged
+// into the list in a single pass.  The sort is stable, and each batch
+// event goes after the events already in the list at the same time, so
+// FIFO order is kept.
+//
+// "events" - the events to place in the list
+void EventList::PushBatch(const std::vector<SimBaseEvent *> &events) {
+  batch_.assign(events.begin(), events.end());
+  std::stable_sort(batch_.begin(), batch_.end(),
+                   [](const SimBaseEvent *left, const SimBaseEvent *right) {
+                     return left->EarlierThan(*right);
+                   });
+  SimBaseEvent *position = event_queue_.front();
+  for (SimBaseEvent *event : batch_) {
+    while ((position != nullptr) && position->AsEarlyAs(*event)) {
+      position = EventChain::Next(position);
+    }
+    event_queue_.InsertBefore(position, event);
+  }
+  batch_.clear();
+}
+
+
+// Returns - the earliest event, which is always at the front of the list.
+SimBaseEvent *EventList::PopMin() {
+  return event_queue_.PopFront();
+}
+
+
+// The event carries its own links, so it is unlinked directly.
+//
+// "event" - the event to remove
+// Returns - "true" if the event was in the list
+bool EventList::Remove(SimBaseEvent *event) {
+  if (!event_queue_.Contains(event)) {
+    return false;
+  }
+  event_queue_.Erase(event);
+  return true;
+}
+
+
+// The list is already in dispatch order, so this is a simple copy.
+//
+// "events" - receives the ordered events.
+void EventList::OrderedEvents(std::vector<SimBaseEvent *> *events) const {
+  events->clear();
+  events->reserve(event_queue_.size());
+  for (SimBaseEvent *event = event_queue_.front(); event != nullptr;
+       event = EventChain::Next(event)) {
+    events->push_back(event);
+  }
+}
+
+
+// Deletes each event, then empties the list
+void EventList::Clear() {
+  SimBaseEvent *event = event_queue_.front();
+  while (event != nullptr) {
+    SimBaseEvent *next = EventChain::Next(event);
+    delete event;
+    event = next;
+  }
+  event_queue_.Reset();
+}
+
+
+// The list lives in the events, so forgetting its ends is all it takes.
+void EventList::Discard() {
+  event_queue_.Reset();
+}
@@ -0,0 +1,62 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the linked list pending event set for the
+*     Discrete Event Simulation system.
+*     EventList is the original event queue of the simulation executive: a
+*     doubly linked list kept in time order.  Insertion scans forward from
+*     the earliest event, so it is O(n), while removing the earliest event
+*     is O(1).  It remains useful as a simple reference implementation, and
+*     for comparisons against the other PendingEventSet implementations.
+*     The list is an EventChain, linked through the events themselves, so
+*     no list nodes are allocated, and removing a given event is O(1).
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_LIST_HPP_
+#define SIM_DESIM_EVENT_LIST_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_base_event.hpp"
+#include "event_chain.hpp"
+#include "pending_event_set.hpp"
+
+
+class EventList : public PendingEventSet {
+ public:
+  EventList() { };
+  virtual ~EventList();
+
+  // PendingEventSet interface.  See pending_event_set.hpp for details.
+  virtual void Push(SimBaseEvent *new_event);
+  virtual void PushBatch(const std::vector<SimBaseEvent *> &events);
+  virtual SimBaseEvent *PopMin();
+  virtual SimBaseEvent *PeekMin() { return event_queue_.front(); }
+  virtual bool Remove(SimBaseEvent *event);
+  virtual size_t Size() const { return event_queue_.size(); }
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const;
+  virtual void Clear();
+  virtual void Discard();
+
+ private:
+  // The events, in dispatch order
+  EventChain event_queue_;
+  // Holds a batch while it is sorted.  Kept so that its storage is reused.
+  std::vector<SimBaseEvent *> batch_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(EventList);
+}; // class EventList
+
+#endif   // SIM_DESIM_EVENT_LIST_HPP_
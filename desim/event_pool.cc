@@ -0,0 +1,156 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the memory pool for simulation events in the Discrete Event
+*     Simulation system.  See event_pool.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <mutex>
+#include <new>
+
+#include "event_pool.hpp"
+
+const size_t EventPool::kGranularity;
+const size_t EventPool::kClassCount;
+const size_t EventPool::kMaxPooledSize;
+const size_t EventPool::kBlocksPerSlab;
+const size_t EventPool::kMaxCachedBlocks;
+
+// Zero initialized, like any other static storage, so every list starts
+// out empty with zeroed counters.
+thread_local EventPool::SizeClass EventPool::cache_[kClassCount];
+EventPool::SharedList EventPool::shared_[kClassCount];
+std::atomic<uint64_t> EventPool::slab_count_(0);
+
+namespace {
+// Spills the thread's lists as the thread exits, so that blocks freed on
+// a thread that is gone can still be reused.
+struct ThreadCacheFlusher {
+  ~ThreadCacheFlusher() { EventPool::FlushThreadCache(); }
+};
+}  // namespace
+
+
+// Returns - the calling thread's counters summed over every class
+EventPool::Stats EventPool::TotalStats() {
+  Stats total = {0, 0, 0, 0, 0};
+  for (const SizeClass &size_class : cache_) {
+    total.hits += size_class.stats.hits;
+    total.misses += size_class.stats.misses;
+    total.oversize += size_class.stats.oversize;
+    total.live += size_class.stats.live;
+    total.high_water += size_class.stats.high_water;
+  }
+  return total;
+}
+
+
+// Each class's list goes to the shared list as one batch.
+void EventPool::FlushThreadCache() {
+  for (size_t index = 0; index < kClassCount; ++index) {
+    PushBatch(cache_[index].free_list, index);
+    cache_[index].free_list = nullptr;
+    cache_[index].free_count = 0;
+  }
+}
+
+
+// The flusher is constructed on the thread's first call, so its
+// destructor runs as the thread exits.
+void EventPool::RegisterFlusher() {
+  static thread_local ThreadCacheFlusher flusher;
+  (void)flusher;
+}
+
+
+// A batch from the shared list is taken whole, and counted as it goes on
+// the free list.  A new slab is linked in address order, so consecutive
+// allocations are adjacent in memory.  Slabs are never freed, since their
+// blocks may end up on other threads' lists.
+//
+// "size_class" - the (empty) class to refill
+// "index" - index of "size_class"
+void EventPool::Refill(SizeClass *size_class, size_t index) {
+  RegisterFlusher();
+  ++size_class->stats.misses;
+  FreeBlock *batch = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(shared_[index].lock);
+    batch = shared_[index].batches;
+    if (batch != nullptr) {
+      shared_[index].batches = batch->next_batch;
+    }
+  }
+  if (batch != nullptr) {
+    size_t count = 0;
+    for (FreeBlock *block = batch; block != nullptr; block = block->next) {
+      ++count;
+    }
+    size_class->free_list = batch;
+    size_class->free_count = count;
+    return;
+  }
+  const size_t block_size = (index + 1) * kGranularity;
+  char *slab = static_cast<char *>(::operator new(block_size *
+                                                  kBlocksPerSlab));
+  FreeBlock *next = nullptr;
+  for (size_t i = kBlocksPerSlab; i > 0; --i) {
+    FreeBlock *block = reinterpret_cast<FreeBlock *>(slab +
+                                                     (i - 1) * block_size);
+    block->next = next;
+    next = block;
+  }
+  size_class->free_list = next;
+  size_class->free_count = kBlocksPerSlab;
+  slab_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+// The most recently freed blocks are at the head of the list, and are the
+// likeliest to still be in the cache, so they are the ones kept.
+//
+// "size_class" - the class to spill
+// "index" - index of "size_class"
+void EventPool::Spill(SizeClass *size_class, size_t index) {
+  RegisterFlusher();
+  const size_t kept = kMaxCachedBlocks / 2;
+  FreeBlock *last_kept = size_class->free_list;
+  for (size_t i = 1; i < kept; ++i) {
+    last_kept = last_kept->next;
+  }
+  FreeBlock *const batch = last_kept->next;
+  last_kept->next = nullptr;
+  size_class->free_count = kept;
+  PushBatch(batch, index);
+}
+
+
+// "batch" - the first block of the chain.  May be nullptr.
+// "index" - index of the class
+void EventPool::PushBatch(FreeBlock *batch, size_t index) {
+  if (batch == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(shared_[index].lock);
+  batch->next_batch = shared_[index].batches;
+  shared_[index].batches = batch;
+}
+
+
+// Oversize events are counted against the largest class.
+//
+// "size" - size of the event in bytes
+// Returns - the memory
+void *EventPool::AllocateOversize(size_t size) {
+  ++cache_[kClassCount - 1].stats.oversize;
+  return ::operator new(size);
+}
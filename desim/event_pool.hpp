@@ -0,0 +1,230 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the memory pool for simulation events in the
+*     Discrete Event Simulation system.
+*     Every event is created with "new" by a loader, or by another event,
+*     and deleted by the executive as soon as it is dispatched, so the
+*     general purpose heap sees one allocation and one free per event.
+*     SimBaseEvent routes its operator new and delete here instead.
+*
+*     Memory is handed out in size classes, in steps of "kGranularity"
+*     bytes.  Each class keeps a free list of blocks threaded through the
+*     blocks themselves.  An empty list is refilled with a slab of
+*     "kBlocksPerSlab" blocks from the heap, so the heap is only visited
+*     once per slab.  Events larger than the largest class go straight to
+*     the heap.
+*
+*     The free lists are per thread (thread_local), so no locking is
+*     needed if events are created and deleted on several threads.  An
+*     event may be deleted on a different thread from the one that created
+*     it, in which case its block joins the deleting thread's list.  A
+*     thread that only deletes events, e.g. an executive fed by a loader or
+*     another LP, would then gather blocks without limit, while the
+*     creating thread kept carving new slabs.  So each thread's list is
+*     capped at "kMaxCachedBlocks": past that, the oldest blocks are spilled,
+*     as one batch, to a shared list for the class, and an empty list is
+*     refilled from the shared list, under a lock, before a new slab is
+*     carved.  A thread's list is also spilled when the thread exits.
+*
+*     Slabs are never returned to the heap, since their blocks may be on
+*     any list.  The pool holds, at most, the blocks of the most events
+*     that were alive at once, plus "kMaxCachedBlocks" per class for each
+*     thread.
+*
+*     Counters of hits, misses and the high-water mark of live blocks are
+*     kept for each class, and are also per thread.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_POOL_HPP_
+#define SIM_DESIM_EVENT_POOL_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+#include "basic_defs.hpp"
+
+
+class EventPool {
+ public:
+  // Size class geometry.  Blocks are multiples of "kGranularity" bytes,
+  // which keeps them suitably aligned for any event, up to
+  // "kMaxPooledSize" bytes.
+  static const size_t kGranularity = 16;
+  static const size_t kClassCount = 16;
+  static const size_t kMaxPooledSize = kGranularity * kClassCount;
+  // Number of blocks carved from each slab
+  static const size_t kBlocksPerSlab = 64;
+  // Most blocks of one class a thread keeps on its own list.  Half of
+  // them, the most recently freed, are kept when the list is spilled.
+  static const size_t kMaxCachedBlocks = 16 * kBlocksPerSlab;
+
+  // Counters for one size class, or for the whole pool, on one thread.
+  struct Stats {
+    // Allocations served from the free list
+    uint64_t hits;
+    // Allocations that found the free list empty, and refilled it
+    uint64_t misses;
+    // Allocations too large for any class, passed on to the heap
+    uint64_t oversize;
+    // Blocks allocated, less blocks released, on this thread
+    int64_t live;
+    // Largest value "live" has reached
+    int64_t high_water;
+  };
+
+  // Allocates memory for an event.
+  //
+  // "size" - size of the event in bytes
+  // Returns - the memory.  Throws std::bad_alloc if the heap is exhausted.
+  static void *Allocate(size_t size) {
+    if (size > kMaxPooledSize) {
+      return AllocateOversize(size);
+    }
+    SizeClass &size_class = cache_[ClassIndex(size)];
+    if (size_class.free_list == nullptr) {
+      Refill(&size_class, ClassIndex(size));
+    } else {
+      ++size_class.stats.hits;
+    }
+    FreeBlock *block = size_class.free_list;
+    size_class.free_list = block->next;
+    --size_class.free_count;
+    if (++size_class.stats.live > size_class.stats.high_water) {
+      size_class.stats.high_water = size_class.stats.live;
+    }
+    return block;
+  }
+
+  // Returns memory from Allocate() to the pool.
+  //
+  // "memory" - the memory to release.  May be nullptr.
+  // "size" - the size that was passed to Allocate()
+  static void Release(void *memory, size_t size) {
+    if (memory == nullptr) {
+      return;
+    }
+    if (size > kMaxPooledSize) {
+      ::operator delete(memory);
+      return;
+    }
+    SizeClass &size_class = cache_[ClassIndex(size)];
+    FreeBlock *block = static_cast<FreeBlock *>(memory);
+    block->next = size_class.free_list;
+    size_class.free_list = block;
+    --size_class.stats.live;
+    if (++size_class.free_count > kMaxCachedBlocks) {
+      Spill(&size_class, ClassIndex(size));
+    } else if (size_class.free_count == 1) {
+      // The list was empty, and this may be a thread that only deletes
+      // events, which never refills
+      RegisterFlusher();
+    }
+  }
+
+  // "size" - an event size in bytes, no larger than "kMaxPooledSize"
+  // Returns - the calling thread's counters for the class holding "size"
+  static Stats ClassStats(size_t size) {
+    return cache_[ClassIndex(size)].stats;
+  }
+
+  // Returns - the calling thread's counters summed over every class.  The
+  //       high-water mark is the sum of the class high-water marks, so it
+  //       bounds the number of blocks held by the pool.
+  static Stats TotalStats();
+
+  // Returns - the number of slabs carved from the heap so far, by every
+  //       thread.  Each holds "kBlocksPerSlab" blocks of one class.
+  static uint64_t SlabCount() {
+    return slab_count_.load(std::memory_order_relaxed);
+  }
+
+  // Moves every block on the calling thread's lists to the shared lists,
+  // where other threads can reuse them.  Called as each thread that has
+  // put a block on one of its lists exits.
+  static void FlushThreadCache();
+
+ private:
+  // A free block, linked to the next free block of the same class.  The
+  // first block of a batch on a shared list is also linked to the next
+  // batch.  Blocks are at least "kGranularity" bytes, so both links fit.
+  struct FreeBlock {
+    FreeBlock *next;
+    FreeBlock *next_batch;
+  };
+
+  // Free list and counters for one size class
+  struct SizeClass {
+    FreeBlock *free_list;
+    // Blocks on "free_list"
+    size_t free_count;
+    Stats stats;
+  };
+
+  // Batches of blocks spilled by any thread, for one size class
+  struct SharedList {
+    std::mutex lock;
+    FreeBlock *batches;
+  };
+
+  // "size" - an event size in bytes, no larger than "kMaxPooledSize"
+  // Returns - the index of the smallest class that holds "size"
+  static size_t ClassIndex(size_t size) {
+    return (size == 0) ? 0 : (size - 1) / kGranularity;
+  }
+
+  // Makes sure the calling thread's lists are spilled, by
+  // FlushThreadCache(), when the thread exits.  Cheap after the first
+  // call on each thread.
+  static void RegisterFlusher();
+
+  // Refills an empty free list with a batch from the shared list, if
+  // there is one, or else with a new slab carved into blocks.
+  //
+  // "size_class" - the (empty) class to refill
+  // "index" - index of "size_class"
+  static void Refill(SizeClass *size_class, size_t index);
+
+  // Moves the oldest blocks on a free list, all but the most recent half
+  // of "kMaxCachedBlocks", to the shared list as one batch.
+  //
+  // "size_class" - the class to spill
+  // "index" - index of "size_class"
+  static void Spill(SizeClass *size_class, size_t index);
+
+  // Pushes a chain of blocks on to the shared list for a class.
+  //
+  // "batch" - the first block of the chain.  May be nullptr.
+  // "index" - index of the class
+  static void PushBatch(FreeBlock *batch, size_t index);
+
+  // Passes an allocation that is too large for the pool on to the heap.
+  //
+  // "size" - size of the event in bytes
+  // Returns - the memory
+  static void *AllocateOversize(size_t size);
+
+  // The calling thread's size classes
+  static thread_local SizeClass cache_[kClassCount];
+  // The shared lists, one per class
+  static SharedList shared_[kClassCount];
+  // Slabs carved, by every thread
+  static std::atomic<uint64_t> slab_count_;
+
+  // Only static members, so no instances
+  EventPool();
+  DISALLOW_COPY_AND_ASSIGN(EventPool);
+}; // class EventPool
+
+#endif   // SIM_DESIM_EVENT_POOL_HPP_
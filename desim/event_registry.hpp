@@ -0,0 +1,144 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the compile-time event type registry for the
+*     Discrete Event Simulation system.
+*     The executive normally dispatches every event through the virtual
+*     SimBaseEvent::Dispatch().  An EventRegistry names a closed list of
+*     event types instead, and SimExec::RunTyped() uses it to dispatch those
+*     types with direct, non-virtual calls, which the compiler is free to
+*     inline.  The type of each event is found from the small type id that
+*     it carries in SimBaseEvent, by a chain of comparisons that the
+*     compiler can turn into a jump table.  Events of any other type are
+*     still dispatched through the virtual method.
+*
+*     A registered type must:
+*     - derive from SimBaseEvent, and pass its own, nonzero, type id to the
+*       SimBaseEvent ctor.  The ids within one registry must be distinct.
+*     - declare that id as "static const uint16_t kEventTypeId".
+*     - be "final", or have every derived class pass its own type id, since
+*       the registry calls the Dispatch() of the registered type.
+*     A registered type may also hide SimBaseEvent::BindToExec(), to look
+*     up anything it needs from the executive (the log manager, say) once
+*     per run rather than once per event.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_EVENT_REGISTRY_HPP_
+#define SIM_DESIM_EVENT_REGISTRY_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <type_traits>
+
+#include "sim_base_event.hpp"
+
+class SimExec;
+
+// Returns - "true" if "type_id" is the "kEventTypeId" of one of
+//       "EventTypes"
+template <typename... EventTypes>
+struct EventTypeIdListed;
+
+template <>
+struct EventTypeIdListed<> {
+  // No types are listed, so the id is left unnamed
+  static constexpr bool Check(uint16_t) { return false; }
+};
+
+template <typename First, typename... Rest>
+struct EventTypeIdListed<First, Rest...> {
+  static constexpr bool Check(uint16_t type_id) {
+    return (type_id == First::kEventTypeId) ||
+           EventTypeIdListed<Rest...>::Check(type_id);
+  }
+};
+
+
+template <typename... EventTypes>
+class EventRegistry;
+
+// The empty registry dispatches everything through the virtual method.
+// SimExec::Run() uses it.
+template <>
+class EventRegistry<> {
+ public:
+  // "event" - the event to dispatch
+  static void Dispatch(const SimBaseEvent *event) { event->Dispatch(); }
+
+  // "events" - a run of events of one type, to dispatch in order
+  // "count" - the number of events, at least one
+  static void DispatchBatch(const SimBaseEvent *const *events,
+                            size_t count) {
+    events[0]->DispatchBatch(events, count);
+  }
+
+  // No types are registered, so there is nothing to bind, and the
+  // executive is left unnamed.
+  static void BindToExec(SimExec *) {}
+
+ private:
+  // Only static members, so no instances
+  EventRegistry();
+  DISALLOW_COPY_AND_ASSIGN(EventRegistry);
+}; // class EventRegistry<>
+
+template <typename First, typename... Rest>
+class EventRegistry<First, Rest...> {
+  static_assert(std::is_base_of<SimBaseEvent, First>::value,
+                "Registered event types must derive from SimBaseEvent");
+  static_assert(First::kEventTypeId != SimBaseEvent::kUntypedEvent,
+                "Registered event types need a nonzero kEventTypeId");
+  static_assert(!EventTypeIdListed<Rest...>::Check(First::kEventTypeId),
+                "Registered event types need distinct kEventTypeIds");
+
+ public:
+  // Dispatches the event with a direct call if its type is registered,
+  // and through the virtual method otherwise.
+  //
+  // "event" - the event to dispatch
+  static void Dispatch(const SimBaseEvent *event) {
+    if (event->event_type_id() == First::kEventTypeId) {
+      static_cast<const First *>(event)->First::Dispatch();
+    } else {
+      EventRegistry<Rest...>::Dispatch(event);
+    }
+  }
+
+  // Dispatches a run of events of one type, as above.
+  //
+  // "events" - a run of events of one type, to dispatch in order
+  // "count" - the number of events, at least one
+  static void DispatchBatch(const SimBaseEvent *const *events,
+                            size_t count) {
+    if (events[0]->event_type_id() == First::kEventTypeId) {
+      static_cast<const First *>(events[0])->First::DispatchBatch(events,
+                                                                  count);
+    } else {
+      EventRegistry<Rest...>::DispatchBatch(events, count);
+    }
+  }
+
+  // Lets each registered type bind to the executive for a run.
+  //
+  // "exec" - the executive starting a run, or nullptr as it finishes
+  static void BindToExec(SimExec *exec) {
+    First::BindToExec(exec);
+    EventRegistry<Rest...>::BindToExec(exec);
+  }
+
+ private:
+  // Only static members, so no instances
+  EventRegistry();
+  DISALLOW_COPY_AND_ASSIGN(EventRegistry);
+}; // class EventRegistry<First, Rest...>
+
+#endif   // SIM_DESIM_EVENT_REGISTRY_HPP_
@@ -0,0 +1,407 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the ladder queue pending event set for the Discrete Event
+*     Simulation system.  See ladder_queue.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <algorithm>
+#include <limits>
+
+#include "ladder_queue.hpp"
+
+// Largest bucket that will be sorted into Bottom.  Larger buckets are
+// spread across a new rung instead.  This is the "THRES" of Tang et al.
+constexpr static size_t kBucketThreshold = 50;
+// Most rungs the ladder may have.  Once reached, large buckets are sorted
+// into Bottom regardless of their size.
+constexpr static size_t kMaxRungs = 8;
+// Largest representable tick count
+constexpr static SimTime::SimTick kMaxTicks =
+                           std::numeric_limits<SimTime::SimTick>::max();
+
+
+// Adds "addend" to "ticks", saturating at the largest tick count rather
+// than wrapping around.
+//
+// Returns - the saturated sum
+static SimTime::SimTick SaturatingAdd(SimTime::SimTick ticks,
+                                      SimTime::SimTick addend) {
+  return (ticks > kMaxTicks - addend) ? kMaxTicks : ticks + addend;
+}
+
+
+// Returns - the tick count of "event"
+static SimTime::SimTick EventTicks(const SimBaseEvent *event) {
+  return event->event_time().ticks();
+}
+
+
+// Time ordering used to sort and search Bottom
+//
+// Returns - "true" if "left" is earlier than "right"
+static bool EarlierTicks(const SimBaseEvent *left, const SimBaseEvent *right) {
+  return EventTicks(left) < EventTicks(right);
+}
+
+
+// All of the rungs are created up front, so that their addresses, and
+// those of their buckets, never change.  Everything starts out in Top.
+LadderQueue::LadderQueue() : top_start_(0), top_min_(kMaxTicks),
+                             top_max_(0), rungs_(kMaxRungs),
+                             active_rungs_(0), max_active_rungs_(0),
+                             bottom_head_(0), size_(0) {
+}
+
+
+// The queue doesn't own the events, so there is nothing to clean up
+// beyond the tiers themselves.
+LadderQueue::~LadderQueue() {
+}
+
+
+// Events beyond the ladder go to Top.  Otherwise, the event goes into the
+// first rung whose current bucket is no later than the event, or into
+// Bottom, after any events with the same time, if it is earlier than all
+// of the rungs.
+//
+// "new_event" - the event to place in the queue
+void LadderQueue::Push(SimBaseEvent *new_event) {
+  const SimTime::SimTick ticks = EventTicks(new_event);
+  ++size_;
+  if (ticks >= top_start_) {
+    Append(&top_, new_event);
+    top_min_ = std::min(top_min_, ticks);
+    top_max_ = std::max(top_max_, ticks);
+    return;
+  }
+  for (size_t i = 0; i < active_rungs_; ++i) {
+    Rung &rung = rungs_[i];
+    if (ticks >= rung.current_start) {
+      Append(&rung.buckets[(ticks - rung.start) / rung.width], new_event);
+      ++rung.count;
+      return;
+    }
+  }
+  Bucket::iterator position =
+      bottom_.insert(std::upper_bound(bottom_.begin() + bottom_head_,
+                                      bottom_.end(), new_event, EarlierTicks),
+                     new_event);
+  RenumberBottom(position - bottom_.begin());
+}
+
+
+// Popped events are left behind the head of Bottom, and only discarded
+// once they make up most of it, so that popping is amortized O(1) without
+// Bottom ever giving up its storage.
+//
+// Returns - the earliest event, which is always at the head of Bottom
+SimBaseEvent *LadderQueue::PopMin() {
+  FillBottom();
+  SimBaseEvent *min_event = bottom_[bottom_head_++];
+  --size_;
+  if (bottom_head_ == bottom_.size()) {
+    bottom_.clear();
+    bottom_head_ = 0;
+  } else if ((bottom_head_ >= kBucketThreshold) &&
+             (2 * bottom_head_ >= bottom_.size())) {
+    bottom_.erase(bottom_.begin(), bottom_.begin() + bottom_head_);
+    bottom_head_ = 0;
+    RenumberBottom(0);
+  }
+  return min_event;
+}
+
+
+// Returns - the earliest event, without removing it.
+SimBaseEvent *LadderQueue::PeekMin() {
+  FillBottom();
+  return bottom_[bottom_head_];
+}
+
+
+// An event's time determines where it is, by the same rules Push() uses,
+// and the event records its position there, so nothing is searched.  In
+// Top and the Ladder the event's slot is left as a hole, which keeps the
+// order of the events that remain without moving any of them.  Bottom is
+// erased from, since it must stay sorted, but it rarely holds more than a
+// bucket's worth of events.
+//
+// "event" - the event to remove
+// Returns - "true" if the event was in the queue
+bool LadderQueue::Remove(SimBaseEvent *event) {
+  const SimTime::SimTick ticks = EventTicks(event);
+  const size_t index = event->heap_index_;
+  if (ticks >= top_start_) {
+    // "top_min_" and "top_max_" are left as they are, since they still
+    // bound the remaining events.
+    if (!HoldsAt(top_, event)) {
+      return false;
+    }
+    top_[index] = nullptr;
+  } else {
+    size_t i = 0;
+    while ((i < active_rungs_) && (ticks < rungs_[i].current_start)) {
+      ++i;
+    }
+    if (i < active_rungs_) {
+      Rung &rung = rungs_[i];
+      Bucket &bucket = rung.buckets[(ticks - rung.start) / rung.width];
+      if (!HoldsAt(bucket, event)) {
+        return false;
+      }
+      bucket[index] = nullptr;
+      --rung.count;
+    } else {
+      if ((index < bottom_head_) || !HoldsAt(bottom_, event)) {
+        return false;
+      }
+      bottom_.erase(bottom_.begin() + index);
+      RenumberBottom(index);
+      if (bottom_head_ == bottom_.size()) {
+        bottom_.clear();
+        bottom_head_ = 0;
+      }
+    }
+  }
+  --size_;
+  return true;
+}
+
+
+// Gathers all three tiers, less any holes, then sorts on time.  Events
+// with the same time
+// are all in the same place, in FIFO order, and the sort is stable, so
+// FIFO order is preserved.
+//
+// "events" - receives the ordered events.
+void LadderQueue::OrderedEvents(std::vector<SimBaseEvent *> *events) const {
+  events->assign(bottom_.begin() + bottom_head_, bottom_.end());
+  events->reserve(size_);
+  for (size_t i = 0; i < active_rungs_; ++i) {
+    for (const Bucket &bucket : rungs_[i].buckets) {
+      events->insert(events->end(), bucket.begin(), bucket.end());
+    }
+  }
+  events->insert(events->end(), top_.begin(), top_.end());
+  events->erase(std::remove(events->begin(), events->end(), nullptr),
+                events->end());
+  std::stable_sort(events->begin(), events->end(), EarlierTicks);
+}
+
+
+// Deletes every event, and returns the queue to its initial state.  Holes
+// are nullptr, which delete ignores.
+void LadderQueue::Clear() {
+  for (size_t i = bottom_head_; i < bottom_.size(); ++i) {
+    delete bottom_[i];
+  }
+  for (size_t i = 0; i < active_rungs_; ++i) {
+    for (const Bucket &bucket : rungs_[i].buckets) {
+      for (SimBaseEvent *event : bucket) {
+        delete event;
+      }
+    }
+  }
+  for (SimBaseEvent *event : top_) {
+    delete event;
+  }
+  Discard();
+}
+
+
+// Returns the queue to its initial state without touching the events.
+// The rungs keep their buckets for reuse.
+void LadderQueue::Discard() {
+  bottom_.clear();
+  bottom_head_ = 0;
+  for (size_t i = 0; i < active_rungs_; ++i) {
+    for (Bucket &bucket : rungs_[i].buckets) {
+      bucket.clear();
+    }
+  }
+  active_rungs_ = 0;
+  top_.clear();
+  top_start_ = 0;
+  top_min_ = kMaxTicks;
+  top_max_ = 0;
+  size_ = 0;
+}
+
+
+// Works down the ladder until Bottom has something in it.  Rungs that
+// have been used up are discarded, and when the ladder is empty, Top is
+// moved onto it.
+void LadderQueue::FillBottom() {
+  while (bottom_head_ == bottom_.size()) {
+    if (active_rungs_ == 0) {
+      TransferTop();
+      continue;
+    }
+    Rung &rung = rungs_[active_rungs_ - 1];
+    if (rung.count == 0) {
+      // Only holes can be left, and the buckets must be empty for reuse
+      for (size_t i = rung.current; i < rung.buckets.size(); ++i) {
+        rung.buckets[i].clear();
+      }
+      --active_rungs_;
+      continue;
+    }
+    // There is an event in this rung, so there must be a non-empty bucket
+    // at, or after, the current one.
+    while (rung.buckets[rung.current].empty()) {
+      ++rung.current;
+      rung.current_start = SaturatingAdd(rung.current_start, rung.width);
+    }
+    Bucket &bucket = rung.buckets[rung.current];
+    const SimTime::SimTick bucket_start = rung.current_start;
+    ++rung.current;
+    rung.current_start = SaturatingAdd(rung.current_start, rung.width);
+    Compact(&bucket);
+    rung.count -= bucket.size();
+    // Buckets with one tick width can't be split further, so they go to
+    // Bottom however large they are.
+    if ((bucket.size() > kBucketThreshold) && (rung.width > 1) &&
+        (active_rungs_ < kMaxRungs)) {
+      SpawnRung(&bucket, bucket_start, rung.width);
+    } else {
+      MoveToBottom(&bucket);
+    }
+  }
+}
+
+
+// A large Top is spread across a new first rung with one bucket per
+// event, which is Tang's choice.  A small Top, or one in which every event
+// has the same time, is sorted directly into Bottom.  Either way, Top then
+// starts just past the events that were moved.
+void LadderQueue::TransferTop() {
+  Compact(&top_);
+  const size_t count = top_.size();
+  if ((count <= kBucketThreshold) || (top_min_ == top_max_)) {
+    top_start_ = SaturatingAdd(top_max_, 1);
+    MoveToBottom(&top_);
+  } else {
+    // "count" buckets of this width span more than "top_max_ - top_min_"
+    const SimTime::SimTick width = (top_max_ - top_min_) / count + 1;
+    Rung *rung = AddRung(top_min_, width, count);
+    top_start_ = (width > (kMaxTicks - top_min_) / count) ?
+                 kMaxTicks : top_min_ + width * count;
+    for (SimBaseEvent *event : top_) {
+      Append(&rung->buckets[(EventTicks(event) - top_min_) / width], event);
+    }
+    rung->count = count;
+    top_.clear();
+  }
+  top_min_ = kMaxTicks;
+  top_max_ = 0;
+}
+
+
+// The new rung has one bucket per event, or one bucket per tick if that
+// is fewer, and spans the whole of the original bucket.
+//
+// "bucket" - the bucket to spread, without holes.  Emptied before
+//       returning.
+// "start" - time at the start of "bucket"
+// "width" - width of "bucket" in ticks
+void LadderQueue::SpawnRung(Bucket *bucket, SimTime::SimTick start,
+                            SimTime::SimTick width) {
+  const size_t count = bucket->size();
+  const SimTime::SimTick child_width = (width - 1) / count + 1;
+  Rung *rung = AddRung(start, child_width, (width - 1) / child_width + 1);
+  for (SimBaseEvent *event : *bucket) {
+    Append(&rung->buckets[(EventTicks(event) - start) / child_width], event);
+  }
+  rung->count = count;
+  bucket->clear();
+}
+
+
+// Buckets left over from the rung's previous use are already empty, so
+// the bucket array only ever grows.
+//
+// "start" - time at the start of the first bucket
+// "width" - width of each bucket in ticks
+// "bucket_count" - number of buckets needed
+// Returns - the new rung, which is now the lowest
+LadderQueue::Rung *LadderQueue::AddRung(SimTime::SimTick start,
+                                        SimTime::SimTick width,
+                                        size_t bucket_count) {
+  Rung *rung = &rungs_[active_rungs_++];
+  max_active_rungs_ = std::max(max_active_rungs_, active_rungs_);
+  if (rung->buckets.size() < bucket_count) {
+    rung->buckets.resize(bucket_count);
+  }
+  rung->start = start;
+  rung->width = width;
+  rung->current = 0;
+  rung->current_start = start;
+  rung->count = 0;
+  return rung;
+}
+
+
+// Bottom is always empty when this is called, so its head goes back to
+// the start.  The sort is stable, and the bucket holds same time events in
+// FIFO order, so that order is kept.  Buckets are normally no larger than
+// the threshold, and are sorted in place, since std::stable_sort()
+// allocates a buffer on every call.
+//
+// "bucket" - the events to sort into Bottom, without holes.  Emptied
+//       before returning.
+void LadderQueue::MoveToBottom(Bucket *bucket) {
+  bottom_.assign(bucket->begin(), bucket->end());
+  bottom_head_ = 0;
+  if (bottom_.size() <= kBucketThreshold) {
+    // Insertion sort, which is stable
+    for (size_t i = 1; i < bottom_.size(); ++i) {
+      SimBaseEvent *event = bottom_[i];
+      size_t j = i;
+      while ((j > 0) && EarlierTicks(event, bottom_[j - 1])) {
+        bottom_[j] = bottom_[j - 1];
+        --j;
+      }
+      bottom_[j] = event;
+    }
+  } else {
+    std::stable_sort(bottom_.begin(), bottom_.end(), EarlierTicks);
+  }
+  RenumberBottom(0);
+  bucket->clear();
+}
+
+
+// "first" - position of the first event in Bottom that has moved
+void LadderQueue::RenumberBottom(size_t first) {
+  for (size_t i = first; i < bottom_.size(); ++i) {
+    bottom_[i]->heap_index_ = i;
+  }
+}
+
+
+// "bucket" - the bucket to add to
+// "event" - the event to add
+void LadderQueue::Append(Bucket *bucket, SimBaseEvent *event) {
+  event->heap_index_ = bucket->size();
+  bucket->push_back(event);
+}
+
+
+// The events' positions are left as they are, since the bucket is always
+// about to be emptied into Bottom or a new rung, which record new ones.
+//
+// "bucket" - the bucket to compact
+void LadderQueue::Compact(Bucket *bucket) {
+  bucket->erase(std::remove(bucket->begin(), bucket->end(), nullptr),
+                bucket->end());
+}
@@ -0,0 +1,165 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the ladder queue pending event set for the
+*     Discrete Event Simulation system.
+*     LadderQueue follows the ladder queue of W. T. Tang, R. S. M. Goh and
+*     I. L.-J. Thng (ACM TOMACS, 2005).  Events are held in three tiers:
+*
+*     Top - an unsorted list of events beyond the range of the ladder.
+*             Pushing onto Top is O(1), which makes a burst of far future
+*             events, such as a whole window of stimulus, cheap to absorb.
+*     Ladder - a stack of "rungs", each an array of buckets covering a
+*             contiguous span of time.  When Bottom runs dry, the next
+*             non-empty bucket of the lowest rung is either sorted into
+*             Bottom or, if it holds too many events, spread across a new,
+*             finer, rung.
+*     Bottom - a short sorted list from which events are removed.
+*
+*     Sorting is deferred until events are close to being dispatched, and
+*     each sort is on a small number of events, so both insertion and
+*     removal are amortized O(1), even for skewed or bursty distributions
+*     of event times.  An event's time determines its tier, rung and
+*     bucket, and each event records its position in that bucket, so
+*     removing an arbitrary event from Top or the Ladder is O(1): its slot
+*     is simply emptied, and the holes are dropped when the bucket is next
+*     moved.  Bottom is sorted, so it can't have holes, and events removed
+*     from it are erased.
+*
+*     Events with the same time always land in the same tier, rung and
+*     bucket, and each transfer between tiers preserves their order, so
+*     they are removed in the order in which they were pushed (FIFO).
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_LADDER_QUEUE_HPP_
+#define SIM_DESIM_LADDER_QUEUE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+
+
+class LadderQueue : public PendingEventSet {
+ public:
+  LadderQueue();
+  virtual ~LadderQueue();
+
+  // PendingEventSet interface.  See pending_event_set.hpp for details.
+  virtual void Push(SimBaseEvent *new_event);
+  virtual SimBaseEvent *PopMin();
+  virtual SimBaseEvent *PeekMin();
+  virtual bool Remove(SimBaseEvent *event);
+  virtual size_t Size() const { return size_; }
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const;
+  virtual void Clear();
+  virtual void Discard();
+
+#ifdef TEST_HARNESS
+  // Test accessors for the current shape of the ladder
+  //
+  // Returns - the number of rungs in use / the most rungs ever in use
+  size_t rung_count() const { return active_rungs_; }
+  size_t max_rung_count() const { return max_active_rungs_; }
+#endif
+
+ private:
+  typedef std::vector<SimBaseEvent *> Bucket;
+
+  // One rung of the ladder.  Bucket "i" holds the events in
+  // ["start + i * width", "start + (i + 1) * width").  Buckets before
+  // "current" have already been moved down the ladder.
+  struct Rung {
+    std::vector<Bucket> buckets;
+    SimTime::SimTick start;
+    SimTime::SimTick width;
+    // Index of the next bucket to be moved down, and its start time.
+    // Events earlier than "current_start" belong below this rung.
+    size_t current;
+    SimTime::SimTick current_start;
+    // Number of events in the rung, not counting holes
+    size_t count;
+  };
+
+  // Makes sure that Bottom holds the earliest events, moving events down
+  // from the Ladder or Top as needed.  The queue must not be empty.
+  void FillBottom();
+
+  // Moves the contents of Top into a new first rung, or straight into
+  // Bottom if there are too few events, or they share a single time.
+  void TransferTop();
+
+  // Spreads "bucket" (which covers ["start", "start + width")) across a
+  // new rung below the current lowest rung.
+  void SpawnRung(Bucket *bucket, SimTime::SimTick start,
+                 SimTime::SimTick width);
+
+  // Readies the next unused rung to cover "bucket_count" buckets of
+  // "width" ticks from "start".
+  //
+  // Returns - the new rung, which is now the lowest
+  Rung *AddRung(SimTime::SimTick start, SimTime::SimTick width,
+                size_t bucket_count);
+
+  // Sorts the events in "bucket" into the (empty) Bottom, and empties
+  // the bucket.
+  void MoveToBottom(Bucket *bucket);
+
+  // Records the positions of the events in Bottom from "first" on, after
+  // they have moved.
+  void RenumberBottom(size_t first);
+
+  // Appends "event" to "bucket", recording its position in the event.
+  static void Append(Bucket *bucket, SimBaseEvent *event);
+
+  // Drops the holes left in "bucket" by Remove(), keeping the order of
+  // the events that remain.
+  static void Compact(Bucket *bucket);
+
+  // Returns - "true" if "event" is in "bucket" at the position the event
+  //       recorded
+  static bool HoldsAt(const Bucket &bucket, const SimBaseEvent *event) {
+    return (event->heap_index_ < bucket.size()) &&
+           (bucket[event->heap_index_] == event);
+  }
+
+  // Unsorted events at, or after, "top_start_", with their time range.
+  // Removed events leave nullptr holes in Top and the rungs' buckets.
+  Bucket top_;
+  SimTime::SimTick top_start_;
+  SimTime::SimTick top_min_;
+  SimTime::SimTick top_max_;
+
+  // The rungs, coarsest first.  Only the first "active_rungs_" are in use.
+  // Unused rungs are kept so that their buckets can be reused.
+  std::vector<Rung> rungs_;
+  size_t active_rungs_;
+  size_t max_active_rungs_;
+
+  // Sorted events, all earlier than any event in the Ladder or Top.  Only
+  // those from "bottom_head_" on are still in the queue.  A vector, rather
+  // than a deque, since a deque allocates and frees blocks as events pass
+  // through it.
+  Bucket bottom_;
+  size_t bottom_head_;
+
+  // Number of events in all three tiers
+  size_t size_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(LadderQueue);
+}; // class LadderQueue
+
+#endif   // SIM_DESIM_LADDER_QUEUE_HPP_
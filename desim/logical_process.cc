@@ -0,0 +1,205 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the logical process for parallel execution in the Discrete
+*     Event Simulation system.  See logical_process.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <iostream>
+
+#include "logical_process.hpp"
+#include "common_strings.hpp"
+
+const LogicalProcess::SimTick LogicalProcess::kNever;
+
+thread_local LogicalProcess *LogicalProcess::current_ = nullptr;
+
+
+// "id" - index of this LP in its executive
+// "lp_count" - number of LPs in the executive
+// "event_set" - pointer to an empty pending event set
+LogicalProcess::LogicalProcess(uint32_t id, uint32_t lp_count,
+                               PendingEventSet *event_set)
+    : id_(id), curr_time_(0.0), event_queue_(event_set),
+      dispatched_count_(0), out_index_(lp_count, -1), inbox_version_(0) {
+}
+
+
+// Messages still in the inbox were sent for after the end of the run.
+LogicalProcess::~LogicalProcess() {
+  for (SimBaseEvent *message : inbox_) {
+    delete message;
+  }
+  event_queue_->Clear();
+  delete event_queue_;
+}
+
+
+// As with SimExec, rejecting events in the past keeps the pending event
+// set monotone.
+//
+// "new_event" - the event to schedule
+// Returns - "true" if the event was scheduled
+bool LogicalProcess::ScheduleEvent(SimBaseEvent *new_event) {
+  if (new_event->EarlierThan(curr_time_)) {
+    std::cerr << kCommonStrError << "LP " << id_ << " attempted to schedule "
+                 "event in the past.  Event Time: "
+              << new_event->event_time().GetUserTime()
+              << " Current LP Time: " << curr_time_.GetUserTime()
+              << std::endl;
+    delete new_event;
+    return false;
+  }
+  event_queue_->Push(new_event);
+  return true;
+}
+
+
+// The message carries the promise of the sender's clock plus the
+// lookahead, which is what makes it safe for the receiver to dispatch up
+// to the least promise on its channels.
+//
+// "to" - index of the receiving LP
+// "new_event" - the event to send
+// Returns - "true" if the event was sent
+bool LogicalProcess::SendEvent(uint32_t to, SimBaseEvent *new_event) {
+  if (to == id_) {
+    return ScheduleEvent(new_event);
+  }
+  if ((to >= out_index_.size()) || (out_index_[to] < 0)) {
+    std::cerr << kCommonStrError << "LP " << id_ << " has no link to LP "
+              << to << std::endl;
+    delete new_event;
+    return false;
+  }
+  const OutLink &link = out_links_[out_index_[to]];
+  const SimTick promise = curr_time_.ticks() + link.lookahead;
+  if (new_event->event_time().ticks() < promise) {
+    std::cerr << kCommonStrError << "LP " << id_ << " attempted to send "
+                 "event within the lookahead.  Event Time: "
+              << new_event->event_time().GetUserTime()
+              << " Current LP Time: " << curr_time_.GetUserTime()
+              << std::endl;
+    delete new_event;
+    return false;
+  }
+  link.to->Deliver(link.channel, new_event, promise);
+  return true;
+}
+
+
+// "to" - the receiving LP
+// "lookahead" - least delay between this LP's clock and any event sent
+void LogicalProcess::AddOutLink(LogicalProcess *to, SimTick lookahead) {
+  Channel channel = {id_, 0};
+  OutLink link = {to, lookahead, to->channels_.size()};
+  to->channels_.push_back(channel);
+  out_index_[to->id_] = static_cast<int>(out_links_.size());
+  out_links_.push_back(link);
+}
+
+
+// "channel" - index of the sender's channel
+// "message" - the event sent, or nullptr for a null message
+// "promise" - lower bound on anything sent later over the channel
+// Returns - "true" if the channel's clock was raised
+bool LogicalProcess::Deliver(size_t channel, SimBaseEvent *message,
+                             SimTick promise) {
+  std::lock_guard<std::mutex> lock(inbox_mutex_);
+  const bool raised = (promise > channels_[channel].clock);
+  if (raised) {
+    channels_[channel].clock = promise;
+  }
+  if (message != nullptr) {
+    inbox_.push_back(message);
+  }
+  if (raised || (message != nullptr)) {
+    ++inbox_version_;
+    inbox_changed_.notify_one();
+  }
+  return raised;
+}
+
+
+// The channel clocks are read together with the messages, so no message
+// earlier than the returned time can arrive after the inbox is drained.
+//
+// "version" - receives the inbox version that was drained
+// Returns - the least channel clock, or "kNever"
+LogicalProcess::SimTick LogicalProcess::DrainInbox(uint64_t *version) {
+  SimTick safe = kNever;
+  {
+    std::lock_guard<std::mutex> lock(inbox_mutex_);
+    drained_.swap(inbox_);
+    for (const Channel &channel : channels_) {
+      safe = (channel.clock < safe) ? channel.clock : safe;
+    }
+    *version = inbox_version_;
+  }
+  if (!drained_.empty()) {
+    event_queue_->PushBatch(drained_);
+    drained_.clear();
+  }
+  return safe;
+}
+
+
+// "version" - the version returned by DrainInbox()
+void LogicalProcess::WaitForInbox(uint64_t version) {
+  std::unique_lock<std::mutex> lock(inbox_mutex_);
+  inbox_changed_.wait(lock, [this, version] {
+    return inbox_version_ != version;
+  });
+}
+
+
+// Events at "safe" itself wait, since a message at that time may still
+// arrive.
+//
+// "safe" - no message earlier than this can still arrive
+// "end" - time at which the run ends
+void LogicalProcess::DispatchUntil(SimTick safe, SimTick end) {
+  while (!event_queue_->Empty()) {
+    SimBaseEvent *head_event = event_queue_->PeekMin();
+    const SimTick head_ticks = head_event->event_time().ticks();
+    if ((head_ticks >= safe) || (head_ticks > end)) {
+      break;
+    }
+    event_queue_->PopMin();
+    curr_time_.SetTime(head_event->event_time());
+    head_event->Dispatch();
+    delete head_event;
+    ++dispatched_count_;
+  }
+}
+
+
+// Returns - the time of the earliest pending event, or "kNever"
+LogicalProcess::SimTick LogicalProcess::NextEventTicks() const {
+  return event_queue_->Empty() ? kNever :
+                                 event_queue_->PeekMin()->event_time().ticks();
+}
+
+
+// "bound" - no event earlier than this will be dispatched by this LP
+// Returns - the number of null messages that raised a channel clock
+uint64_t LogicalProcess::PromiseAll(SimTick bound) {
+  uint64_t raised = 0;
+  for (const OutLink &link : out_links_) {
+    const SimTick promise = (bound > kNever - link.lookahead) ?
+                            kNever : bound + link.lookahead;
+    if (link.to->Deliver(link.channel, nullptr, promise)) {
+      ++raised;
+    }
+  }
+  return raised;
+}
@@ -0,0 +1,189 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the logical process for parallel execution in
+*     the Discrete Event Simulation system.
+*     A parallel executive partitions the model into logical processes
+*     (LPs).  Each LP has its own pending event set and its own clock, and
+*     runs on its own thread.  Events for the same LP are scheduled with
+*     ScheduleEvent(), as with SimExec.  Events for another LP are sent
+*     with SendEvent(), over a link that the model declared in advance,
+*     with a lookahead: the least delay between the sender's clock and the
+*     time of any event it sends over that link.
+*
+*     Messages are delivered to the receiving LP's inbox, which has one
+*     channel per incoming link.  Along with each message, or alone (a
+*     "null message"), the sender promises a lower bound on the time of
+*     anything it will send over the link later.  The least promise over
+*     all of an LP's channels is the time up to which it may safely
+*     dispatch its events.
+*
+*     While an LP is dispatching, LogicalProcess::current() returns it, so
+*     that events can schedule and send further events.  The executive
+*     that runs the LPs (e.g. ConservativeExec or WindowExec) owns them.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_LOGICAL_PROCESS_HPP_
+#define SIM_DESIM_LOGICAL_PROCESS_HPP_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+
+
+class LogicalProcess {
+ public:
+  typedef SimTime::SimTick SimTick;
+  // A time later than that of any event
+  static const SimTick kNever = UINT64_MAX;
+
+  // "id" - index of this LP in its executive
+  // "lp_count" - number of LPs in the executive
+  // "event_set" - pointer to an empty pending event set.  The LP takes
+  //       responsibility for its memory.
+  LogicalProcess(uint32_t id, uint32_t lp_count, PendingEventSet *event_set);
+  // Deletes any events still pending, or still in the inbox.
+  ~LogicalProcess();
+
+  // Returns - index of this LP in its executive
+  uint32_t id() const { return id_; }
+
+  // Returns - the time of the event most recently dispatched by this LP
+  SimTime curr_time() const { return curr_time_; }
+
+  // Schedules an event on this LP.  Events earlier than the LP's current
+  // time are rejected with an error message, and deleted.
+  //
+  // "new_event" - the event to schedule.  The LP takes responsibility for
+  //       it.
+  // Returns - "true" if the event was scheduled
+  bool ScheduleEvent(SimBaseEvent *new_event);
+
+  // Sends an event to another LP, over the link declared from this LP to
+  // it.  Events earlier than this LP's current time plus the link's
+  // lookahead, or to an LP without a link from this one, are rejected with
+  // an error message, and deleted.  Sending an event to this LP is the
+  // same as scheduling it.
+  //
+  // "to" - index of the receiving LP
+  // "new_event" - the event to send.  The receiving LP takes
+  //       responsibility for it.
+  // Returns - "true" if the event was sent
+  bool SendEvent(uint32_t to, SimBaseEvent *new_event);
+
+  // Returns - the number of events this LP has dispatched
+  uint64_t dispatched_count() const { return dispatched_count_; }
+
+  // Returns - the LP dispatching events on the calling thread, or nullptr
+  static LogicalProcess *current() { return current_; }
+
+ private:
+  friend class ConservativeExec;
+  friend class WindowExec;
+  friend class ShmExec;
+
+  // One incoming link.  "clock" is the sender's promise: nothing it sends
+  // over the link later will be earlier.
+  struct Channel {
+    uint32_t from;
+    SimTick clock;
+  };
+
+  // One outgoing link, to channel "channel" of LP "to"
+  struct OutLink {
+    LogicalProcess *to;
+    SimTick lookahead;
+    size_t channel;
+  };
+
+  // Declares a link from this LP to "to".
+  //
+  // "to" - the receiving LP
+  // "lookahead" - least delay between this LP's clock and any event sent
+  void AddOutLink(LogicalProcess *to, SimTick lookahead);
+
+  // Called by the sending LP, on its own thread.  Adds a message to the
+  // inbox, and raises the channel's clock to "promise".
+  //
+  // "channel" - index of the sender's channel
+  // "message" - the event sent, or nullptr for a null message
+  // "promise" - lower bound on anything sent later over the channel
+  // Returns - "true" if the channel's clock was raised
+  bool Deliver(size_t channel, SimBaseEvent *message, SimTick promise);
+
+  // Moves the messages in the inbox to the pending event set.
+  //
+  // "version" - receives the inbox version that was drained, for
+  //       WaitForInbox()
+  // Returns - the least channel clock, or "kNever" if there are no
+  //       incoming links
+  SimTick DrainInbox(uint64_t *version);
+
+  // Blocks until the inbox changes from "version".
+  //
+  // "version" - the version returned by DrainInbox()
+  void WaitForInbox(uint64_t version);
+
+  // Dispatches the pending events earlier than "safe", up to and including
+  // "end".
+  //
+  // "safe" - no message earlier than this can still arrive
+  // "end" - time at which the run ends
+  void DispatchUntil(SimTick safe, SimTick end);
+
+  // Returns - the time of the earliest pending event, or "kNever"
+  SimTick NextEventTicks() const;
+
+  // Promises every receiving LP that nothing will be sent earlier than
+  // "bound" plus the link's lookahead.
+  //
+  // "bound" - no event earlier than this will be dispatched by this LP
+  // Returns - the number of null messages that raised a channel clock
+  uint64_t PromiseAll(SimTick bound);
+
+  // Index of this LP in its executive
+  uint32_t id_;
+  // Time of the most recently dispatched event
+  SimTime curr_time_;
+  // Events waiting to be dispatched by this LP
+  PendingEventSet *event_queue_;
+  uint64_t dispatched_count_;
+
+  // Outgoing links, and the index in "out_links_" of the link to each LP,
+  // or -1 if there is none
+  std::vector<OutLink> out_links_;
+  std::vector<int> out_index_;
+
+  // The inbox, guarded by "inbox_mutex_".  "inbox_version_" changes with
+  // every message.
+  std::mutex inbox_mutex_;
+  std::condition_variable inbox_changed_;
+  std::vector<Channel> channels_;
+  std::vector<SimBaseEvent *> inbox_;
+  uint64_t inbox_version_;
+  // Scratch space for draining the inbox, kept to avoid allocating
+  std::vector<SimBaseEvent *> drained_;
+
+  // The LP dispatching events on the calling thread
+  static thread_local LogicalProcess *current_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(LogicalProcess);
+}; // class LogicalProcess
+
+#endif   // SIM_DESIM_LOGICAL_PROCESS_HPP_
@@ -0,0 +1,78 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the factory for the pending event set implementations of the
+*     Discrete Event Simulation system, along with the default batch push.
+*     This is the one place that needs to change when a new
+*     PendingEventSet implementation is added.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <string>
+
+#include "pending_event_set.hpp"
+#include "calendar_queue.hpp"
+#include "event_heap.hpp"
+#include "event_list.hpp"
+#include "ladder_queue.hpp"
+#include "radix_heap.hpp"
+#include "timing_wheel.hpp"
+
+// Names starting with this put a timing wheel in front of the named set
+static const std::string kWheelPrefix("WHEEL+");
+
+
+// Creates a new, empty, event set of the kind specified by "name".
+//
+// "name" - upper case name of the implementation
+// Returns - a pointer to the new event set, or nullptr if "name" is not
+//       recognized.
+PendingEventSet *PendingEventSet::NewEventSet(const std::string &name) {
+  PendingEventSet *event_set = nullptr;
+  if (name == "HEAP") {
+    event_set = new EventHeap;
+  } else if (name == "LIST") {
+    event_set = new EventList;
+  } else if (name == "CALENDAR") {
+    event_set = new CalendarQueue;
+  } else if (name == "LADDER") {
+    event_set = new LadderQueue;
+  } else if (name == "RADIX") {
+    event_set = new RadixHeap;
+  } else if (name == "WHEEL") {
+    event_set = new TimingWheel(new EventHeap);
+  } else if (name.compare(0, kWheelPrefix.size(), kWheelPrefix) == 0) {
+    // Timing wheel in front of any other set, e.g. "WHEEL+LADDER"
+    PendingEventSet *overflow =
+        NewEventSet(name.substr(kWheelPrefix.size()));
+    if (overflow != nullptr) {
+      event_set = new TimingWheel(overflow);
+    }
+  }
+  return event_set;
+}
+
+
+// Pushes the events one at a time, in batch order.
+//
+// "events" - the events to place in the set
+void PendingEventSet::PushBatch(const std::vector<SimBaseEvent *> &events) {
+  for (SimBaseEvent *event : events) {
+    Push(event);
+  }
+}
+
+
+// Returns - the names accepted by NewEventSet().  The first name is the
+//       default used by the simulation executive.
+std::string PendingEventSet::KnownNames() {
+  return "HEAP, LIST, CALENDAR, LADDER, RADIX, WHEEL, WHEEL+<name>";
+}
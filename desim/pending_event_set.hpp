@@ -0,0 +1,124 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the pending event set interface for the
+*     Discrete Event Simulation system.
+*     The pending event set is the time ordered collection of events
+*     that the simulation executive has yet to dispatch.  PendingEventSet
+*     is a pure virtual base class, so that the data structure can be
+*     chosen to suit the workload.  Every implementation must remove
+*     events in time order and, among events with the same time, in the
+*     order in which they were pushed (FIFO).
+*
+*     PendingEventSet::NewEventSet() creates an implementation by name,
+*     which lets executables select the data structure at startup.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_PENDING_EVENT_SET_HPP_
+#define SIM_DESIM_PENDING_EVENT_SET_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_base_event.hpp"
+
+
+class PendingEventSet {
+ public:
+  PendingEventSet() { };
+  virtual ~PendingEventSet() { };
+
+  // Creates a new, empty, event set of the kind specified by "name".  The
+  // caller is responsible for the memory of the returned object.
+  //
+  // "name" - upper case name of the implementation, as listed by
+  //       KnownNames().
+  // Returns - a pointer to the new event set, or nullptr if "name" is not
+  //       recognized.
+  static PendingEventSet *NewEventSet(const std::string &name);
+
+  // Returns - a comma separated list of the names accepted by
+  //       NewEventSet(), suitable for help and error messages.
+  static std::string KnownNames();
+
+  // Adds an event to the set.  The caller remains responsible for the
+  // memory of the event, except as noted for Clear().
+  //
+  // "new_event" - the event to place in the set
+  virtual void Push(SimBaseEvent *new_event) = 0;
+
+  // Adds a batch of events to the set in one call.  The result is the same
+  // as pushing each event in turn, so events with the same time are
+  // removed in batch order, after any already in the set.  The default
+  // does just that.  Implementations whose single pushes are expensive
+  // override it to merge the whole batch in one pass.
+  //
+  // "events" - the events to place in the set, in any time order
+  virtual void PushBatch(const std::vector<SimBaseEvent *> &events);
+
+  // Removes the earliest event from the set.  Among events with the same
+  // time, the event that was pushed first is removed first.
+  // NOTE: The result of calling this method on an empty set is undefined,
+  // so always check for emptiness first.
+  //
+  // Returns - the earliest event
+  virtual SimBaseEvent *PopMin() = 0;
+
+  // Returns - the event that PopMin() would remove, without removing it.
+  //       As with PopMin(), the set must not be empty.  Not const, since
+  //       some implementations reorganize themselves to find the minimum.
+  virtual SimBaseEvent *PeekMin() = 0;
+
+  // Removes "event" from the set, without deleting it.  The order of the
+  // remaining events is unchanged.  Used by the executive to cancel and
+  // reschedule events, so implementations should locate the event from its
+  // time, or from bookkeeping kept in the event, rather than by searching
+  // the whole set.
+  //
+  // "event" - the event to remove
+  // Returns - "true" if the event was found and removed, "false" if it
+  //       is not in the set.
+  virtual bool Remove(SimBaseEvent *event) = 0;
+
+  // Returns - the number of events in the set
+  virtual size_t Size() const = 0;
+
+  // Returns - "true" if there are no events in the set, "false" otherwise
+  bool Empty() const { return Size() == 0; };
+
+  // Copies the events in the set, in dispatch order, into "events".  The
+  // set is not modified.  Intended for debug dumps, not for the dispatch
+  // loop.
+  //
+  // "events" - receives the ordered events.  Any previous contents are
+  //       discarded.
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const = 0;
+
+  // Removes and deletes every event in the set.  The executive uses this
+  // to dispose of events that will never be dispatched, and it is the
+  // only case in which the set deletes events itself.
+  virtual void Clear() = 0;
+
+  // Empties the set without deleting, or even looking at, the events.
+  // Used when the events' memory is about to be released wholesale, e.g.
+  // with an EventArena, so no per-event work is wanted.  The events must
+  // not be used afterwards.
+  virtual void Discard() = 0;
+
+ private:
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(PendingEventSet);
+}; // class PendingEventSet
+
+#endif   // SIM_DESIM_PENDING_EVENT_SET_HPP_
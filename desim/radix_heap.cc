@@ -0,0 +1,205 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the radix heap pending event set for the Discrete Event
+*     Simulation system.  See radix_heap.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "radix_heap.hpp"
+
+const size_t RadixHeap::kBucketCount;
+
+// Keys start at zero, the earliest possible time, so any first key is
+// acceptable.
+RadixHeap::RadixHeap() : buckets_(kBucketCount), first_head_(0),
+                         last_key_(0), size_(0) {
+}
+
+
+// The heap doesn't own the events, so there is nothing to clean up
+// beyond the buckets.
+RadixHeap::~RadixHeap() {
+}
+
+
+// Appends the event to its bucket.  Keys earlier than "last_key_" should
+// not arrive from the executive, but they are handled by rebuilding the
+// buckets around the new key.
+//
+// "new_event" - the event to place in the heap
+void RadixHeap::Push(SimBaseEvent *new_event) {
+  const SimTime::SimTick key = new_event->event_time().ticks();
+  if (key < last_key_) {
+    Rebase(key);
+  }
+  Entry entry = {key, new_event};
+  Place(entry);
+  ++size_;
+}
+
+
+// Returns - the earliest event, from the front of bucket 0
+SimBaseEvent *RadixHeap::PopMin() {
+  FillFirstBucket();
+  SimBaseEvent *min_event = buckets_[0][first_head_++].event;
+  --size_;
+  return min_event;
+}
+
+
+// Returns - the earliest event, without removing it.
+SimBaseEvent *RadixHeap::PeekMin() {
+  FillFirstBucket();
+  return buckets_[0][first_head_].event;
+}
+
+
+// An event's key determines its bucket, and the event records its
+// position there, so nothing is searched.  The entry is left as a hole,
+// which keeps the order of the entries that remain without moving any of
+// them.
+//
+// "event" - the event to remove
+// Returns - "true" if the event was in the heap
+bool RadixHeap::Remove(SimBaseEvent *event) {
+  const SimTime::SimTick key = event->event_time().ticks();
+  if (key < last_key_) {
+    return false;
+  }
+  const size_t index = BucketIndex(key);
+  const size_t position = event->heap_index_;
+  Bucket &bucket = buckets_[index];
+  if (((index == 0) && (position < first_head_)) ||
+      (position >= bucket.size()) || (bucket[position].event != event)) {
+    return false;
+  }
+  bucket[position].event = nullptr;
+  --size_;
+  return true;
+}
+
+
+// Gathers the buckets, less any holes, then sorts on the key.  Events
+// with the same key share a bucket in FIFO order, and the sort is stable,
+// so FIFO order is preserved.
+//
+// "events" - receives the ordered events.
+void RadixHeap::OrderedEvents(std::vector<SimBaseEvent *> *events) const {
+  std::vector<Entry> entries(buckets_[0].begin() + first_head_,
+                             buckets_[0].end());
+  entries.reserve(size_);
+  for (size_t i = 1; i < kBucketCount; ++i) {
+    entries.insert(entries.end(), buckets_[i].begin(), buckets_[i].end());
+  }
+  entries.erase(std::remove_if(entries.begin(), entries.end(), IsHole),
+                entries.end());
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry &left, const Entry &right) {
+                     return left.key < right.key;
+                   });
+  events->clear();
+  events->reserve(entries.size());
+  for (const Entry &entry : entries) {
+    events->push_back(entry.event);
+  }
+}
+
+
+// Deletes every event and returns the heap to its initial state.  Holes
+// are nullptr, which delete ignores.
+void RadixHeap::Clear() {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    for (size_t j = (i == 0) ? first_head_ : 0; j < buckets_[i].size(); ++j) {
+      delete buckets_[i][j].event;
+    }
+  }
+  Discard();
+}
+
+
+// Empties the buckets without touching the events.
+void RadixHeap::Discard() {
+  for (Bucket &bucket : buckets_) {
+    bucket.clear();
+  }
+  first_head_ = 0;
+  last_key_ = 0;
+  size_ = 0;
+}
+
+
+// When bucket 0 runs dry, the lowest bucket with an event in it holds the
+// earliest key.  That key becomes "last_key_", and the rest of the bucket
+// is redistributed.  Every entry lands in a lower bucket, since it now
+// shares more high bits with "last_key_", which is what bounds the total
+// work.  Holes are dropped along the way.
+void RadixHeap::FillFirstBucket() {
+  Bucket &first = buckets_[0];
+  while ((first_head_ < first.size()) && IsHole(first[first_head_])) {
+    ++first_head_;
+  }
+  if (first_head_ < first.size()) {
+    return;
+  }
+  first.clear();
+  first_head_ = 0;
+  size_t index = 1;
+  bool found = false;
+  SimTime::SimTick min_key = 0;
+  while (!found) {
+    for (const Entry &entry : buckets_[index]) {
+      if (!IsHole(entry) && (!found || (entry.key < min_key))) {
+        min_key = entry.key;
+        found = true;
+      }
+    }
+    if (!found) {
+      buckets_[index++].clear();
+    }
+  }
+  last_key_ = min_key;
+  // Entries are moved in order, so same key entries stay FIFO
+  Bucket &bucket = buckets_[index];
+  for (const Entry &entry : bucket) {
+    if (!IsHole(entry)) {
+      Place(entry);
+    }
+  }
+  bucket.clear();
+}
+
+
+// Collects every entry in dispatch order, so far as the buckets know it,
+// then re-inserts them around "new_last_key".  Same key entries are in a
+// single bucket, in FIFO order, and are collected in that order.
+//
+// "new_last_key" - the new, earlier, "last_key_"
+void RadixHeap::Rebase(SimTime::SimTick new_last_key) {
+  std::vector<Entry> entries(buckets_[0].begin() + first_head_,
+                             buckets_[0].end());
+  entries.reserve(size_);
+  for (size_t i = 1; i < kBucketCount; ++i) {
+    entries.insert(entries.end(), buckets_[i].begin(), buckets_[i].end());
+  }
+  for (Bucket &bucket : buckets_) {
+    bucket.clear();
+  }
+  first_head_ = 0;
+  last_key_ = new_last_key;
+  for (const Entry &entry : entries) {
+    if (!IsHole(entry)) {
+      Place(entry);
+    }
+  }
+}
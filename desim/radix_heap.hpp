@@ -0,0 +1,118 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the radix heap pending event set for the
+*     Discrete Event Simulation system.
+*     RadixHeap is a monotone priority queue keyed directly on the SimTick
+*     count of each event.  It relies on the simulation executive's refusal
+*     to schedule events in the past: keys pushed are never earlier than
+*     the key most recently removed.  Given that, each event is kept in
+*     one of 65 buckets, chosen by the highest bit in which its key
+*     differs from the last key removed.  An event only ever moves to
+*     lower buckets, so insertion is O(1) and removal is amortized
+*     O(log C), where C is the span of pending times in ticks, with
+*     nothing more than integer compares along the way.
+*
+*     Each event records its position in its bucket, so removing an
+*     arbitrary event is O(1): its entry is left as a hole, which is
+*     dropped when the bucket is next emptied.
+*
+*     Events with the same time always share a bucket, and are kept in the
+*     order in which they were pushed (FIFO).
+*
+*     Pushing an event earlier than the last one removed is still handled
+*     correctly, but it costs O(n), since every bucket has to be rebuilt.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_RADIX_HEAP_HPP_
+#define SIM_DESIM_RADIX_HEAP_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+
+
+class RadixHeap : public PendingEventSet {
+ public:
+  RadixHeap();
+  virtual ~RadixHeap();
+
+  // PendingEventSet interface.  See pending_event_set.hpp for details.
+  virtual void Push(SimBaseEvent *new_event);
+  virtual SimBaseEvent *PopMin();
+  virtual SimBaseEvent *PeekMin();
+  virtual bool Remove(SimBaseEvent *event);
+  virtual size_t Size() const { return size_; }
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const;
+  virtual void Clear();
+  virtual void Discard();
+
+ private:
+  // Each entry caches the key alongside the event pointer, so that
+  // finding the minimum key never has to dereference the events.  A
+  // removed event leaves a hole, an entry whose "event" is nullptr.
+  struct Entry {
+    SimTime::SimTick key;
+    SimBaseEvent *event;
+  };
+  typedef std::vector<Entry> Bucket;
+
+  // Returns - "true" if "entry" is a hole left by Remove()
+  static bool IsHole(const Entry &entry) { return entry.event == nullptr; }
+
+  // One bucket for keys equal to "last_key_", and one for each bit in
+  // which a key can differ from it.
+  static const size_t kBucketCount = 65;
+
+  // Returns - the bucket for "key": 0 if it equals "last_key_", otherwise
+  //       one more than the index of the highest bit that differs.
+  size_t BucketIndex(SimTime::SimTick key) const {
+    return (key == last_key_) ? 0 : 64 - __builtin_clzll(key ^ last_key_);
+  }
+
+  // Makes sure the events with the earliest key are in bucket 0, and
+  // that the entry at "first_head_" isn't a hole.  The heap must not be
+  // empty.
+  void FillFirstBucket();
+
+  // Appends "entry" to the bucket for its key, recording its position in
+  // the event.
+  void Place(const Entry &entry) {
+    Bucket &bucket = buckets_[BucketIndex(entry.key)];
+    entry.event->heap_index_ = bucket.size();
+    bucket.push_back(entry);
+  }
+
+  // Rebuilds every bucket around a new, earlier, "last_key_".  Used when
+  // a push breaks the monotone key invariant.
+  //
+  // "new_last_key" - the earlier key
+  void Rebase(SimTime::SimTick new_last_key);
+
+  // The buckets.  Bucket 0 is consumed from "first_head_" forward, the
+  // others are only ever appended to and emptied whole.
+  std::vector<Bucket> buckets_;
+  size_t first_head_;
+  // Key of the event most recently moved into bucket 0
+  SimTime::SimTick last_key_;
+  // Number of events in the heap
+  size_t size_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(RadixHeap);
+}; // class RadixHeap
+
+#endif   // SIM_DESIM_RADIX_HEAP_HPP_
@@ -0,0 +1,127 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the one way channel, in POSIX shared memory,
+*     between two logical processes that run in separate processes, for
+*     the Discrete Event Simulation system.  See shm_exec.hpp.
+*
+*     A ShmChannel is a single producer / single consumer ring of fixed
+*     size slots, each holding one serialized event, plus the sender's
+*     promise: the least time of anything it will send over the channel
+*     later.  The promise is how null messages travel: the sender just
+*     raises it, without using a slot.  The sender only ever writes the
+*     push position and the promise, and the receiver only the pop
+*     position, so neither ever waits on a lock.  The positions are
+*     lock-free atomics, which work the same between processes as between
+*     threads.
+*
+*     A channel lives in a shared memory segment, not on the heap, so it
+*     is never constructed: the segment is created zero filled, which is a
+*     valid, empty channel with a promise of zero.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_SHM_CHANNEL_HPP_
+#define SIM_DESIM_SHM_CHANNEL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "basic_defs.hpp"
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Shared memory channels need lock-free 64 bit atomics");
+
+
+class ShmChannel {
+ public:
+  // Events the channel holds at once
+  static const size_t kSlotCount = 1024;
+  // Largest serialized event, not counting its time and type id
+  static const size_t kMaxPayload = 232;
+
+  // One serialized event
+  struct Slot {
+    uint64_t ticks;
+    uint16_t type_id;
+    uint16_t unused;
+    uint32_t size;
+    char payload[kMaxPayload];
+  };
+
+  // Sender side.
+  //
+  // Returns - the slot to fill, or nullptr if the channel is full.  The
+  //       slot is only sent by EndPush().
+  Slot *BeginPush() {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == kSlotCount) {
+      return nullptr;
+    }
+    return &slots_[head % kSlotCount];
+  }
+  // Sends the slot filled after BeginPush().
+  void EndPush() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  // Raises the promise.  Sender side.
+  //
+  // "ticks" - nothing sent later will be earlier than this
+  // Returns - "true" if the promise was raised
+  bool Promise(uint64_t ticks) {
+    if (ticks <= promise_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    promise_.store(ticks, std::memory_order_release);
+    return true;
+  }
+
+  // Receiver side.  Read the promise before popping: every event sent
+  // before the promise was raised is then sure to be seen.
+  //
+  // Returns - the sender's promise
+  uint64_t promise() const {
+    return promise_.load(std::memory_order_acquire);
+  }
+  // Returns - the oldest event sent, or nullptr if there is none
+  const Slot *Front() const {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_.load(std::memory_order_acquire) == tail) {
+      return nullptr;
+    }
+    return &slots_[tail % kSlotCount];
+  }
+  // Frees the slot returned by Front().
+  void Pop() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+ private:
+  // Each position has a cache line to itself, so that the sender and the
+  // receiver don't contend for one.
+  std::atomic<uint64_t> promise_;
+  char pad_promise_[56];
+  std::atomic<uint64_t> head_;
+  char pad_head_[56];
+  std::atomic<uint64_t> tail_;
+  char pad_tail_[56];
+  Slot slots_[kSlotCount];
+
+  // Never constructed, see above
+  ShmChannel();
+  DISALLOW_COPY_AND_ASSIGN(ShmChannel);
+}; // class ShmChannel
+
+#endif   // SIM_DESIM_SHM_CHANNEL_HPP_
@@ -0,0 +1,312 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the multiple process conservative executive for the Discrete
+*     Event Simulation system.  See shm_exec.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "shm_exec.hpp"
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+#include "pending_event_set.hpp"
+
+thread_local ShmExec *ShmExec::current_ = nullptr;
+
+// The segment starts with a header, on a cache line of its own, followed
+// by the channels, "from" major.
+struct ShmSegmentHeader {
+  uint64_t magic;
+  uint32_t lp_count;
+};
+const uint64_t kShmSegmentMagic = 0x4445534D53484D31ULL;
+const size_t kShmHeaderSize = 64;
+// Passes without progress before an idle LP starts to sleep
+const unsigned kShmSpinPasses = 64;
+
+// Returns - the size of the segment for "lp_count" LPs
+static size_t ShmSegmentSize(uint32_t lp_count) {
+  return kShmHeaderSize +
+         static_cast<size_t>(lp_count) * lp_count * sizeof(ShmChannel);
+}
+
+
+// The segment is created exclusively, after removing any stale one, so
+// that no process can see a half written header from an earlier run.
+//
+// "segment_name" - POSIX shared memory name
+// "lp_count" - number of LPs, at least one
+// Returns - "true" if the segment was created
+bool ShmExec::CreateSegment(const std::string &segment_name,
+                            uint32_t lp_count) {
+  if (lp_count == 0) {
+    UtilStdMsg(kCommonStrError, "ShmExec needs at least one LP.");
+    return false;
+  }
+  shm_unlink(segment_name.c_str());
+  const int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR,
+                          0600);
+  if (fd < 0) {
+    UtilStdMsg(kCommonStrError, "Unable to create shared memory segment \"" +
+                                segment_name + "\": " + strerror(errno));
+    return false;
+  }
+  // ftruncate() zero fills, which is what makes every channel empty
+  const size_t size = ShmSegmentSize(lp_count);
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    UtilStdMsg(kCommonStrError, "Unable to size shared memory segment \"" +
+                                segment_name + "\": " + strerror(errno));
+    close(fd);
+    shm_unlink(segment_name.c_str());
+    return false;
+  }
+  void *segment = mmap(nullptr, kShmHeaderSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    UtilStdMsg(kCommonStrError, "Unable to map shared memory segment \"" +
+                                segment_name + "\": " + strerror(errno));
+    shm_unlink(segment_name.c_str());
+    return false;
+  }
+  ShmSegmentHeader *header = static_cast<ShmSegmentHeader *>(segment);
+  header->lp_count = lp_count;
+  header->magic = kShmSegmentMagic;
+  munmap(segment, kShmHeaderSize);
+  return true;
+}
+
+
+// "segment_name" - POSIX shared memory name
+void ShmExec::RemoveSegment(const std::string &segment_name) {
+  shm_unlink(segment_name.c_str());
+}
+
+
+// "segment_name" - POSIX shared memory name
+// "id" - index of this process's LP
+// "lookahead" - least delay for events sent to other LPs
+// "event_set_name" - name of the LP's pending event set
+ShmExec::ShmExec(const std::string &segment_name, uint32_t id,
+                 SimTime::UserTime lookahead,
+                 const std::string &event_set_name)
+    : id_(id), lp_count_(0), lookahead_(SimTime(lookahead).ticks()),
+      lp_(nullptr), segment_(nullptr), segment_size_(0),
+      end_(LogicalProcess::kNever), sent_count_(0), received_count_(0),
+      null_messages_(0) {
+  if (lookahead_ == 0) {
+    UtilFatalErrorAndDie("ShmExec needs a positive lookahead.");
+  }
+  const int fd = shm_open(segment_name.c_str(), O_RDWR, 0600);
+  struct stat segment_stat;
+  if ((fd < 0) || (fstat(fd, &segment_stat) != 0) ||
+      (static_cast<size_t>(segment_stat.st_size) < kShmHeaderSize)) {
+    UtilFatalErrorAndDie("Unable to open shared memory segment \"" +
+                         segment_name + "\".");
+  }
+  segment_size_ = static_cast<size_t>(segment_stat.st_size);
+  segment_ = mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment_ == MAP_FAILED) {
+    UtilFatalErrorAndDie("Unable to map shared memory segment \"" +
+                         segment_name + "\": " + strerror(errno));
+  }
+  const ShmSegmentHeader *header =
+      static_cast<const ShmSegmentHeader *>(segment_);
+  lp_count_ = header->lp_count;
+  if ((header->magic != kShmSegmentMagic) ||
+      (segment_size_ != ShmSegmentSize(lp_count_)) || (id_ >= lp_count_)) {
+    std::stringstream message;
+    message << "Shared memory segment \"" << segment_name << "\" is not a "
+               "ShmExec segment, or has no LP " << id_ << ".";
+    UtilFatalErrorAndDie(message.str());
+  }
+  PendingEventSet *event_set = PendingEventSet::NewEventSet(event_set_name);
+  if (event_set == nullptr) {
+    UtilFatalErrorAndDie("Unknown pending event set: \"" + event_set_name +
+                         "\".\nKnown sets: " +
+                         PendingEventSet::KnownNames());
+  }
+  // The LP has no links of its own: the channels take their place
+  lp_ = new LogicalProcess(id_, lp_count_, event_set);
+}
+
+
+ShmExec::~ShmExec() {
+  delete lp_;
+  munmap(segment_, segment_size_);
+}
+
+
+// "to" - index of the receiving LP
+// "type_id" - the event's "kEventTypeId"
+// "new_event" - the event to send
+// Returns - "true" if the event was sent
+bool ShmExec::SendTyped(uint32_t to, uint16_t type_id,
+                        SimBaseEvent *new_event) {
+  if (to == id_) {
+    return lp_->ScheduleEvent(new_event);
+  }
+  const SimTick event_ticks = new_event->event_time().ticks();
+  if (to >= lp_count_) {
+    std::cerr << kCommonStrError << "LP " << id_ << " attempted to send "
+                 "event to LP " << to << ", which doesn't exist."
+              << std::endl;
+    delete new_event;
+    return false;
+  }
+  if (event_ticks < lp_->curr_time().ticks() + lookahead_) {
+    std::cerr << kCommonStrError << "LP " << id_ << " attempted to send "
+                 "event within the lookahead.  Event Time: "
+              << new_event->event_time().GetUserTime()
+              << " Current LP Time: " << lp_->curr_time().GetUserTime()
+              << std::endl;
+    delete new_event;
+    return false;
+  }
+  if (event_ticks > end_) {
+    // Never dispatched, and the receiver may already be done, so it
+    // mustn't take up a slot
+    delete new_event;
+    return true;
+  }
+  ShmChannel *channel = Channel(id_, to);
+  ShmChannel::Slot *slot = channel->BeginPush();
+  while (slot == nullptr) {
+    DrainChannels();
+    std::this_thread::yield();
+    slot = channel->BeginPush();
+  }
+  size_t size = 0;
+  if (!new_event->Serialize(slot->payload, ShmChannel::kMaxPayload, &size) ||
+      (size > ShmChannel::kMaxPayload)) {
+    std::cerr << kCommonStrError << "LP " << id_ << " could not serialize "
+                 "event of type " << type_id << " to send to LP " << to
+              << std::endl;
+    delete new_event;
+    return false;
+  }
+  slot->ticks = event_ticks;
+  slot->type_id = type_id;
+  slot->size = static_cast<uint32_t>(size);
+  channel->EndPush();
+  ++sent_count_;
+  delete new_event;
+  return true;
+}
+
+
+// "run_until_tm" - time at which the run ends
+// Returns - the time when this LP's run ended
+SimTime ShmExec::Run(const SimTime &run_until_tm) {
+  current_ = this;
+  LogicalProcess::current_ = lp_;
+  end_ = run_until_tm.ticks();
+  unsigned idle_passes = 0;
+  for (;;) {
+    const uint64_t dispatched = lp_->dispatched_count();
+    const uint64_t received = received_count_;
+    const SimTick safe = DrainChannels();
+    lp_->DispatchUntil(safe, end_);
+    if (safe > end_) {
+      break;
+    }
+    const SimTick next = lp_->NextEventTicks();
+    const bool promised = PromiseAll((next < safe) ? next : safe);
+    // Unlike ConservativeExec, there is nothing to block on, so an LP
+    // that is waiting on its senders polls, backing off to short sleeps
+    if (promised || (dispatched != lp_->dispatched_count()) ||
+        (received != received_count_)) {
+      idle_passes = 0;
+    } else if (++idle_passes < kShmSpinPasses) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  PromiseAll(LogicalProcess::kNever);
+  LogicalProcess::current_ = nullptr;
+  current_ = nullptr;
+  const SimTime last_time = lp_->curr_time();
+  return last_time.AsEarlyAs(run_until_tm) ? last_time : run_until_tm;
+}
+
+
+// "from" / "to" - indices of the sending and receiving LPs
+// Returns - the channel from LP "from" to LP "to"
+ShmChannel *ShmExec::Channel(uint32_t from, uint32_t to) {
+  ShmChannel *channels = reinterpret_cast<ShmChannel *>(
+      static_cast<char *>(segment_) + kShmHeaderSize);
+  return &channels[static_cast<size_t>(from) * lp_count_ + to];
+}
+
+
+// Each channel's promise is read before its slots, so that every event
+// sent before the promise was made is taken in along with it.
+//
+// Returns - the least promise of the other LPs, or "kNever"
+ShmExec::SimTick ShmExec::DrainChannels() {
+  SimTick safe = LogicalProcess::kNever;
+  for (uint32_t from = 0; from < lp_count_; ++from) {
+    if (from == id_) {
+      continue;
+    }
+    ShmChannel *channel = Channel(from, id_);
+    const SimTick promise = channel->promise();
+    safe = (promise < safe) ? promise : safe;
+    for (const ShmChannel::Slot *slot = channel->Front(); slot != nullptr;
+         slot = channel->Front()) {
+      auto factory = factories_.find(slot->type_id);
+      if (factory == factories_.end()) {
+        std::stringstream message;
+        message << "LP " << id_ << " received event of unregistered type "
+                << slot->type_id << " from LP " << from << ".";
+        UtilFatalErrorAndDie(message.str());
+      }
+      SimBaseEvent *received = factory->second(
+          SimTime::FromTicks(slot->ticks), slot->payload, slot->size);
+      channel->Pop();
+      if (received != nullptr) {
+        lp_->ScheduleEvent(received);
+        ++received_count_;
+      }
+    }
+  }
+  return safe;
+}
+
+
+// "bound" - no event earlier than this will be dispatched by this LP
+// Returns - "true" if any promise was raised
+bool ShmExec::PromiseAll(SimTick bound) {
+  const SimTick promise = (bound > LogicalProcess::kNever - lookahead_) ?
+                          LogicalProcess::kNever : bound + lookahead_;
+  bool raised = false;
+  for (uint32_t to = 0; to < lp_count_; ++to) {
+    if ((to != id_) && Channel(id_, to)->Promise(promise)) {
+      ++null_messages_;
+      raised = true;
+    }
+  }
+  return raised;
+}
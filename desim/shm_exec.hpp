@@ -0,0 +1,199 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the multiple process conservative executive
+*     for the Discrete Event Simulation system.
+*     ShmExec runs one logical process (see LogicalProcess) of a model
+*     whose LPs are spread over separate processes on one Linux host, so
+*     that a model can use the memory bandwidth of more than one socket.
+*     The LPs exchange events through a POSIX shared memory segment that
+*     holds a ShmChannel for every ordered pair of LPs.  Events are
+*     serialized into the channel with SimBaseEvent::Serialize(), and
+*     rebuilt on the far side by the Deserialize() of their type, which
+*     each process registers by type id.
+*
+*     The LPs are kept in step as with ConservativeExec: an LP dispatches
+*     its events earlier than the least promise of its senders, and
+*     promises its receivers its next event time (or its safe time, if
+*     that is earlier) plus the lookahead.  Every pair of LPs is linked,
+*     with the same lookahead.
+*
+*     The segment is created before the processes start, typically by
+*     ShmLauncher, which also forks and pins the processes.  Each process
+*     then creates its ShmExec for its own LP, schedules its initial
+*     events on lp(), registers the event types it may receive, and calls
+*     Run().  Events for the same LP are scheduled on the LP, as usual;
+*     events for other LPs are sent with ShmExec::current()->SendEvent().
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_SHM_EXEC_HPP_
+#define SIM_DESIM_SHM_EXEC_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "logical_process.hpp"
+#include "shm_channel.hpp"
+
+
+class ShmExec {
+ public:
+  typedef LogicalProcess::SimTick SimTick;
+  // Rebuilds an event from what its Serialize() wrote.  The caller takes
+  // responsibility for the new event.
+  typedef SimBaseEvent *(*EventFactory)(const SimTime &event_time,
+                                        const char *payload, size_t size);
+
+  // Creates the shared memory segment for a run, replacing any left over
+  // from an earlier one.  Called once, before any process creates its
+  // ShmExec.
+  //
+  // "segment_name" - POSIX shared memory name, e.g. "/desim_run"
+  // "lp_count" - number of LPs, at least one
+  // Returns - "true" if the segment was created.  An error message is
+  //       printed if it wasn't.
+  static bool CreateSegment(const std::string &segment_name,
+                            uint32_t lp_count);
+  // Removes the segment, once every process is done with it.
+  //
+  // "segment_name" - POSIX shared memory name
+  static void RemoveSegment(const std::string &segment_name);
+
+  // Opens the segment, and creates this process's LP.  A fatal error is
+  // generated if the segment can't be opened, "id" isn't one of its LPs,
+  // the lookahead isn't positive, or "event_set_name" is not recognized.
+  //
+  // "segment_name" - POSIX shared memory name, as created above
+  // "id" - index of this process's LP
+  // "lookahead" - least delay between the sender's current time and the
+  //       time of any event it sends to another LP
+  // "event_set_name" - name of the LP's pending event set, as known to
+  //       PendingEventSet::NewEventSet()
+  ShmExec(const std::string &segment_name, uint32_t id,
+          SimTime::UserTime lookahead,
+          const std::string &event_set_name = "HEAP");
+  // Deletes the LP, and any events it still holds, and unmaps the
+  // segment.  Events still in the channels are left for the segment's
+  // removal.
+  ~ShmExec();
+
+  // Returns - index of this process's LP
+  uint32_t id() const { return id_; }
+  // Returns - the number of LPs, across every process
+  uint32_t lp_count() const { return lp_count_; }
+  // Returns - this process's LP, for scheduling the initial events
+  LogicalProcess *lp() { return lp_; }
+
+  // Lets this process receive events of "EventType", which must have a
+  // "kEventTypeId" that is unique among the types registered, and a
+  //   static SimBaseEvent *Deserialize(const SimTime &event_time,
+  //                                    const char *payload, size_t size);
+  // that rebuilds an event from what its Serialize() wrote.
+  template <class EventType>
+  void RegisterEventType() {
+    const uint16_t type_id = EventType::kEventTypeId;
+    factories_[type_id] = &EventType::Deserialize;
+  }
+
+  // Sends an event to an LP, which may be this one.  The event is
+  // serialized, and deleted, at once.  Events earlier than this LP's
+  // current time plus the lookahead, to an LP that doesn't exist, or that
+  // can't be serialized, are rejected with an error message, and deleted.
+  // Events later than the end of the run are never dispatched, so they
+  // are deleted without being sent.  If the channel is full, waits for
+  // the receiver, while taking in what is sent to this LP, so that LPs
+  // sending to each other can't deadlock.
+  //
+  // "to" - index of the receiving LP
+  // "new_event" - the event to send, of a type that the receiver
+  //       registered.  The executive takes responsibility for it.
+  // Returns - "true" if the event was sent
+  template <class EventType>
+  bool SendEvent(uint32_t to, EventType *new_event) {
+    return SendTyped(to, EventType::kEventTypeId, new_event);
+  }
+
+  // Runs this process's LP until every LP it hears from has promised
+  // nothing up to "run_until_tm".  As with SimExec, events later than
+  // "run_until_tm" are not dispatched.
+  //
+  // "run_until_tm" - time at which the run ends
+  // Returns - the time when this LP's run ended: the time of its last
+  //       event dispatched, or "run_until_tm", whichever is earlier.
+  SimTime Run(const SimTime &run_until_tm);
+
+  // Counters, for tuning.  Read them after the run.
+  //
+  // Returns - events sent to, and received from, other LPs
+  uint64_t sent_count() const { return sent_count_; }
+  uint64_t received_count() const { return received_count_; }
+  // Returns - promises that were raised without an event
+  uint64_t null_message_count() const { return null_messages_; }
+
+  // Returns - the executive running on the calling thread, or nullptr
+  static ShmExec *current() { return current_; }
+
+ private:
+  // Does the work of SendEvent(), once the type id is known.
+  //
+  // "to" - index of the receiving LP
+  // "type_id" - the event's "kEventTypeId"
+  // "new_event" - the event to send
+  // Returns - "true" if the event was sent
+  bool SendTyped(uint32_t to, uint16_t type_id, SimBaseEvent *new_event);
+
+  // Returns - the channel from LP "from" to LP "to"
+  ShmChannel *Channel(uint32_t from, uint32_t to);
+
+  // Takes in every event sent to this LP so far.
+  //
+  // Returns - the least promise of the other LPs, or "kNever" if there
+  //       are none
+  SimTick DrainChannels();
+
+  // Promises every other LP that nothing will be sent earlier than
+  // "bound" plus the lookahead.
+  //
+  // "bound" - no event earlier than this will be dispatched by this LP
+  // Returns - "true" if any promise was raised
+  bool PromiseAll(SimTick bound);
+
+  // Index of this process's LP, and the number of LPs
+  uint32_t id_;
+  uint32_t lp_count_;
+  SimTick lookahead_;
+  LogicalProcess *lp_;
+  // The mapped segment
+  void *segment_;
+  size_t segment_size_;
+  // End of the current run, in ticks.  Events sent for later are dropped.
+  SimTick end_;
+  // Rebuilds received events, by type id
+  std::unordered_map<uint16_t, EventFactory> factories_;
+
+  uint64_t sent_count_;
+  uint64_t received_count_;
+  uint64_t null_messages_;
+
+  // The executive running on the calling thread
+  static thread_local ShmExec *current_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(ShmExec);
+}; // class ShmExec
+
+#endif   // SIM_DESIM_SHM_EXEC_HPP_
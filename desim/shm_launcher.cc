@@ -0,0 +1,120 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the launcher for multiple process runs of the Discrete Event
+*     Simulation system.  See shm_launcher.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "shm_launcher.hpp"
+#include "shm_exec.hpp"
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+
+
+// Output is flushed before each fork, so that it isn't written once per
+// worker, and by each worker before it exits, since _exit() doesn't.
+// Workers are reaped in whatever order they exit.  A worker that fails
+// never promises the end of the run, so the others would wait for it
+// forever: the first failure kills every worker still running.
+//
+// "segment_name" - POSIX shared memory name for the run's segment
+// "lp_count" - number of LPs, and of worker processes
+// "pin" - "true" to pin each worker to a CPU
+// "worker" - called in each worker with the index of its LP
+// Returns - the number of workers that failed
+uint32_t ShmLauncher::Launch(const std::string &segment_name,
+                             uint32_t lp_count, bool pin,
+                             const std::function<int(uint32_t)> &worker) {
+  if (!ShmExec::CreateSegment(segment_name, lp_count)) {
+    return lp_count;
+  }
+  const long online = sysconf(_SC_NPROCESSORS_ONLN);
+  const uint32_t cpu_count = (online > 0) ? static_cast<uint32_t>(online) : 1;
+  std::vector<pid_t> workers;
+  uint32_t failed = 0;
+  // Set once the workers have been killed
+  bool stopped = false;
+  for (uint32_t id = 0; id < lp_count; ++id) {
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = fork();
+    if (pid == 0) {
+      if (pin) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(id % cpu_count, &cpus);
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+          UtilStdMsg(kCommonStrWarn, std::string("Unable to pin worker: ") +
+                                     strerror(errno));
+        }
+      }
+      const int status = worker(id);
+      std::cout.flush();
+      std::cerr.flush();
+      _exit(status);
+    }
+    if (pid < 0) {
+      UtilStdMsg(kCommonStrError, std::string("Unable to start worker: ") +
+                                  strerror(errno));
+      // The workers already started would wait for this LP forever
+      for (pid_t started : workers) {
+        kill(started, SIGKILL);
+      }
+      failed = lp_count - static_cast<uint32_t>(workers.size());
+      stopped = true;
+      break;
+    }
+    workers.push_back(pid);
+  }
+  while (!workers.empty()) {
+    int status = 0;
+    const pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // No children left to wait for, so the rest are lost
+      failed += static_cast<uint32_t>(workers.size());
+      break;
+    }
+    const std::vector<pid_t>::iterator worker_pid =
+        std::find(workers.begin(), workers.end(), pid);
+    if (worker_pid == workers.end()) {
+      // Another child of the caller's
+      continue;
+    }
+    workers.erase(worker_pid);
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+      if (!stopped) {
+        UtilStdMsg(kCommonStrError, "A worker failed, stopping the run.");
+        for (pid_t running : workers) {
+          kill(running, SIGKILL);
+        }
+        stopped = true;
+      }
+      ++failed;
+    }
+  }
+  ShmExec::RemoveSegment(segment_name);
+  return failed;
+}
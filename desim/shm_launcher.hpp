@@ -0,0 +1,61 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the launcher for multiple process runs of the
+*     Discrete Event Simulation system.  See shm_exec.hpp.
+*     ShmLauncher creates the shared memory segment for a run, forks one
+*     worker process per LP, optionally pins each worker to a CPU of its
+*     own, waits for them all, and removes the segment.  Each worker runs
+*     the function it is given, with the index of its LP, and exits with
+*     the function's result.
+*
+*     Since the workers are forked, they start with a copy of everything
+*     the parent set up before the launch, and share nothing with it, or
+*     with each other, apart from the segment.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_SHM_LAUNCHER_HPP_
+#define SIM_DESIM_SHM_LAUNCHER_HPP_
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+
+#include "basic_defs.hpp"
+
+
+class ShmLauncher {
+ public:
+  // Runs "worker" once per LP, each in a process of its own, and waits
+  // for them all.  If one fails, the rest are killed, rather than left
+  // waiting for it.  Any child of the caller may be reaped meanwhile, not
+  // only the workers.
+  //
+  // "segment_name" - POSIX shared memory name for the run's segment
+  // "lp_count" - number of LPs, and of worker processes
+  // "pin" - "true" to pin worker "id" to CPU "id", modulo the number of
+  //       CPUs online
+  // "worker" - called in each worker with the index of its LP.  Returns
+  //       the worker's exit status, zero for success.
+  // Returns - the number of workers that failed, including any killed,
+  //       or "lp_count" if the run couldn't be started
+  static uint32_t Launch(const std::string &segment_name, uint32_t lp_count,
+                         bool pin,
+                         const std::function<int(uint32_t)> &worker);
+
+ private:
+  // Static only
+  ShmLauncher();
+  DISALLOW_COPY_AND_ASSIGN(ShmLauncher);
+}; // class ShmLauncher
+
+#endif   // SIM_DESIM_SHM_LAUNCHER_HPP_
@@ -22,6 +22,19 @@
 
 #include "sim_base_event.hpp"
 
+const uint16_t SimBaseEvent::kUntypedEvent;
+const uint16_t SimBaseEvent::kFirstLibraryEventType;
+const uint64_t SimBaseEvent::kNoConflictKey;
+
+// "events" - the events to dispatch, in order, all of this type
+// "count" - the number of events
+void SimBaseEvent::DispatchBatch(const SimBaseEvent *const *events,
+                                 size_t count) const {
+  for (size_t i = 0; i < count; ++i) {
+    events[i]->Dispatch();
+  }
+}
+
 #ifdef TEST_HARNESS
   // Debug support for dumping the queue to std out.  Should never be present
   // in production code, but needed for test harness.
@@ -20,20 +20,115 @@
 #ifndef SIM_DESIM_SIM_BASE_EVENT_HPP_
 #define SIM_DESIM_SIM_BASE_EVENT_HPP_
 
+#include <stdint.h>
+#include <cstddef>
+
 #include "sim_time.hpp"
+#include "event_pool.hpp"
+#include "event_arena.hpp"
+
+class SimExec;
 
 class SimBaseEvent {
 // Generic base class for all events
  public:
+  // Type id of events that aren't in any EventRegistry
+  static const uint16_t kUntypedEvent = 0;
+  // Type ids from here up belong to the simulator's own event types.
+  // Applications number theirs from 1.
+  static const uint16_t kFirstLibraryEventType = 0xFF00;
+
   // "event_time" - time value specifying when the event is to be
   //       dispatched
-  SimBaseEvent(const SimTime &event_time) : event_time_(event_time) {};
+  SimBaseEvent(const SimTime &event_time) : event_time_(event_time),
+                                            handle_index_(0),
+                                            event_type_id_(kUntypedEvent),
+                                            batch_dispatch_(false),
+                                            heap_index_(0),
+                                            next_link_(nullptr),
+                                            prev_link_(nullptr) {};
   virtual ~SimBaseEvent() {};
 
+  // Events come from the EventPool, rather than the general purpose heap,
+  // since one is created and deleted for nearly every dispatch.  Derived
+  // classes inherit these, and the pool is given the size of the derived
+  // class.  While an EventArena is current, events come from the arena
+  // instead, and deleting one leaves its memory to be released with the
+  // arena.
+  static void *operator new(size_t size) {
+    EventArena *const arena = EventArena::current();
+    if (arena != nullptr) {
+      return arena->Allocate(size);
+    }
+    return EventPool::Allocate(size);
+  }
+  static void operator delete(void *memory, size_t size) {
+    EventArena *const arena = EventArena::current();
+    if ((arena != nullptr) && arena->Contains(memory)) {
+      return;
+    }
+    EventPool::Release(memory, size);
+  }
+
   // Called by dispatch loop as each event is executed from the event queue
   // NOTE:  This method MUST be redefined for all derived classes.
   virtual void Dispatch() const = 0;
 
+  // Called by the dispatch loop, instead of Dispatch(), for a run of
+  // events of a type that opts in to batch dispatch (see the protected
+  // ctor).  The run is every event at the current time, of the same type,
+  // that is next in the event queue.  "this" is the first of them.  The
+  // events must be dispatched in order, and, since they have all left the
+  // event queue already, their handles are stale.  The default dispatches
+  // each one in turn.
+  //
+  // "events" - the events to dispatch, in order, all of this type
+  // "count" - the number of events, at least one
+  virtual void DispatchBatch(const SimBaseEvent *const *events,
+                             size_t count) const;
+
+  // Called by SimExec::RunTyped() for each event type in its EventRegistry,
+  // as the run starts and again, with nullptr, as it finishes.  Registered
+  // types may hide this to look up what their Dispatch() needs once per
+  // run.  The default does nothing, so the executive is left unnamed.
+  static void BindToExec(SimExec *) {}
+
+  // Returns - the type id that an EventRegistry dispatches this event by,
+  //       or "kUntypedEvent"
+  uint16_t event_type_id() const { return event_type_id_; }
+
+  // Returns - "true" if runs of this event's type are passed to
+  //       DispatchBatch()
+  bool batch_dispatch() const { return batch_dispatch_; }
+
+  // Events that may touch any part of the model state
+  static const uint64_t kNoConflictKey = UINT64_MAX;
+
+  // Names the part of the model state, e.g. an entity or a resource, that
+  // the event changes.  When the executive has several dispatch threads
+  // (see SimExec::set_dispatch_threads()), same-time events with different
+  // keys may be dispatched in parallel, while events with the same key
+  // are dispatched one after another, in order, as they would be without
+  // the threads.  Derived classes override this to opt in.
+  //
+  // Returns - the conflict key, or "kNoConflictKey" to be dispatched with
+  //       no other event running
+  virtual uint64_t conflict_key() const { return kNoConflictKey; }
+
+  // Writes what a copy of the event needs, apart from its time and type
+  // id, so that it can be sent to an LP in another process (see
+  // ShmExec).  Types that can be sent override this, and provide a
+  // matching static Deserialize(), see ShmExec::RegisterEventType().
+  //
+  // "buffer" - where to write
+  // "capacity" - size of "buffer", in bytes
+  // "size" - receives the number of bytes written
+  // Returns - "false" if the event can't be sent.  The default writes
+  //       nothing, and returns "false", so its parameters are unnamed.
+  virtual bool Serialize(char *, size_t, size_t *) const {
+    return false;
+  }
+
   // Accessor for the event's time object
   //
   // Returns - this event's time value.  Note, this method returns a 
@@ -83,10 +178,48 @@ class SimBaseEvent {
   virtual void DumpEvent() const;
 #endif
  protected:
+  // For event types in an EventRegistry.
+  //
+  // "event_time" - time value specifying when the event is to be
+  //       dispatched
+  // "event_type_id" - the "kEventTypeId" of the derived class
+  // "batch_dispatch" - "true" to have runs of events of this type passed
+  //       to DispatchBatch().  The type's handlers must not cancel or
+  //       reschedule other events of the run, which have already left the
+  //       event queue by the time the run is dispatched.
+  SimBaseEvent(const SimTime &event_time, uint16_t event_type_id,
+               bool batch_dispatch = false)
+      : event_time_(event_time), handle_index_(0),
+        event_type_id_(event_type_id), batch_dispatch_(batch_dispatch),
+        heap_index_(0), next_link_(nullptr), prev_link_(nullptr) {};
+
   // Time at which event is scheduled.
   SimTime event_time_;
 
  private:
+  // Bookkeeping that lets a scheduled event be found again in O(1), and
+  // that lets the pending event sets hold events without allocating
+  // anything for each one.  The executive retimes events when they are
+  // rescheduled, so it also needs access to "event_time_".
+  friend class SimExec;
+  friend class EventHeap;
+  friend class LadderQueue;
+  friend class RadixHeap;
+  friend class EventChain;
+  // Index of this event's slot in the executive's handle table
+  uint32_t handle_index_;
+  // Type id of the derived class, see EventRegistry
+  uint16_t event_type_id_;
+  // Runs of events of this type are passed to DispatchBatch()
+  bool batch_dispatch_;
+  // Position of this event in the EventHeap, or in the LadderQueue or
+  // RadixHeap bucket, that holds it
+  size_t heap_index_;
+  // Neighbours of this event in the EventChain that holds it.  Both are
+  // nullptr while the event isn't in a chain.
+  SimBaseEvent *next_link_;
+  SimBaseEvent *prev_link_;
+
   // As per the coding standard
   DISALLOW_COPY_AND_ASSIGN(SimBaseEvent);
 
@@ -19,14 +19,32 @@
 #include <stdlib.h>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "sim_exec.hpp"
 #include "common_strings.hpp"
 #include "common_messages.hpp"
 #include "stim_loader.hpp"
+#include "event_heap.hpp"
+
+thread_local SimExec *SimExec::current_ = nullptr;
+thread_local std::vector<SimBaseEvent *> *SimExec::group_scheduled_ =
+    nullptr;
+
+const uint32_t EventHandle::kNoIndex;
+const size_t SimExec::kInboxCapacity;
+
+// The executive starts out with the default pending event set, which
+// Init() may replace.
+SimExec::SimExec() : curr_time_(0.0), run_until_time_(0.0),
+                     event_queue_(new EventHeap), arena_(nullptr),
+                     inbox_(kInboxCapacity), late_injections_(0),
+                     dispatch_pool_(nullptr), dispatching_groups_(false),
+                     group_count_(0), parallel_dispatches_(0),
+                     stim_loader_(nullptr),
+                     log_manager_(nullptr), config_manager_(nullptr) {
+}  // SimExec
 
-// Initialize that static singleton pointer
-SimExec* SimExec::the_exec_ = nullptr;
 
 // Initialize the SimExec.  This method calls the new "stim_loader"'s
 // method to load the first set of stimulus events.
@@ -43,12 +61,35 @@ SimExec* SimExec::the_exec_ = nullptr;
 //       coordinates logging for simulation events
 // "stim_loader" - pointer to the object that manages the stimulus file
 //       and handles loading stimulus events
+// "event_set" - pointer to an empty pending event set, or nullptr to keep
+//       the default
+// "arena" - pointer to the arena for the run's events, or nullptr for none.
+//       Events scheduled before Init() stay in the EventPool.
 void SimExec::Init(const SimTime &run_until_tm,
                    ConfigMgr *const config_manager,
                    LogMgr *const log_manager,
-                   StimLoader  *const stim_loader) {
+                   StimLoader  *const stim_loader,
+                   PendingEventSet *const event_set,
+                   EventArena *const arena) {
   // valid range for ruTime assumed
   run_until_time_.SetTime(run_until_tm);
+  current_ = this;
+
+  // Swap in the caller's event set before any stimulus is loaded.  Events
+  // scheduled before Init() are carried over, in order.
+  if (event_set != nullptr) {
+    while (!event_queue_->Empty()) {
+      event_set->Push(event_queue_->PopMin());
+    }
+    delete event_queue_;
+    event_queue_ = event_set;
+  }
+
+  // Events created from here on, starting with the first stimulus, come
+  // from the arena.  Without one, they come from the EventPool, even if an
+  // earlier executive on this thread left its arena current.
+  arena_ = arena;
+  EventArena::set_current(arena_);
 
   // Set up the config and log managers.  Both may be nullptr.
   config_manager_ = config_manager;
@@ -57,6 +98,7 @@ void SimExec::Init(const SimTime &run_until_tm,
   // Initialize the stimulus loader
   if (stim_loader!= nullptr) {
     stim_loader_ = stim_loader;
+    stim_loader_->set_exec(this);
     // Load the first set of stimulus
     stim_loader_->StartLoadingOrDie();
   } else {
@@ -68,8 +110,14 @@ void SimExec::Init(const SimTime &run_until_tm,
 
 // Class Destructor
 SimExec::~SimExec() {
-  // Clean up the stimulus load class
+  // Stop the dispatch threads
+  if (dispatch_pool_ != nullptr) {
+    delete dispatch_pool_;
+  }
+  // Clean up the stimulus load class.  Its prefetch thread, if any, is
+  // stopped first, while the whole of the loader is still there.
   if (stim_loader_ != nullptr) {
+    stim_loader_->StopPrefetch();
     delete stim_loader_;
   }
   // Clean up the config manager
@@ -82,15 +130,32 @@ SimExec::~SimExec() {
     delete log_manager_;
   }
 
+  // Events still in the inbox go first, while the arena, which some of
+  // them may have come from, is still there.
+  for (SimBaseEvent *event = inbox_.Pop(); event != nullptr;
+       event = inbox_.Pop()) {
+    delete event;
+  }
+
   // Clean up any remaining events on the event queue.  They're useless at
-  // this point, and SimExec is responsible for returning their memory
-  while (!event_queue_.empty()) {
-    SimBaseEvent *head_event = event_queue_.front();
-    event_queue_.pop_front();
-    delete head_event;
-  }
-  // null the singleton.
-  the_exec_ = nullptr;
+  // this point, and SimExec is responsible for returning their memory.  If
+  // the arena was created to discard them, their memory goes with the
+  // arena and their destructors are skipped.
+  if ((arena_ != nullptr) &&
+      (arena_->teardown() == EventArena::kDiscardEvents)) {
+    event_queue_->Discard();
+  } else {
+    event_queue_->Clear();
+  }
+  delete event_queue_;
+  // Events created on this thread from here on come from the EventPool
+  EventArena::set_current(nullptr);
+  if (arena_ != nullptr) {
+    delete arena_;
+  }
+  if (current_ == this) {
+    current_ = nullptr;
+  }
 }  // ~SimExec
 
 // Call this method to launch simulation.  Everything should be initialized
@@ -104,57 +169,16 @@ SimExec::~SimExec() {
 //           time of the final event, or the run_until_time, whichever is
 //           earlier.
 SimTime SimExec::Run() {
-  // To avoid continuously setting the current time while processing events
-  // with the same time, two loops are employed.  The inner loop processes
-  // events with the same time, while the outer loop advances the time.
-  // Note that any events added by the Dispatch() method will be added
-  // no earlier than the last of the events at the current time, since
-  // events earlier than the current simulator time are discarded.  Thus,
-  // these loops will process all valid events added to the queue as a 
-  // result of Dispatch actions.
-  // Set up the initial conditions for the event loop
-
-  bool have_events = false;
-  SimBaseEvent *head_event = nullptr;
-  // Determine whether there is at least one event to process, and, if so,
-  // get the first event.
-  if (!event_queue_.empty()) {
-    have_events = true;
-    // Note that the result of attempting to get the front event from an 
-    // empty list is undefined, so always check for emptiness first.
-    head_event = event_queue_.front();
-    // The first event to be processed sets the initial current time
-    curr_time_.SetTime(head_event->event_time());
-  }
-  // Loop as long as there are events and the simulation hasn't exceeded the
-  // specified time limit.
-  while (have_events && curr_time_.AsEarlyAs(run_until_time_)) {
-    // Loop through the events at the current time.
-    // head_event will not be null as long as there is at least one event to
-    // process.
-    while (have_events && 
-           head_event->SameTimeAs(curr_time_)) {
-      head_event->Dispatch();
-      // Remove the just processed event from the queue & delete it
-      event_queue_.pop_front();
-      delete head_event;
-      if (!event_queue_.empty()) {
-        head_event = event_queue_.front();
-      } else {
-        have_events = false;
-      }
-    }
-    // We've run out the string of events at curr_time_...
-    if (have_events) {
-      // ... but we still have more events in the queue.  head_event was
-      // advanced in the while() above, so we use it to set the new
-      // time for current_time
-      curr_time_.SetTime(head_event->event_time());
-    }
-  }
+  return RunEvents<EventRegistry<> >();
+} // run
+
 
+// Called once the event loop is done.
+//
+// Returns - the time when the simulation ended.
+SimTime SimExec::FinishRun() {
   // Since "curr_time_" might have been advanced beyond "run_until_time_"
-  // in the loop above, we'll report the earlier of the two values as the
+  // in the event loop, we'll report the earlier of the two values as the
   // simulation stop time.  If we ran out of events before "run_until_time_"
   // then "curr_time_" will be earlier than "run_until_time_", and that's
   // what should be reported.  If "curr_time_" is later than
@@ -172,19 +196,14 @@ SimTime SimExec::Run() {
   UtilStdMsg(kCommonStrNote, message.str());
 
   return return_time;
-} // run
+} // FinishRun
 
 
-// Public method to force the cleanup of the SimExec singleton.  This allows
-// the class to have a private ctor, but still be a good citizen w.r.t. memory
-// NOTE:  Once the singleton has been torn down, all pointer references to it
-// will be invalid and all state will be lost.  Be sure that this is what you
-// want.
+// NOTE:  Once the executive has been torn down, all pointer references to
+// it will be invalid and all state will be lost.  Be sure that this is what
+// you want.
 void SimExec::TearDown() {
   delete this;
-  // Should be handled in the dtor, but this is extra safety...
-  the_exec_ = nullptr;
-
 } // TearDown()
 
 
@@ -196,45 +215,280 @@ void SimExec::TearDown() {
 // data structure as well as the expected final insertion point.
 //
 // "new_event" - the event to place on the simulation event queue
-void SimExec::ScheduleEvent(SimBaseEvent *new_event) {
-  EnqueueEventFromEarliest(new_event);
+// Returns - a handle for the event, or a null handle if it was rejected
+EventHandle SimExec::ScheduleEvent(SimBaseEvent *new_event) {
+  return EnqueueEvent(new_event);
 }
 
 // Events are inserted in time order.  If times are identical, the
 // event is inserted after all other events already scheduled at the
 // same time.
 // This method accepts a suggestion regarding insertion direction 
-// from the caller
+// from the caller.  The pending event sets don't scan, so the suggestion
+// is ignored, and the insertion direction is left unnamed.
 //
 // "new_event" - the event to place on the simulation event queue
-// "insert_from" - specifies whether to insert from the head, or the tail
-void SimExec::ScheduleEvent(SimBaseEvent *new_event, 
-                            const EventInsert insert_from ) {
-  if (insert_from == kInsertFromNow) {
-    EnqueueEventFromEarliest(new_event);
-  } else {
-    EnqueueEventFromLatest(new_event);
+// Returns - a handle for the event, or a null handle if it was rejected
+EventHandle SimExec::ScheduleEvent(SimBaseEvent *new_event,
+                                   const EventInsert) {
+  return EnqueueEvent(new_event);
+}
+
+
+// Each event is checked, and given a handle, just as ScheduleEvent()
+// would.  The events that are accepted then go to the pending event set in
+// a single batch, which lets the set merge them in one pass rather than
+// placing them one at a time.
+//
+// "new_events" - the events to place on the simulation event queue
+// "handles" - if not nullptr, receives a handle for each event
+void SimExec::ScheduleEvents(const std::vector<SimBaseEvent *> &new_events,
+                             std::vector<EventHandle> *handles) {
+  if (dispatching_groups_) {
+    // The events must be staged with the group scheduling them
+    if (handles != nullptr) {
+      handles->clear();
+    }
+    for (SimBaseEvent *new_event : new_events) {
+      EventHandle handle = StageGroupEvent(new_event);
+      if (handles != nullptr) {
+        handles->push_back(handle);
+      }
+    }
+    return;
+  }
+  std::vector<SimBaseEvent *> accepted;
+  accepted.reserve(new_events.size());
+  if (handles != nullptr) {
+    handles->clear();
+    handles->reserve(new_events.size());
+  }
+  for (SimBaseEvent *new_event : new_events) {
+    EventHandle handle = AdmitEvent(new_event);
+    if (!handle.IsNull()) {
+      accepted.push_back(new_event);
+    }
+    if (handles != nullptr) {
+      handles->push_back(handle);
+    }
   }
+  event_queue_->PushBatch(accepted);
 }
 
+
+// The event is removed from the pending event set, and its memory is
+// returned right away, rather than leaving a stale event to be skipped
+// when it reaches the front of the queue.
+//
+// "handle" - handle returned when the event was scheduled
+// Returns - "true" if the event was cancelled
+bool SimExec::CancelEvent(const EventHandle &handle) {
+  if (dispatching_groups_) {
+    std::cerr << kCommonStrError << "Events dispatched in parallel groups "
+                 "may not cancel events." << std::endl;
+    return false;
+  }
+  SimBaseEvent *event = HandleEvent(handle);
+  if ((event == nullptr) || !event_queue_->Remove(event)) {
+    return false;
+  }
+  ReleaseHandle(event);
+  delete event;
+  return true;
+}
+
+
+// The event is removed from the pending event set, retimed, then pushed
+// back, so it lands after any events already at "new_time".
+//
+// "handle" - handle returned when the event was scheduled
+// "new_time" - the new time for the event
+// Returns - "true" if the event was rescheduled
+bool SimExec::RescheduleEvent(const EventHandle &handle,
+                              const SimTime &new_time) {
+  if (dispatching_groups_) {
+    std::cerr << kCommonStrError << "Events dispatched in parallel groups "
+                 "may not reschedule events." << std::endl;
+    return false;
+  }
+  SimBaseEvent *event = HandleEvent(handle);
+  if (event == nullptr) {
+    return false;
+  }
+  if (new_time.EarlierThan(curr_time_)) {
+    std::cerr << kCommonStrError << "Attempted to reschedule event into the "
+                 "past.  New Time: " << new_time.GetUserTime()
+              << " Current Simulation Time: " << curr_time_.GetUserTime()
+              << std::endl;
+    return false;
+  }
+  if (!event_queue_->Remove(event)) {
+    return false;
+  }
+  event->event_time_.SetTime(new_time);
+  event_queue_->Push(event);
+  return true;
+}
+
+
+// The parallel groups may be growing the handle table, so, like
+// CancelEvent(), this is refused while they run.
+//
+// "handle" - the handle to check
+// Returns - "true" if the handle's event is still waiting to be dispatched
+bool SimExec::IsScheduled(const EventHandle &handle) const {
+  if (dispatching_groups_) {
+    std::cerr << kCommonStrError << "Events dispatched in parallel groups "
+                 "may not check events." << std::endl;
+    return false;
+  }
+  return HandleEvent(handle) != nullptr;
+}
+
+
+// The pool is only kept while it has threads to offer.
+//
+// "thread_count" - threads, counting the one running the executive
+void SimExec::set_dispatch_threads(unsigned thread_count) {
+  if (dispatch_pool_ != nullptr) {
+    delete dispatch_pool_;
+    dispatch_pool_ = nullptr;
+  }
+  if (thread_count > 1) {
+    dispatch_pool_ = new DispatchPool(thread_count);
+  }
+}
+
+
+// Groups are numbered in the order of their first event, which is the
+// order in which FinishConflictGroups() queues what they schedule, so the
+// run stays repeatable however the groups are spread over the threads.
+//
+// "first_event" - the event at the head of the queue, already popped
+void SimExec::GatherConflictGroups(SimBaseEvent *first_event) {
+  group_of_key_.clear();
+  SimBaseEvent *event = first_event;
+  for (;;) {
+    const uint64_t key = event->conflict_key();
+    std::unordered_map<uint64_t, size_t>::iterator found =
+        group_of_key_.find(key);
+    size_t group;
+    if (found != group_of_key_.end()) {
+      group = found->second;
+    } else {
+      group = group_count_++;
+      if (group == groups_.size()) {
+        groups_.push_back(ConflictGroup());
+      }
+      groups_[group].key = key;
+      group_of_key_[key] = group;
+    }
+    groups_[group].events.push_back(event);
+    if (event_queue_->Empty()) {
+      break;
+    }
+    event = event_queue_->PeekMin();
+    if (!event->SameTimeAs(curr_time_) ||
+        (event->conflict_key() == SimBaseEvent::kNoConflictKey)) {
+      break;
+    }
+    event_queue_->PopMin();
+    ReleaseHandle(event);
+  }
+}  // GatherConflictGroups
+
+
+// The groups keep their storage for the next time.
+void SimExec::FinishConflictGroups() {
+  for (size_t group = 0; group < group_count_; ++group) {
+    for (SimBaseEvent *event : groups_[group].events) {
+      delete event;
+    }
+    groups_[group].events.clear();
+    for (SimBaseEvent *event : groups_[group].scheduled) {
+      event_queue_->Push(event);
+    }
+    groups_[group].scheduled.clear();
+  }
+  group_count_ = 0;
+}  // FinishConflictGroups
+
+
+// The handle table is shared by every group, so admitting takes the lock.
+// The event itself waits with its group until the groups are done, since
+// the event queue isn't safe to touch from several threads.
+//
+// "new_event" - the event to schedule
+// Returns - a handle for the event, or a null handle if it was rejected
+EventHandle SimExec::StageGroupEvent(SimBaseEvent *new_event) {
+  EventHandle handle;
+  {
+    std::lock_guard<std::mutex> lock(admit_mutex_);
+    handle = AdmitEvent(new_event);
+  }
+  if (!handle.IsNull()) {
+    group_scheduled_->push_back(new_event);
+  }
+  return handle;
+}  // StageGroupEvent
+
 #ifdef TEST_HARNESS
   // Test harness support
 void SimExec::DumpQueue() {
   std::cout << "*** Contents of the Event Queue:\n";
-  std::list<SimBaseEvent *>::iterator iter = event_queue_.begin();
-  while (iter != event_queue_.end()) {
-    (*iter)->DumpEvent();
-    iter++;
+  std::vector<SimBaseEvent *> ordered_events;
+  event_queue_->OrderedEvents(&ordered_events);
+  for (SimBaseEvent *event : ordered_events) {
+    event->DumpEvent();
   }
 }
 #endif
 
 
-// Inserts an event by starting at the earliest event in the queue 
-// searching forward for the proper insertion point. 
+// Only the thread running the executive drains the inbox, so the event
+// queue and handle table need no locking.  Once curr_time_ has been set
+// by a dispatched event, no event may be queued before it, so late events
+// are moved up to it.  The clock has not moved past the events at
+// curr_time_, which keeps the monotone sets (e.g. RadixHeap) valid.
+void SimExec::DrainInbox() {
+  for (SimBaseEvent *event = inbox_.Pop(); event != nullptr;
+       event = inbox_.Pop()) {
+    if (event->event_time().EarlierThan(curr_time_)) {
+      event->event_time_.SetTime(curr_time_);
+      ++late_injections_;
+    }
+    EnqueueEvent(event);
+  }
+}  // DrainInbox
+
+
+// Inserts an event into the pending event set.  The set dispatches an
+// event after all other events already scheduled at the same time.
 //
 // "new_event" - the event to place on the simulation event queue
-void SimExec::EnqueueEventFromEarliest(SimBaseEvent *new_event) {
+// Returns - a handle for the event, or a null handle if it was rejected
+EventHandle SimExec::EnqueueEvent(SimBaseEvent *new_event) {
+  if (dispatching_groups_) {
+    return StageGroupEvent(new_event);
+  }
+  EventHandle handle = AdmitEvent(new_event);
+  if (!handle.IsNull()) {
+    event_queue_->Push(new_event);
+  }
+  return handle;
+} // EnqueueEvent()
+
+
+// Rejecting events in the past guarantees that the pending event set never
+// sees a time earlier than the last event it removed, which the monotone
+// sets (e.g. RadixHeap) depend upon for their efficiency.
+// Accepted events are given a slot in the handle table.  Free slots are
+// reused first, so the table only grows to the largest number of events
+// pending at once.
+//
+// "new_event" - the event about to be placed on the event queue
+// Returns - a handle for the event, or a null handle if it was rejected
+EventHandle SimExec::AdmitEvent(SimBaseEvent *new_event) {
   // Sanity check on incoming event.  If it's in the past, print and throw it
   // away.
   if (new_event->EarlierThan(curr_time_)) {
@@ -243,41 +497,41 @@ void SimExec::EnqueueEventFromEarliest(SimBaseEvent *new_event) {
               << "Current Simulation Time: " << curr_time_.GetUserTime() 
               << std::endl;
     delete new_event;
-    return;
+    return EventHandle();
   }
-  // Iterate through the event queue as long as the time of the events is
-  // earlier than, or equal to, the new event's time.
-  std::list<SimBaseEvent *>::iterator iter = event_queue_.begin();
-  while ((iter != event_queue_.end()) &&
-         (*iter)->AsEarlyAs(*new_event)) {
-    iter++;
-  }
-  // By this point, the iteration has reached one of three states.  The most
-  // likely case is that the iterater is at the first event with a time, 
-  // later than the new event, so this is the insertion point.  Alternatively,
-  // the queue might be empty, or the the new event is later than any events
-  // already in the queue.  In either of these two cases, the new event should
-  // be appended to the queue.
-  if (iter != event_queue_.end()) {
-    // Insert before the event with a time later than the new event.
-    event_queue_.insert(iter, new_event);
+  uint32_t index;
+  if (!free_handles_.empty()) {
+    index = free_handles_.back();
+    free_handles_.pop_back();
   } else {
-    // Special case, when the new item is to be inserted at the end of the
-    // list, "iter" won't hold a valid insertion point.  Also handles the case
-    // where the list was empty.
-    event_queue_.push_back(new_event);
+    index = static_cast<uint32_t>(handles_.size());
+    HandleSlot slot = {nullptr, 0};
+    handles_.push_back(slot);
   }
-} // EnqueueEventFromEarliest()
+  handles_[index].event = new_event;
+  new_event->handle_index_ = index;
+  return EventHandle(index, handles_[index].generation);
+} // AdmitEvent()
 
 
-// Inserts an event by starting at the latest event in the queue and
-// searching backward for the proper insertion point. For event
-// management implementations where backwards traversal is relatively
-// efficient, this method allows the option of a potential optimization
-// from searching backward from the latest event.
+// "handle" - the handle to look up
+// Returns - the handle's event, or nullptr if the handle is null or stale
+SimBaseEvent *SimExec::HandleEvent(const EventHandle &handle) const {
+  if ((handle.index_ >= handles_.size()) ||
+      (handles_[handle.index_].generation != handle.generation_)) {
+    return nullptr;
+  }
+  return handles_[handle.index_].event;
+}
+
+
+// Bumping the generation makes every outstanding handle for the slot
+// stale.
 //
-// "new_event" - the event to place on the simulation event queue
-void SimExec::EnqueueEventFromLatest(SimBaseEvent *new_event) {
-  // TBD, not yet implemented.
-  EnqueueEventFromEarliest(new_event);
+// "event" - the event that is leaving the event queue
+void SimExec::ReleaseHandle(SimBaseEvent *event) {
+  HandleSlot &slot = handles_[event->handle_index_];
+  slot.event = nullptr;
+  ++slot.generation;
+  free_handles_.push_back(event->handle_index_);
 }
@@ -20,13 +20,23 @@
 #ifndef SIM_DESIM_SIM_EXEC_HPP_
 #define SIM_DESIM_SIM_EXEC_HPP_
 
+#include <stdint.h>
 #include <fstream>
-#include <list>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "basic_defs.hpp"
 #include "sim_time.hpp"
 #include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+#include "event_arena.hpp"
+#include "event_inbox.hpp"
+#include "dispatch_pool.hpp"
+#include "event_registry.hpp"
+#include "callback_event.hpp"
 #include "log_mgr.hpp"
 #include "config_mgr.hpp"
 
@@ -34,9 +44,46 @@
 class StimLoader;
 class SimExec;
 
+// Identifies an event scheduled with the simulation executive, so that it
+// can later be cancelled or rescheduled.  A handle is just an index into
+// the executive's handle table plus a generation count, so it is cheap to
+// copy and store.  Once its event has been dispatched or cancelled, the
+// handle goes stale.  The generation count lets the executive recognize
+// a stale handle even after its table slot has been reused.
+class EventHandle {
+ public:
+  // Creates a handle that refers to no event
+  EventHandle() : index_(kNoIndex), generation_(0) {};
+
+  // Returns - "true" if this handle never referred to an event.  Note that
+  //       a handle that is not null may still be stale.
+  bool IsNull() const { return index_ == kNoIndex; };
+
+ private:
+  friend class SimExec;
+
+  // Index value of a null handle
+  static const uint32_t kNoIndex = 0xFFFFFFFF;
+
+  // "index" - slot in the executive's handle table
+  // "generation" - generation of the slot when the handle was issued
+  EventHandle(uint32_t index, uint32_t generation)
+      : index_(index), generation_(generation) {};
+
+  uint32_t index_;
+  uint32_t generation_;
+};  // class EventHandle
+
 // This class provides a discrete event simulator executive for the
-// simulation environment.  In practice, this is expected to be a
-// singleton for the whole environment.
+// simulation environment.  Each executive runs one simulation, and any
+// number of them may run at once, each on its own thread.  While an
+// executive is initializing or running, it is the "current" executive of
+// its thread, which is how events and stimulus loaders that weren't handed
+// one reach it.
+// Other threads, e.g. co-simulation adapters, hand events to a running
+// executive through its inbox, see InjectEvent().  Within one time, events
+// that declare different conflict keys may be dispatched on several
+// threads, see set_dispatch_threads().
 // In addition to some administrative functions, this class manages
 // the simulation event data structure, which is ordered by time.
 // Simulation progresses by accessing the earliest event, executing it,
@@ -50,27 +97,41 @@ class SimExec {
   // Users may want to attempt to provide a suggestion regarding which
   // direction the SimExec scans when inserting events.  This is not
   // guaranteed to significantly speed up insertion, but it could be
-  // beneficial.
+  // beneficial.  None of the current PendingEventSet implementations scan
+  // for the insertion point, so the hint is accepted but ignored.
   // "kInsertFromNow" - tells the algorithm to start scanning for the
   //       proper insertion point from the current time.
   // "kInsertFarFuture" - suggests that the scan start from the latest
   //       event currently managed by the SimExec
   enum EventInsert { kInsertFromNow, kInsertFarFuture };
 
-  // The simulation environment expects a singleton object to manage
-  // the event queue for the environment.  Accessing the executive 
-  // exclusively through this method ensures that we don't, inadvertently
-  // have multiple executives managing events.  This method creates
-  // a new executive, if needed, and returns a pointer to the singleton
-  // executive object.
-  //
-  // Returns - a pointer to the singleton simulation executive object.
+  // Most events that may wait in the inbox at once, see InjectEvent()
+  static const size_t kInboxCapacity = 4096;
+
+  // Creates an executive with the default pending event set.  It isn't
+  // current on any thread until Init() or a run makes it so.
+  SimExec();
+  // Deletes the managers, the stimulus loader, any events still pending,
+  // and the arena, if any.  If this is the current executive of the
+  // calling thread, the thread is left without one.
+  ~SimExec();
+
+  // Returns - the current executive of the calling thread.  If the thread
+  //       doesn't have one, a new executive is created, and made current,
+  //       so single simulation programs can keep using this as they would
+  //       a singleton.  TearDown() releases it.
   static SimExec *the_exec() {
-    if (the_exec_ == nullptr)
-      the_exec_ = new SimExec;
-    return the_exec_;
-  } // instance()
-  
+    if (current_ == nullptr)
+      current_ = new SimExec;
+    return current_;
+  } // the_exec()
+
+  // Returns - the current executive of the calling thread, or nullptr
+  static SimExec *current() { return current_; }
+  // "exec" - the executive to make current on the calling thread, or
+  //       nullptr for none
+  static void set_current(SimExec *exec) { current_ = exec; }
+
   // Access the current simulation time, as kept by the simulator.  Simulator
   // current time is defined as the time of the event most recently executed
   // from the event queue.
@@ -78,13 +139,17 @@ class SimExec {
   // Returns - a time object representing the simulator's current time.
   SimTime curr_time() const { return curr_time_; };
 
-  // Initialize the SimExec.  Note that the stimulus loader is specific to
+  // Initialize the SimExec, and make it the current executive of the
+  // calling thread.  Note that the stimulus loader is specific to
   // each simulation application, so the executive takes a pointer to the
   // base stimulus loader class.  Creation of the "config_manager", the
   // "log_manager" and the "stim_loader" is the responsibility of the
   // caller, but the executive will be responsible for the memory.
   // The executive will also call the new "stim_loader"'s method to load the
   // first set of stimulus.
+  // The caller may also choose the data structure that holds the pending
+  // events.  As with the managers, the executive takes responsibility for
+  // its memory.
   //
   // "run_until_tm" - specifies the ending time for the run.  The
   //       simulation may end earlier, if the event queue is exhausted.
@@ -96,10 +161,19 @@ class SimExec {
   //       coordinates logging for simulation events
   // "stim_loader" - pointer to the object that manages the stimulus file
   //       and handles loading stimulus events
+  // "event_set" - pointer to an empty pending event set, for example from
+  //       PendingEventSet::NewEventSet().  If nullptr, the executive keeps
+  //       its default EventHeap.
+  // "arena" - pointer to an EventArena to allocate the run's events from,
+  //       or nullptr to allocate them from the EventPool.  The arena is
+  //       made current before any stimulus is loaded, and is released,
+  //       with every event still in it, at teardown.
   void Init(const SimTime &run_until_tm,
             ConfigMgr *const config_manager,
             LogMgr *const log_manager,
-            StimLoader  *const stim_loader);
+            StimLoader  *const stim_loader,
+            PendingEventSet *const event_set = nullptr,
+            EventArena *const arena = nullptr);
 
   // Methods to add events to the simulation executive.
   //
@@ -115,24 +189,141 @@ class SimExec {
   // data structure as well as the expected final insertion point.
   //
   // "new_event" - the event to place on the simulation event queue
-  void ScheduleEvent(SimBaseEvent *new_event);
+  // Returns - a handle for cancelling or rescheduling the event.  If the
+  //       event was rejected, because it is in the past, the handle is
+  //       null.
+  EventHandle ScheduleEvent(SimBaseEvent *new_event);
 
   // This variant accepts a suggestion regarding insertion direction 
   // from the caller
   //
   // "new_event" - the event to place on the simulation event queue
   // "insert_from" - specifies whether to insert from the head, or the tail
-  void ScheduleEvent(SimBaseEvent *new_event, const EventInsert insert_from );
+  // Returns - a handle for the event, as above
+  EventHandle ScheduleEvent(SimBaseEvent *new_event,
+                            const EventInsert insert_from );
 
-  // Call this method to launch simulation.  Everything should be initialized
-  // before calling run().  Initialization should have scheduled the
-  // initial events.  After that, normal processing can schedule
-  // events. For instance, the stimulus reader should schedule the initial
-  // 1 second's worth of events, then schedule a timer to be called 0.5
-  // seconds in for the next 1 second, etc.
+  // Schedules a callable to be called at "event_time", without writing an
+  // event class for it.  Small callables are stored in the event itself,
+  // see CallbackEvent, so this usually costs no heap allocation.
+  //
+  // "event_time" - time at which to call "callable"
+  // "callable" - called with no arguments, e.g. a lambda.  It is moved, or
+  //       copied, into the event.
+  // Returns - a handle for cancelling or rescheduling the callback, as
+  //       with ScheduleEvent()
+  template <typename Callable>
+  EventHandle ScheduleCallback(const SimTime &event_time,
+                               Callable &&callable) {
+    return ScheduleEvent(new CallbackEvent(event_time,
+                                           std::forward<Callable>(callable)));
+  }
+
+  // Schedules a whole batch of events in one call, which is cheaper than
+  // scheduling them one at a time when the batch is large, e.g. a window
+  // of stimulus.  The result is the same as calling ScheduleEvent() for
+  // each event in turn, so events with the same time are dispatched in
+  // the order in which they appear in the batch.  Events in the past are
+  // rejected, and deleted, one by one, without affecting the rest.
+  //
+  // "new_events" - the events to place on the simulation event queue, in
+  //       any time order.  The executive takes responsibility for them.
+  // "handles" - if not nullptr, receives one handle per event, in the same
+  //       order as "new_events".  Rejected events get null handles.
+  void ScheduleEvents(const std::vector<SimBaseEvent *> &new_events,
+                      std::vector<EventHandle> *handles = nullptr);
+
+  // Hands an event to the executive from any thread, while it runs or
+  // not.  Unlike ScheduleEvent(), which may only be called on the thread
+  // running the executive, this never touches the event queue.  The event
+  // waits in a lock-free inbox, which the run moves to the event queue
+  // before it advances the simulation time, and whenever the queue runs
+  // dry.  An event whose time has already passed by then is dispatched at
+  // the current simulation time, rather than rejected, since the caller
+  // could not have known the time, and is counted in
+  // late_injection_count().  Injected events get no handle, and a run
+  // that runs out of events ends, even if more are on their way.
+  //
+  // "new_event" - the event to add.  If it was accepted, the executive
+  //       takes responsibility for it.
+  // Returns - "true" if the event was accepted, "false" if the inbox holds
+  //       "kInboxCapacity" events already.  The caller keeps the event,
+  //       and may try again later.
+  bool InjectEvent(SimBaseEvent *new_event) {
+    return inbox_.Push(new_event);
+  }
+
+  // Returns - the number of injected events that reached the event queue
+  //       after their time had passed, and were dispatched late
+  uint64_t late_injection_count() const { return late_injections_; }
+
+  // Removes a scheduled event from the event queue, and deletes it without
+  // dispatching it.  The handle goes stale.
+  //
+  // "handle" - handle returned when the event was scheduled
+  // Returns - "true" if the event was cancelled, "false" if the handle is
+  //       null or stale, i.e. the event was already dispatched or
+  //       cancelled.
+  bool CancelEvent(const EventHandle &handle);
+
+  // Moves a scheduled event to a new time.  The event is ordered as if it
+  // had just been scheduled, i.e. after any other events already
+  // scheduled at "new_time".  The handle remains valid.
+  //
+  // "handle" - handle returned when the event was scheduled
+  // "new_time" - the new time for the event.  Must not be earlier than
+  //       the current simulation time.
+  // Returns - "true" if the event was rescheduled, "false" if the handle
+  //       is null or stale, or "new_time" is in the past.  In the latter
+  //       case, the event is left as it was.
+  bool RescheduleEvent(const EventHandle &handle, const SimTime &new_time);
+
+  // Returns - "true" if "handle" refers to an event that is still waiting
+  //       to be dispatched, "false" otherwise, or if called from an event
+  //       dispatched in a parallel group
+  bool IsScheduled(const EventHandle &handle) const;
+
+  // Sets the number of threads that dispatch events.  With more than one,
+  // whenever the next events in the queue share a time, and each declares
+  // a conflict key (see SimBaseEvent::conflict_key()), they are split
+  // into groups by key, and the groups are dispatched in parallel on a
+  // work-stealing pool.  The events of a group are dispatched in queue
+  // order, one at a time.  An event without a key is dispatched alone, as
+  // before.
+  // While the groups run, their events may schedule new events, but not
+  // cancel, reschedule, or check (IsScheduled()) any.  New events at the
+  // current time are queued after the groups are done, group by group.
+  // Since the groups share the log and config managers, events that use
+  // them should not declare a key.  Events scheduled on the pool's
+  // threads come from the EventPool, even if the run has an arena.
+  //
+  // "thread_count" - threads, counting the one running the executive.
+  //       One, the default, dispatches every event on that thread.
+  void set_dispatch_threads(unsigned thread_count);
+
+  // Returns - events dispatched in parallel groups, for tuning
+  uint64_t parallel_dispatch_count() const { return parallel_dispatches_; }
+
+  // Call this method to launch simulation.  The executive is the current
+  // executive of the calling thread for the length of the run.  Everything
+  // should be initialized before calling run().  Initialization should
+  // have scheduled the initial events.  After that, normal processing can
+  // schedule events. For instance, the stimulus reader should schedule
+  // the initial 1 second's worth of events, then schedule a timer to be
+  // called 0.5 seconds in for the next 1 second, etc.
   //
   // Returns - the time when the simulation ended.
   SimTime Run();
+
+  // Same as Run(), but events of the listed types are dispatched with
+  // direct calls rather than through the virtual Dispatch(), see
+  // EventRegistry.  Each listed type's BindToExec() is called as the run
+  // starts and finishes.  Events of other types are still dispatched
+  // through the virtual method.
+  //
+  // Returns - the time when the simulation ended.
+  template <typename... EventTypes>
+  SimTime RunTyped() { return RunEvents<EventRegistry<EventTypes...> >(); }
   
   // Accessor for the log manager.  Use this object to send log output
   // from the execution of the simulator to an external log file.
@@ -140,8 +331,8 @@ class SimExec {
   // Returns - a pointer to the log manager
   LogMgr *log_manager() { return log_manager_; };
 
-  // Since this class has a private dtor, the TearDown method takes care of
-  // cleaning up the object and its allocated data.
+  // Deletes the executive, as the dtor does.  For executives from
+  // the_exec(), or created with "new".
   void TearDown();
 
 #ifdef TEST_HARNESS
@@ -151,28 +342,86 @@ class SimExec {
 #endif
 
  private:
-  // Ctor & Dtor private since only internal simulator code should be
-  // creating / destroying the singleton simulation executive.
-  SimExec() : curr_time_(0.0), run_until_time_(0.0), stim_loader_(nullptr),
-              log_manager_(nullptr), config_manager_(nullptr) { };
-  ~SimExec();
-
-  // Methods that actually insert events into the simulation data structure:
+  // One entry in the handle table.  "event" is nullptr while the slot is
+  // free.
+  struct HandleSlot {
+    SimBaseEvent *event;
+    uint32_t generation;
+  };
 
-  // Inserts an event by starting at the earliest event in the queue 
-  // searching forward for the proper insertion point. 
+  // Inserts an event into the simulation data structure.  Events earlier
+  // than the current simulation time are rejected with an error message,
+  // and deleted.
   //
   // "new_event" - the event to place on the simulation event queue
-  void EnqueueEventFromEarliest(SimBaseEvent *new_event);
+  // Returns - a handle for the event, or a null handle if it was rejected
+  EventHandle EnqueueEvent(SimBaseEvent *new_event);
 
-  // Inserts an event by starting at the latest event in the queue and
-  // searching backward for the proper insertion point. For event
-  // management implementations where backwards traversal is relatively
-  // efficient, this method allows the option of a potential optimization
-  // from searching backward from the latest event.
+  // Checks an event that is about to be placed on the event queue, and
+  // gives it a handle.  Events earlier than the current simulation time
+  // are rejected with an error message, and deleted.  The caller places
+  // accepted events in the pending event set.
   //
-  // "new_event" - the event to place on the simulation event queue
-  void EnqueueEventFromLatest(SimBaseEvent *new_event);
+  // "new_event" - the event to check
+  // Returns - a handle for the event, or a null handle if it was rejected
+  EventHandle AdmitEvent(SimBaseEvent *new_event);
+
+  // Events at one time that share a conflict key, in queue order, and the
+  // events they scheduled while the groups ran
+  struct ConflictGroup {
+    uint64_t key;
+    std::vector<SimBaseEvent *> events;
+    std::vector<SimBaseEvent *> scheduled;
+  };
+
+  // Takes "first_event", and the events after it at the same time that
+  // also declare a conflict key, out of the queue, and dispatches them in
+  // groups, in parallel.
+  //
+  // "Registry" - the EventRegistry that dispatches each event
+  // "first_event" - the event at the head of the queue, already popped
+  template <class Registry>
+  void DispatchConflictGroups(SimBaseEvent *first_event);
+
+  // Sorts "first_event", and the keyed events after it at the same time,
+  // into "groups_".
+  //
+  // "first_event" - the event at the head of the queue, already popped
+  void GatherConflictGroups(SimBaseEvent *first_event);
+
+  // Deletes the events of "groups_", and queues what they scheduled.
+  void FinishConflictGroups();
+
+  // Admits an event scheduled while the groups run, and holds it with the
+  // group that scheduled it.
+  //
+  // "new_event" - the event to schedule
+  // Returns - a handle for the event, or a null handle if it was rejected
+  EventHandle StageGroupEvent(SimBaseEvent *new_event);
+
+  // Moves the events injected since the last call from the inbox to the
+  // event queue.  Late events are retimed to the current time.
+  void DrainInbox();
+
+  // Returns - the event that "handle" refers to, or nullptr if the handle
+  //       is null or stale
+  SimBaseEvent *HandleEvent(const EventHandle &handle) const;
+
+  // Frees the handle table slot of "event", making its handles stale.
+  // Called as the event leaves the event queue.
+  void ReleaseHandle(SimBaseEvent *event);
+
+  // The event loop behind Run() and RunTyped().
+  //
+  // "Registry" - the EventRegistry that dispatches each event
+  // Returns - the time when the simulation ended.
+  template <class Registry>
+  SimTime RunEvents();
+
+  // Works out, and reports, the time when the simulation ended.
+  //
+  // Returns - the time when the simulation ended.
+  SimTime FinishRun();
 
   // Current simulation time object.  This reflects the time of the event most
   // recently processed from the event queue, and is initialized to 0.
@@ -183,9 +432,41 @@ class SimExec {
   // reached.
   SimTime run_until_time_;
 
-  // The data structure containing events staged for execution.  Currently
-  // using a doubly linked list as the queue.
-  std::list<SimBaseEvent *> event_queue_;
+  // The data structure containing events staged for execution.  Any
+  // PendingEventSet dispatches events with the same time in the order in
+  // which they were scheduled.  Defaults to an EventHeap.
+  PendingEventSet *event_queue_;
+  // Arena the run's events are allocated from, or nullptr
+  EventArena *arena_;
+  // Scratch space for the run of events passed to DispatchBatch(), kept
+  // to avoid allocating for each run
+  std::vector<SimBaseEvent *> batch_;
+
+  // Events injected by other threads, not yet on the event queue, and the
+  // number that arrived late
+  EventInbox inbox_;
+  uint64_t late_injections_;
+
+  // Threads for dispatching conflict groups, or nullptr for none
+  DispatchPool *dispatch_pool_;
+  // Set while the groups run.  Scheduling is then staged by group, under
+  // "admit_mutex_", which guards the handle table.
+  bool dispatching_groups_;
+  std::mutex admit_mutex_;
+  // The groups being dispatched.  Only the first "group_count_" are in
+  // use; the rest are kept, with their storage, for later.
+  std::vector<ConflictGroup> groups_;
+  size_t group_count_;
+  // Index in "groups_" of the group for each key
+  std::unordered_map<uint64_t, size_t> group_of_key_;
+  uint64_t parallel_dispatches_;
+  // Where the group running on each thread stages what it schedules
+  static thread_local std::vector<SimBaseEvent *> *group_scheduled_;
+
+  // Handle table for the scheduled events, and the indices of the free
+  // slots, which are reused before the table grows.
+  std::vector<HandleSlot> handles_;
+  std::vector<uint32_t> free_handles_;
 
   // object that will be loading / feeding stimulus to the queue
   StimLoader *stim_loader_;
@@ -194,14 +475,149 @@ class SimExec {
   LogMgr *log_manager_;
   // Object that manages configuration data
   ConfigMgr *config_manager_;
-  
 
-  // Pointer to the singleton instance of this class
-  static SimExec *the_exec_;
+  // The current executive of each thread
+  static thread_local SimExec *current_;
 
  private:
     // As per the coding standard
   DISALLOW_COPY_AND_ASSIGN(SimExec);
 }; // class SimExec
 
+
+// To avoid continuously setting the current time while processing events
+// with the same time, two loops are employed.  The inner loop processes
+// events with the same time, while the outer loop advances the time.
+// Note that any events added by the Dispatch() method will be added
+// no earlier than the last of the events at the current time, since
+// events earlier than the current simulator time are discarded.  Thus,
+// these loops will process all valid events added to the queue as a
+// result of Dispatch actions.  Injected events are drained into the queue
+// between the two loops, so that none of them can fall behind the clock
+// unnoticed.
+//
+// "Registry" - the EventRegistry that dispatches each event
+// Returns - the time when the simulation ended.
+template <class Registry>
+SimTime SimExec::RunEvents() {
+  SimExec *const previous_exec = current_;
+  current_ = this;
+  Registry::BindToExec(this);
+  DrainInbox();
+  // Set up the initial conditions for the event loop
+  bool have_events = false;
+  SimBaseEvent *head_event = nullptr;
+  // Determine whether there is at least one event to process, and, if so,
+  // get the first event.
+  if (!event_queue_->Empty()) {
+    have_events = true;
+    // Note that the result of attempting to get the earliest event from an
+    // empty set is undefined, so always check for emptiness first.
+    head_event = event_queue_->PeekMin();
+    // The first event to be processed sets the initial current time
+    curr_time_.SetTime(head_event->event_time());
+  }
+  // Loop as long as there are events and the simulation hasn't exceeded the
+  // specified time limit.
+  while (have_events && curr_time_.AsEarlyAs(run_until_time_)) {
+    // Loop through the events at the current time.
+    // head_event will not be null as long as there is at least one event to
+    // process.
+    while (have_events &&
+           head_event->SameTimeAs(curr_time_)) {
+      // Remove the event from the queue before dispatching it, so that
+      // events scheduled by Dispatch() are ordered against the rest of the
+      // queue, rather than against an event that is about to leave.
+      event_queue_->PopMin();
+      // Handles to an event go stale once it leaves the queue
+      ReleaseHandle(head_event);
+      if ((dispatch_pool_ != nullptr) &&
+          (head_event->conflict_key() != SimBaseEvent::kNoConflictKey)) {
+        DispatchConflictGroups<Registry>(head_event);
+      } else if (head_event->batch_dispatch()) {
+        // Take the rest of the run of events of the same type at this time
+        // off the queue too, and dispatch them together, still in order
+        batch_.clear();
+        batch_.push_back(head_event);
+        while (!event_queue_->Empty()) {
+          SimBaseEvent *next_event = event_queue_->PeekMin();
+          if (!next_event->SameTimeAs(curr_time_) ||
+              (next_event->event_type_id() != head_event->event_type_id())) {
+            break;
+          }
+          event_queue_->PopMin();
+          ReleaseHandle(next_event);
+          batch_.push_back(next_event);
+        }
+        Registry::DispatchBatch(batch_.data(), batch_.size());
+        for (SimBaseEvent *event : batch_) {
+          delete event;
+        }
+      } else {
+        Registry::Dispatch(head_event);
+        delete head_event;
+      }
+      if (!event_queue_->Empty()) {
+        head_event = event_queue_->PeekMin();
+      } else {
+        have_events = false;
+      }
+    }
+    // Before the clock moves on, or the run ends for want of events, take
+    // in whatever other threads injected.  Late arrivals land at
+    // curr_time_, and are dispatched before the clock moves.
+    DrainInbox();
+    if (!event_queue_->Empty()) {
+      have_events = true;
+      head_event = event_queue_->PeekMin();
+    }
+    // We've run out the string of events at curr_time_...
+    if (have_events) {
+      // ... but we still have more events in the queue.  head_event was
+      // advanced in the while() above, so we use it to set the new
+      // time for current_time
+      curr_time_.SetTime(head_event->event_time());
+    }
+  }
+  Registry::BindToExec(nullptr);
+  current_ = previous_exec;
+  return FinishRun();
+}  // RunEvents
+
+
+
+// The groups are dispatched on the pool, and the calling thread, as the
+// executive's own: each thread is made to see it as current, and bound
+// for the registry's types.  The events are deleted back on the calling
+// thread, where they may have come from an arena.
+//
+// "Registry" - the EventRegistry that dispatches each event
+// "first_event" - the event at the head of the queue, already popped
+template <class Registry>
+void SimExec::DispatchConflictGroups(SimBaseEvent *first_event) {
+  GatherConflictGroups(first_event);
+  if (group_count_ == 1) {
+    // Nothing to run alongside, so no staging either
+    for (SimBaseEvent *event : groups_[0].events) {
+      Registry::Dispatch(event);
+    }
+  } else {
+    dispatching_groups_ = true;
+    dispatch_pool_->RunTasks(group_count_, [this](size_t group) {
+      current_ = this;
+      Registry::BindToExec(this);
+      group_scheduled_ = &groups_[group].scheduled;
+      for (SimBaseEvent *event : groups_[group].events) {
+        Registry::Dispatch(event);
+      }
+      group_scheduled_ = nullptr;
+    });
+    dispatching_groups_ = false;
+    for (size_t group = 0; group < group_count_; ++group) {
+      parallel_dispatches_ += groups_[group].events.size();
+    }
+  }
+  FinishConflictGroups();
+}  // DispatchConflictGroups
+
 #endif   // SIM_DESIM_SIM_EXEC_HPP_
@@ -38,11 +38,20 @@ constexpr SimTime::UserTime kReadPeriod = 1.0E3;
 
 // Member initializer list takes care of all required initialization.
 StimLoader::StimLoader() : read_until_(0.0), ready_(false),
-                           stim_event_time_(0.0) {
+                           stim_event_time_(0.0), exec_(nullptr),
+                           look_ahead_(false), prefetch_(false),
+                           prefetch_state_(kPrefetchIdle),
+                           prefetch_success_(false),
+                           prefetch_stopping_(false), prefetch_stalls_(0) {
 }  // StimLoader
 
 
 StimLoader::~StimLoader() {
+  StopPrefetch();
+  // Anything still staged never reached the executive
+  for (SimBaseEvent *event : staged_events_) {
+    delete event;
+  }
   if (stim_file_.is_open()) {
     stim_file_.close();
   }
@@ -162,12 +171,57 @@ bool StimLoader::LoadQueue() {
   // be passed along to the simulator with the next batch of stimulus
   // entries.
 
-  // Tells the method to use the data already "buffered" in this object
-  // to generate the first event for this pass.
-  static bool look_ahead = false;
-  // The stimulus will be read until a record is encountered with a 
-  //  time field that exceeds this value.
-  static SimTime::UserTime end_read_time;
+  // With prefetch on, every window but the first has been read ahead
+  bool success = false;
+  if (prefetch_ && prefetch_thread_.joinable()) {
+    success = WaitForPrefetch();
+  } else {
+    success = ReadWindow();
+  }
+
+  // Hand the whole window to the executive at once.  This happens before
+  // the timer is scheduled, so stimulus at the timer's time is still
+  // dispatched ahead of the timer.
+  SubmitStagedEvents();
+  if (success || StimFileOK()){
+    // Either successfully read something in this pass, or there is still
+    // more stimulus in the file. Post a timer event to make another pass.
+    // If nothing was read in this pass, but there is still stimulus data
+    // in the file, schedule another pass
+    // If the current group of reads reached EOF, the loadQueue from the
+    // timer created here will not be successful, but the simulation may
+    // proceed without additional stimulus.
+    if (success) {
+      // Found at least one stimulus record, so set next read increment
+      // using the last record read as a time baseline
+      read_until_ = stim_event_time_ + kReadPeriod;
+    } else {
+      // Did not find any records in this period, use the current read period
+      // as the time baseline to try to find something
+      read_until_ += kReadPeriod;
+    } // not success, but more to read
+    // Create a time object with the current event time, so that the timer
+    // fires at a time consistent with the most recently read object.
+
+    // Schedule a timer event that will call for the next batch of events
+    // to be loaded.  Use the current event time, so that the timer fires at a
+    // time coincident with the most recently read object.  The compiler will
+    //  generate code to convert the "time" to a SimTime object.
+    exec_->ScheduleEvent(new LoadStimTimerEvent(stim_event_time_, this));
+    // The timer is scheduled, so the next window may be read now
+    if (prefetch_) {
+      StartPrefetch();
+    }
+  } // either success, or more to read
+  return success;
+}  // loadQueue
+
+
+// Reads records until one is at, or past, the end of the window, and
+// keeps that one for the next window.
+//
+// Returns - "true" if at least one record was read
+bool StimLoader::ReadWindow() {
   // Status of the most recent read attempt
   bool success = false;
   // stim_event_time_ should be set either from OpenStimFile(), which
@@ -175,12 +229,12 @@ bool StimLoader::LoadQueue() {
   // through LoadQueue()
   read_until_ = stim_event_time_ + kReadPeriod;
 
-  if (look_ahead) {
+  if (look_ahead_) {
     // There is data buffered from the previous read, post it now
     PostEvent();
-    look_ahead = false;
+    look_ahead_ = false;
   }
-  if (stim_file_.is_open()) {
+  if (StimSourceOpen()) {
     // stim_event_time_ has an initial value either from OpenStimFile(),
     // (which we know succeeded because of the ready_ flag), or the last
     // pass through LoadQueue().
@@ -207,40 +261,92 @@ bool StimLoader::LoadQueue() {
       } else {
         // Read progressed beyond the maximum time, need to buffer the
         // values for the next pass
-        look_ahead = true;
+        look_ahead_ = true;
       } // Has the reader reached the end of this period.
     }  // Either out of time, or end of file
     
   } // stimFile.is_open()
-  if (success || StimFileOK()){
-    // Either successfully read something in this pass, or there is still
-    // more stimulus in the file. Post a timer event to make another pass.
-    // If nothing was read in this pass, but there is still stimulus data
-    // in the file, schedule another pass
-    // If the current group of reads reached EOF, the loadQueue from the
-    // timer created here will not be successful, but the simulation may
-    // proceed without additional stimulus.
-    if (success) {
-      // Found at least one stimulus record, so set next read increment
-      // using the last record read as a time baseline
-      read_until_ = stim_event_time_ + kReadPeriod;
-    } else {
-      // Did not find any records in this period, use the current read period
-      // as the time baseline to try to find something
-      read_until_ += kReadPeriod;
-    } // not success, but more to read
-    // Create a time object with the current event time, so that the timer
-    // fires at a time consistent with the most recently read object.
-
-    // Schedule a timer event that will call for the next batch of events
-    // to be loaded.  Use the current event time, so that the timer fires at a
-    // time coincident with the most recently read object.  The compiler will
-    //  generate code to convert the "time" to a SimTime object.
-    SimExec::the_exec()->ScheduleEvent(new LoadStimTimerEvent(stim_event_time_, 
-                                                              this));
-  } // either success, or more to read
   return success;
-}  // loadQueue
+}  // ReadWindow
+
+
+// The staging vector keeps its capacity, so after the first window the
+// staging itself doesn't allocate.
+void StimLoader::SubmitStagedEvents() {
+  if (!staged_events_.empty()) {
+    exec_->ScheduleEvents(staged_events_);
+    staged_events_.clear();
+  }
+}  // SubmitStagedEvents
+
+
+// The thread is started with the first window read ahead, so that loaders
+// without prefetch never start one.
+void StimLoader::StartPrefetch() {
+  if (!prefetch_thread_.joinable()) {
+    prefetch_thread_ = std::thread(&StimLoader::PrefetchLoop, this);
+  }
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    prefetch_state_ = kPrefetchReading;
+  }
+  prefetch_changed_.notify_all();
+}  // StartPrefetch
+
+
+// Returns - the result of the window's ReadWindow()
+bool StimLoader::WaitForPrefetch() {
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  if (prefetch_state_ == kPrefetchReading) {
+    ++prefetch_stalls_;
+  }
+  prefetch_changed_.wait(lock, [this] {
+    return prefetch_state_ != kPrefetchReading;
+  });
+  prefetch_state_ = kPrefetchIdle;
+  return prefetch_success_;
+}  // WaitForPrefetch
+
+
+// A window that is being read is finished, since ReadStimRecord() can't
+// be interrupted.  Its events are deleted with the loader.
+void StimLoader::StopPrefetch() {
+  if (!prefetch_thread_.joinable()) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(prefetch_mutex_);
+    prefetch_changed_.wait(lock, [this] {
+      return prefetch_state_ != kPrefetchReading;
+    });
+    prefetch_stopping_ = true;
+  }
+  prefetch_changed_.notify_all();
+  prefetch_thread_.join();
+}  // StopPrefetch
+
+
+// Reads one window each time StartPrefetch() asks for one.
+void StimLoader::PrefetchLoop() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(prefetch_mutex_);
+      prefetch_changed_.wait(lock, [this] {
+        return prefetch_stopping_ || (prefetch_state_ == kPrefetchReading);
+      });
+      if (prefetch_stopping_) {
+        return;
+      }
+    }
+    const bool success = ReadWindow();
+    {
+      std::lock_guard<std::mutex> lock(prefetch_mutex_);
+      prefetch_success_ = success;
+      prefetch_state_ = kPrefetchReady;
+    }
+    prefetch_changed_.notify_all();
+  }
+}  // PrefetchLoop
 
 
 // Current status of the stimulus file.
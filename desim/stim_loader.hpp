@@ -25,6 +25,15 @@
 *
 *     See ../examples/text_event/ for examples of working with the
 *     derived classes.
+*
+*     Prefetch - by default, each window of stimulus is read when its
+*             timer fires, so the run waits on the stimulus file once per
+*             window.  With prefetch on (see set_prefetch()), a thread of
+*             the loader's own reads the next window while the executive
+*             runs the current one, and the timer just hands the window
+*             that is ready to the executive.  ReadStimRecord() and
+*             PostEvent() then run on that thread, so derived classes must
+*             keep to their own members in them.
 *   
 *   STATUS:  Prototype
 *   VERSION:  1.00
@@ -39,10 +48,16 @@
 #ifndef SIM_DESIM_STIM_LOADER_HPP_
 #define SIM_DESIM_STIM_LOADER_HPP_
 
+#include <stdint.h>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "sim_time.hpp"
 #include "sim_base_event.hpp"
 
+class SimExec;
 
 class StimLoader {
 
@@ -57,7 +72,9 @@ class StimLoader {
   // check for stimulus file existance, and readability before attempting
   // to construct this object, unless it's OK to just crash here.
   StimLoader();
-  ~StimLoader();
+  // Stops the prefetch thread, if there is one, and deletes any events
+  // read but not yet scheduled.
+  virtual ~StimLoader();
 
   // Loads the initial set of stimulus.  After this call, the data is ready
   // for the simulator to run.  StartLoadingOrDie() either succeeds, or the
@@ -70,6 +87,13 @@ class StimLoader {
   //       "false" otherwise
   virtual bool StimFileOK();
 
+  // Whether there is a source of stimulus records at all.  Loaders that
+  // read their records from somewhere other than "stim_file_" override
+  // this, along with StimFileOK() and ReadStimRecord().
+  //
+  // Returns - "true" if the stimulus file is open, "false" otherwise
+  virtual bool StimSourceOpen() { return stim_file_.is_open(); };
+
   // The stimulus loader works on blocks of events bounded by an upper
   //       time limit.
   //
@@ -85,6 +109,29 @@ class StimLoader {
   // Returns - "true" as long as more stimulus is loaded onto queue, 
   //       "false" otherwise
   virtual bool LoadQueue();
+
+  // Turns prefetch on or off.  Must be called before SimExec::Init(),
+  // which loads the first window.
+  //
+  // "prefetch" - "true" to read each window ahead, on a separate thread
+  void set_prefetch(bool prefetch) { prefetch_ = prefetch; };
+  // Returns - "true" if windows are read ahead
+  bool prefetch() const { return prefetch_; };
+
+  // Waits for the window being read ahead, if any, and stops the prefetch
+  // thread.  Called by SimExec before it deletes the loader.  Derived
+  // loaders deleted otherwise must call it in their destructor, since the
+  // thread calls their ReadStimRecord() and PostEvent().
+  void StopPrefetch();
+
+  // Returns - the number of timers that had to wait for their window to
+  //       be read ahead, for tuning the read period
+  uint64_t prefetch_stall_count() const { return prefetch_stalls_; };
+
+  // Called by SimExec::Init(), before StartLoadingOrDie().
+  //
+  // "exec" - the executive the stimulus is scheduled with
+  void set_exec(SimExec *exec) { exec_ = exec; };
  
  protected:
   // Attempts to open the stimulus file at the specified path
@@ -98,9 +145,32 @@ class StimLoader {
 
   // Utility method to post a single event to the event queue.  Derived
   // classes must redefine this method with the proper arguments to
-  // construct an appropriate event object.
+  // construct an appropriate event object.  The new event should be
+  // handed to StageEvent(), rather than scheduled directly, so that the
+  // whole window reaches the executive in one batch.
   virtual void PostEvent() = 0;
 
+  // Holds an event read from the stimulus file until the end of the
+  // current window.  LoadQueue() then schedules all of the staged events
+  // with a single call to the executive's ScheduleEvents().
+  //
+  // "new_event" - the event to stage.  The loader, and then the executive,
+  //       take responsibility for its memory.
+  void StageEvent(SimBaseEvent *new_event) {
+    staged_events_.push_back(new_event);
+  };
+
+  // Schedules all of the staged events, in the order in which they were
+  // staged, and empties the staging area.
+  void SubmitStagedEvents();
+
+  // Reads one window of stimulus records, starting with the record read
+  // ahead by the previous window, if any, and stages its events.  Runs on
+  // the prefetch thread, when prefetch is on.
+  //
+  // Returns - "true" if at least one record was read
+  bool ReadWindow();
+
   // Loads a single record from the stimulus file.  Must be redefined by
   // derived classes to implement each specific record type.
   //
@@ -133,7 +203,51 @@ class StimLoader {
   // Event time, in UserTime, as read
   SimTime::UserTime stim_event_time_;
 
+  // Executive the stimulus is scheduled with.  Set by the executive, so
+  // that a loader never reaches for another simulation's executive.
+  SimExec *exec_;
+
  private:
+  // Events posted in the current window, not yet scheduled.  Kept between
+  // windows so that its storage is reused.
+  std::vector<SimBaseEvent *> staged_events_;
+
+  // Set when the record read last is past the end of its window, so that
+  // the next LoadQueue() posts it first.  Kept per loader, since every
+  // simulation reads its stimulus separately.
+  bool look_ahead_;
+
+  // Starts reading the next window on the prefetch thread, starting the
+  // thread, if need be.
+  void StartPrefetch();
+
+  // Waits for the window being read ahead.
+  //
+  // Returns - the result of its ReadWindow()
+  bool WaitForPrefetch();
+
+  // Loop of the prefetch thread
+  void PrefetchLoop();
+
+  // State of the window being read ahead
+  enum PrefetchState {
+    kPrefetchIdle,
+    kPrefetchReading,
+    kPrefetchReady
+  };
+
+  // Prefetch mode, and its thread.  Everything ReadWindow() touches is
+  // handed between the executive's thread and the prefetch thread under
+  // "prefetch_mutex_", so only one of them uses it at a time.
+  bool prefetch_;
+  std::thread prefetch_thread_;
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_changed_;
+  PrefetchState prefetch_state_;
+  bool prefetch_success_;
+  bool prefetch_stopping_;
+  uint64_t prefetch_stalls_;
+
   // Flag signifying that the stimulus loader is ready for business.  Will 
   // be true if the stimulus file is open and apparently valid as well as
   // if the time baseline is set from the stimulus file.  See the acccessor/
@@ -0,0 +1,76 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring a reusable barrier for the threads of a
+*     parallel executive in the Discrete Event Simulation system.
+*     The last thread to arrive runs a given callable, e.g. to combine what
+*     every thread reported, before any of them is released, so the
+*     callable sees every thread stopped.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_THREAD_BARRIER_HPP_
+#define SIM_DESIM_THREAD_BARRIER_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <mutex>
+
+#include "basic_defs.hpp"
+
+
+class ThreadBarrier {
+ public:
+  // "thread_count" - number of threads that must arrive each time
+  explicit ThreadBarrier(size_t thread_count)
+      : thread_count_(thread_count), arrived_(0), generation_(0) {};
+  ~ThreadBarrier() {};
+
+  // Blocks until every thread has arrived.  The last to arrive calls
+  // "last" before releasing the others.
+  //
+  // "last" - called with no arguments, while every thread is stopped
+  template <typename Callable>
+  void Arrive(const Callable &last) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const uint64_t generation = generation_;
+    if (++arrived_ == thread_count_) {
+      arrived_ = 0;
+      last();
+      ++generation_;
+      released_.notify_all();
+    } else {
+      released_.wait(lock, [this, generation] {
+        return generation_ != generation;
+      });
+    }
+  }
+
+  // Blocks until every thread has arrived.
+  void Arrive() {
+    Arrive([] {});
+  }
+
+ private:
+  size_t thread_count_;
+  std::mutex mutex_;
+  std::condition_variable released_;
+  // Threads arrived so far in this generation
+  size_t arrived_;
+  // Number of times every thread has arrived
+  uint64_t generation_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(ThreadBarrier);
+}; // class ThreadBarrier
+
+#endif   // SIM_DESIM_THREAD_BARRIER_HPP_
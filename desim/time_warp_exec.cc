@@ -0,0 +1,156 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the optimistic (Time Warp) parallel executive for the Discrete
+*     Event Simulation system.  See time_warp_exec.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <chrono>
+#include <thread>
+
+#include "time_warp_exec.hpp"
+#include "common_messages.hpp"
+
+const uint64_t TimeWarpExec::kGvtInterval;
+
+// How long an LP with nothing to do waits for a message before asking for
+// a GVT round.  Asking straight away would stop the busy LPs over and
+// over while one LP idles.
+static const std::chrono::microseconds kIdleWait(1000);
+
+
+// Lowers "minimum" to "value", if "value" is less, without a lock.
+//
+// "minimum" - the shared minimum
+// "value" - the candidate
+static void LowerTo(std::atomic<TimeWarpProcess::SimTick> *minimum,
+                    TimeWarpProcess::SimTick value) {
+  TimeWarpProcess::SimTick current = *minimum;
+  while ((value < current) &&
+         !minimum->compare_exchange_weak(current, value)) {
+  }
+}
+
+
+// "lp_count" - number of LPs, at least one
+TimeWarpExec::TimeWarpExec(uint32_t lp_count)
+    : gvt_requested_(false), round_minimum_(TimeWarpProcess::kNever),
+      round_cancel_minimum_(TimeWarpProcess::kNever), gvt_(0),
+      commit_at_gvt_(false), gvt_rounds_(0), barrier_(lp_count) {
+  if (lp_count == 0) {
+    UtilFatalErrorAndDie("TimeWarpExec needs at least one LP.");
+  }
+  for (uint32_t id = 0; id < lp_count; ++id) {
+    lps_.push_back(new TimeWarpProcess(id, &lps_));
+  }
+}
+
+
+TimeWarpExec::~TimeWarpExec() {
+  for (TimeWarpProcess *lp : lps_) {
+    delete lp;
+  }
+}
+
+
+// With a single LP nothing is ever rolled back, but the events still go
+// through the same loop, so it runs on the calling thread.
+//
+// "run_until_tm" - time at which the run ends
+// Returns - the time when the simulation ended
+SimTime TimeWarpExec::Run(const SimTime &run_until_tm) {
+  const SimTick end = run_until_tm.ticks();
+  gvt_ = 0;
+  if (lps_.size() == 1) {
+    RunLp(lps_[0], end);
+  } else {
+    std::vector<std::thread> threads;
+    for (TimeWarpProcess *lp : lps_) {
+      threads.push_back(std::thread(&TimeWarpExec::RunLp, this, lp, end));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+  SimTime last_time(0.0);
+  for (TimeWarpProcess *lp : lps_) {
+    if (last_time.EarlierThan(lp->committed_time())) {
+      last_time = lp->committed_time();
+    }
+  }
+  return last_time.AsEarlyAs(run_until_tm) ? last_time : run_until_tm;
+}
+
+
+// Each pass joins a GVT round if one was asked for, handles the inbox, and
+// dispatches the next event.  Every LP sees the same GVT, so they all
+// leave the loop after the same round.
+//
+// "lp" - the LP to run
+// "end" - time at which the run ends, in ticks
+void TimeWarpExec::RunLp(TimeWarpProcess *lp, SimTick end) {
+  TimeWarpProcess::current_ = lp;
+  uint64_t since_gvt = 0;
+  for (;;) {
+    if (gvt_requested_) {
+      GvtRound(lp);
+      if (gvt_ > end) {
+        break;
+      }
+      since_gvt = 0;
+      continue;
+    }
+    const uint64_t version = lp->DrainInbox();
+    if (lp->NextEventTicks() <= end) {
+      lp->DispatchNext();
+      if (++since_gvt >= kGvtInterval) {
+        RequestGvt();
+      }
+    } else if (!lp->WaitForInbox(version, gvt_requested_, kIdleWait)) {
+      RequestGvt();
+    }
+  }
+  TimeWarpProcess::current_ = nullptr;
+}
+
+
+void TimeWarpExec::RequestGvt() {
+  if (!gvt_requested_.exchange(true)) {
+    for (TimeWarpProcess *lp : lps_) {
+      lp->Wake();
+    }
+  }
+}
+
+
+// Between the two barriers no LP dispatches, so nothing is sent and each
+// LP's local minimum covers everything it could still be asked to roll
+// back to.  Every anti-message is in some inbox, so it is no earlier than
+// GVT, and events at GVT are only held back if one is at GVT.
+//
+// "lp" - the calling LP
+void TimeWarpExec::GvtRound(TimeWarpProcess *lp) {
+  barrier_.Arrive([this] {
+    gvt_requested_ = false;
+    round_minimum_ = TimeWarpProcess::kNever;
+    round_cancel_minimum_ = TimeWarpProcess::kNever;
+  });
+  SimTick cancel_minimum;
+  LowerTo(&round_minimum_, lp->LocalMinimum(&cancel_minimum));
+  LowerTo(&round_cancel_minimum_, cancel_minimum);
+  barrier_.Arrive([this] {
+    gvt_ = round_minimum_;
+    commit_at_gvt_ = (round_cancel_minimum_ > gvt_);
+    ++gvt_rounds_;
+  });
+  lp->FossilCollect(gvt_, commit_at_gvt_);
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the optimistic (Time Warp) parallel executive
+*     for the Discrete Event Simulation system.
+*     TimeWarpExec runs a model partitioned into logical processes (see
+*     TimeWarpProcess), each on its own thread.  Unlike ConservativeExec,
+*     it needs no lookahead: every LP dispatches its events as soon as it
+*     has them, and rolls back when it turns out it went too far.
+*
+*     Every so often, i.e. after an LP has dispatched "kGvtInterval" events,
+*     or when an LP has run out of work, the executive computes global
+*     virtual time (GVT).  GVT is computed synchronously, in the manner of
+*     Samadi's algorithm: every LP stops at a barrier, and since messages
+*     are delivered straight into the receivers' inboxes, nothing is in
+*     transit while they are stopped, so GVT is just the least of the LPs'
+*     next event and inbox times.  No acknowledgements are needed.  After
+*     each round, every LP commits the output of its events up to GVT and
+*     reclaims their memory.  The run ends once GVT passes the end of the
+*     run, at which point every event up to the end is committed.
+*
+*     The results match a sequential run, with the same caveat as for
+*     ConservativeExec: events at the same time on one LP may be
+*     dispatched in either order.  The LPs rely on that: a message at the
+*     same time as events an LP has already dispatched is dispatched after
+*     them, rather than rolling them back.  So a message at GVT can't undo
+*     an event at GVT, and those events are committed too.  Only an
+*     anti-message at GVT, still waiting in an inbox, can undo one, since
+*     it cancels an event at GVT, along with everything dispatched after
+*     it.  Events at GVT are held back for a round while there is one.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_TIME_WARP_EXEC_HPP_
+#define SIM_DESIM_TIME_WARP_EXEC_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "thread_barrier.hpp"
+#include "time_warp_process.hpp"
+
+
+class TimeWarpExec {
+ public:
+  // Events an LP dispatches between requests for GVT.  More means less
+  // time at the barrier, but more memory held for rollback.
+  static const uint64_t kGvtInterval = 1024;
+
+  // "lp_count" - number of LPs, at least one
+  explicit TimeWarpExec(uint32_t lp_count);
+  // Deletes the LPs, and any events they still hold.
+  ~TimeWarpExec();
+
+  // Returns - the LP with index "id", for setting its state and sending
+  //       the initial events
+  TimeWarpProcess *lp(uint32_t id) { return lps_[id]; }
+  // Returns - the number of LPs
+  uint32_t lp_count() const { return static_cast<uint32_t>(lps_.size()); }
+
+  // Runs every LP on its own thread until GVT passes "run_until_tm".  As
+  // with SimExec, events later than "run_until_tm" are not dispatched.
+  //
+  // "run_until_tm" - time at which the run ends
+  // Returns - the time when the simulation ended: the time of the last
+  //       event committed, or "run_until_tm", whichever is earlier.
+  SimTime Run(const SimTime &run_until_tm);
+
+  // Returns - the number of GVT rounds
+  uint64_t gvt_round_count() const { return gvt_rounds_; }
+
+ private:
+  typedef TimeWarpProcess::SimTick SimTick;
+
+  // The optimistic loop for one LP, on its own thread.
+  //
+  // "lp" - the LP to run
+  // "end" - time at which the run ends, in ticks
+  void RunLp(TimeWarpProcess *lp, SimTick end);
+
+  // Asks every LP to join a GVT round.
+  void RequestGvt();
+
+  // Takes part in a GVT round, then fossil collects.
+  //
+  // "lp" - the calling LP
+  void GvtRound(TimeWarpProcess *lp);
+
+  std::vector<TimeWarpProcess *> lps_;
+
+  // Set when an LP asks for a GVT round, cleared once every LP has joined
+  std::atomic<bool> gvt_requested_;
+  // Least local minimum, and earliest anti-message, reported in the
+  // current round
+  std::atomic<SimTick> round_minimum_;
+  std::atomic<SimTick> round_cancel_minimum_;
+  // Result of the latest round, and whether events at GVT may be
+  // committed.  Written while every LP is stopped.
+  SimTick gvt_;
+  bool commit_at_gvt_;
+  uint64_t gvt_rounds_;
+  ThreadBarrier barrier_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(TimeWarpExec);
+}; // class TimeWarpExec
+
+#endif   // SIM_DESIM_TIME_WARP_EXEC_HPP_
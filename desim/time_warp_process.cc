@@ -0,0 +1,280 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the optimistic logical process for Time Warp execution in the
+*     Discrete Event Simulation system.  See time_warp_process.hpp for an
+*     overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <iostream>
+
+#include "time_warp_process.hpp"
+#include "common_strings.hpp"
+
+const TimeWarpProcess::SimTick TimeWarpProcess::kNever;
+
+thread_local TimeWarpProcess *TimeWarpProcess::current_ = nullptr;
+
+// A message's identity is the sending LP's id in the high bits, and its
+// count of sends in the rest.
+static const int kSendCountBits = 40;
+
+
+// "id" - index of this LP in its executive
+// "lps" - every LP of the executive, indexed by id, including this one
+TimeWarpProcess::TimeWarpProcess(uint32_t id,
+                                 const std::vector<TimeWarpProcess *> *lps)
+    : id_(id), lps_(lps), curr_time_(0.0), committed_time_(0.0),
+      state_(nullptr), current_entry_(nullptr), send_count_(0),
+      inbox_version_(0), dispatched_count_(0), committed_count_(0),
+      rolled_back_count_(0), anti_message_count_(0) {
+}
+
+
+// Events still held were sent for after the end of the run, or were never
+// committed.  Their output is dropped.
+TimeWarpProcess::~TimeWarpProcess() {
+  for (ProcessedEntry &entry : processed_) {
+    for (CallbackEvent *output : entry.outputs) {
+      delete output;
+    }
+    delete entry.saved_state;
+    delete entry.event;
+  }
+  for (const InboxEntry &entry : inbox_) {
+    delete entry.event;
+  }
+  pending_.Clear();
+  delete state_;
+}
+
+
+// "state" - the model state of this LP
+void TimeWarpProcess::set_state(LpState *state) {
+  delete state_;
+  state_ = state;
+}
+
+
+// Events sent before the run starts can't be cancelled, since no event
+// sent them.
+//
+// "to" - index of the receiving LP
+// "new_event" - the event to send
+// Returns - "true" if the event was sent
+bool TimeWarpProcess::SendEvent(uint32_t to, TimeWarpEvent *new_event) {
+  if (to >= lps_->size()) {
+    std::cerr << kCommonStrError << "LP " << id_ << " attempted to send "
+                 "event to LP " << to << ", which doesn't exist." << std::endl;
+    delete new_event;
+    return false;
+  }
+  if (new_event->EarlierThan(curr_time_)) {
+    std::cerr << kCommonStrError << "LP " << id_ << " attempted to send "
+                 "event in the past.  Event Time: "
+              << new_event->event_time().GetUserTime()
+              << " Current LP Time: " << curr_time_.GetUserTime()
+              << std::endl;
+    delete new_event;
+    return false;
+  }
+  const uint64_t message_key =
+      (static_cast<uint64_t>(id_) << kSendCountBits) | send_count_++;
+  const SimTick time = new_event->event_time().ticks();
+  new_event->message_key_ = message_key;
+  if (current_entry_ != nullptr) {
+    SentRecord record = {to, message_key, time};
+    current_entry_->sent.push_back(record);
+  }
+  if (to == id_) {
+    Receive(new_event, message_key);
+  } else {
+    InboxEntry entry = {new_event, message_key, time};
+    (*lps_)[to]->Deliver(entry);
+  }
+  return true;
+}
+
+
+// "entry" - the message, or anti-message
+void TimeWarpProcess::Deliver(const InboxEntry &entry) {
+  std::lock_guard<std::mutex> lock(inbox_mutex_);
+  inbox_.push_back(entry);
+  ++inbox_version_;
+  inbox_changed_.notify_one();
+}
+
+
+// A sender delivers a message before any anti-message for it, so
+// handling the inbox in order always finds the event to cancel.
+//
+// Returns - the inbox version that was drained
+uint64_t TimeWarpProcess::DrainInbox() {
+  uint64_t version;
+  {
+    std::lock_guard<std::mutex> lock(inbox_mutex_);
+    drained_.swap(inbox_);
+    version = inbox_version_;
+  }
+  for (const InboxEntry &entry : drained_) {
+    if (entry.event != nullptr) {
+      Receive(entry.event, entry.message_key);
+    } else {
+      Annihilate(entry.message_key);
+    }
+  }
+  drained_.clear();
+  return version;
+}
+
+
+// Locking the inbox means the waiting thread either sees the executive's
+// flag before it waits, or is already waiting and gets the notification.
+void TimeWarpProcess::Wake() {
+  std::lock_guard<std::mutex> lock(inbox_mutex_);
+  inbox_changed_.notify_one();
+}
+
+
+// Returns - the time of the earliest pending event, or "kNever"
+TimeWarpProcess::SimTick TimeWarpProcess::NextEventTicks() {
+  return pending_.Empty() ? kNever :
+                            pending_.PeekMin()->event_time().ticks();
+}
+
+
+void TimeWarpProcess::DispatchNext() {
+  TimeWarpEvent *head_event = static_cast<TimeWarpEvent *>(pending_.PopMin());
+  ProcessedEntry entry;
+  entry.event = head_event;
+  entry.saved_state = (state_ != nullptr) ? state_->Clone() : nullptr;
+  processed_.push_back(std::move(entry));
+  current_entry_ = &processed_.back();
+  curr_time_.SetTime(head_event->event_time());
+  head_event->Dispatch();
+  current_entry_ = nullptr;
+  ++dispatched_count_;
+}
+
+
+// Events at the same time as the message needn't roll back, since
+// same-time events may be dispatched in any order.  FossilCollect()
+// relies on this to commit events at GVT.
+//
+// "event" - the message
+// "message_key" - its identity
+void TimeWarpProcess::Receive(TimeWarpEvent *event, uint64_t message_key) {
+  live_[message_key] = event;
+  const SimTick time = event->event_time().ticks();
+  while (!processed_.empty() &&
+         (processed_.back().event->event_time().ticks() > time)) {
+    UndoLast();
+  }
+  pending_.Push(event);
+}
+
+
+// "message_key" - identity of the event to cancel
+void TimeWarpProcess::Annihilate(uint64_t message_key) {
+  std::unordered_map<uint64_t, TimeWarpEvent *>::iterator found =
+      live_.find(message_key);
+  if (found == live_.end()) {
+    std::cerr << kCommonStrError << "LP " << id_ << " received an "
+                 "anti-message for an unknown event." << std::endl;
+    return;
+  }
+  TimeWarpEvent *event = found->second;
+  live_.erase(found);
+  if (!pending_.Remove(event)) {
+    // Already dispatched, so undo everything back to, and including, it
+    TimeWarpEvent *undone;
+    do {
+      undone = processed_.back().event;
+      UndoLast();
+    } while (undone != event);
+    pending_.Remove(event);
+  }
+  delete event;
+  ++anti_message_count_;
+}
+
+
+// Events the undone event sent to this LP were dispatched after it, if at
+// all, so they are back among the pending events by now and can be
+// cancelled directly.
+void TimeWarpProcess::UndoLast() {
+  ProcessedEntry entry = std::move(processed_.back());
+  processed_.pop_back();
+  if (entry.saved_state != nullptr) {
+    state_->Restore(*entry.saved_state);
+    delete entry.saved_state;
+  }
+  for (CallbackEvent *output : entry.outputs) {
+    delete output;
+  }
+  for (const SentRecord &record : entry.sent) {
+    if (record.to == id_) {
+      Annihilate(record.message_key);
+    } else {
+      InboxEntry anti_message = {nullptr, record.message_key, record.time};
+      (*lps_)[record.to]->Deliver(anti_message);
+    }
+  }
+  pending_.Push(entry.event);
+  ++rolled_back_count_;
+}
+
+
+// "cancel_minimum" - receives the time of the earliest anti-message
+// Returns - the earliest time this LP could still roll back to
+TimeWarpProcess::SimTick TimeWarpProcess::LocalMinimum(
+    SimTick *cancel_minimum) {
+  SimTick minimum = NextEventTicks();
+  *cancel_minimum = kNever;
+  std::lock_guard<std::mutex> lock(inbox_mutex_);
+  for (const InboxEntry &entry : inbox_) {
+    minimum = (entry.time < minimum) ? entry.time : minimum;
+    if ((entry.event == nullptr) && (entry.time < *cancel_minimum)) {
+      *cancel_minimum = entry.time;
+    }
+  }
+  return minimum;
+}
+
+
+// Nothing earlier than GVT can be rolled back, so the output is final and
+// the saved state and events are no longer needed.  A message at GVT
+// can't roll back events at GVT either, see Receive(), but an
+// anti-message at GVT cancels an event at GVT, and undoes everything
+// dispatched after it, so events at GVT wait while there is one.
+//
+// "gvt" - global virtual time
+// "commit_at_gvt" - "true" if events at "gvt" may be committed
+void TimeWarpProcess::FossilCollect(SimTick gvt, bool commit_at_gvt) {
+  while (!processed_.empty()) {
+    const SimTick time = processed_.front().event->event_time().ticks();
+    if ((time > gvt) || ((time == gvt) && !commit_at_gvt)) {
+      break;
+    }
+    ProcessedEntry &entry = processed_.front();
+    for (CallbackEvent *output : entry.outputs) {
+      output->Dispatch();
+      delete output;
+    }
+    delete entry.saved_state;
+    live_.erase(entry.event->message_key_);
+    committed_time_.SetTime(entry.event->event_time());
+    delete entry.event;
+    ++committed_count_;
+    processed_.pop_front();
+  }
+}
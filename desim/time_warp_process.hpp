@@ -0,0 +1,300 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the optimistic logical process for Time Warp
+*     execution in the Discrete Event Simulation system.
+*     A TimeWarpProcess dispatches its events as soon as it has them,
+*     without waiting to find out whether an earlier event is still on its
+*     way from another LP.  If one arrives (a "straggler"), the LP rolls
+*     back: it restores the model state saved before the first event later
+*     than the straggler, cancels everything those events sent, by sending
+*     "anti-messages" after them, drops their output, and dispatches them
+*     again in the right order.
+*
+*     To make that possible:
+*     - the model keeps the state of each LP in an LpState, which the LP
+*       copies before every event, and
+*     - events are TimeWarpEvents, which carry an identity so that they
+*       can be cancelled, and are kept until they can no longer be rolled
+*       back.
+*     Output, such as log records, must be handed to CommitOutput(), which
+*     holds it until the event that produced it is committed.
+*
+*     An event is committed once global virtual time (GVT), the earliest
+*     time of any event or message still to be handled, has reached it,
+*     and no anti-message at GVT is still waiting to cancel it.  The
+*     executive (TimeWarpExec) computes GVT, and then each LP commits the
+*     output of its events up to GVT, and reclaims their memory and saved
+*     state (fossil collection).
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_TIME_WARP_PROCESS_HPP_
+#define SIM_DESIM_TIME_WARP_PROCESS_HPP_
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "callback_event.hpp"
+#include "event_heap.hpp"
+
+
+// The model state of one LP.  The LP saves a copy before every event, and
+// restores one when it rolls back.
+class LpState {
+ public:
+  LpState() {};
+  virtual ~LpState() {};
+
+  // Returns - a new copy of this state.  The caller takes responsibility
+  //       for its memory.
+  virtual LpState *Clone() const = 0;
+
+  // Sets this state to a copy made earlier by Clone().
+  //
+  // "saved" - the copy to restore
+  virtual void Restore(const LpState &saved) = 0;
+
+ private:
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(LpState);
+}; // class LpState
+
+
+// Base class for the events of a Time Warp model.  Dispatch() may run more
+// than once, if the event is rolled back, so it must only change the LP's
+// LpState, send events through the LP, and hand output to CommitOutput().
+class TimeWarpEvent : public SimBaseEvent {
+ public:
+  // "event_time" - time at which the event is to be dispatched
+  explicit TimeWarpEvent(const SimTime &event_time)
+      : SimBaseEvent(event_time), message_key_(0) {};
+  virtual ~TimeWarpEvent() {};
+
+ private:
+  friend class TimeWarpProcess;
+  // Identity of the event: the sending LP, and its count of sends
+  uint64_t message_key_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(TimeWarpEvent);
+}; // class TimeWarpEvent
+
+
+class TimeWarpProcess {
+ public:
+  typedef SimTime::SimTick SimTick;
+  // A time later than that of any event
+  static const SimTick kNever = UINT64_MAX;
+
+  // "id" - index of this LP in its executive
+  // "lps" - every LP of the executive, indexed by id, including this one
+  TimeWarpProcess(uint32_t id, const std::vector<TimeWarpProcess *> *lps);
+  // Deletes the state, and every event and output still held.
+  ~TimeWarpProcess();
+
+  // Returns - index of this LP in its executive
+  uint32_t id() const { return id_; }
+
+  // Returns - the time of the event being dispatched, or most recently
+  //       dispatched
+  SimTime curr_time() const { return curr_time_; }
+  // Returns - the time of the latest committed event
+  SimTime committed_time() const { return committed_time_; }
+
+  // Returns - the model state of this LP
+  LpState *state() { return state_; }
+  // "state" - the model state of this LP.  The LP takes responsibility for
+  //       its memory.
+  void set_state(LpState *state);
+
+  // Sends an event to an LP, which may be this one.  Events earlier than
+  // this LP's current time are rejected with an error message, and
+  // deleted.  If the sending event is rolled back, the event is cancelled.
+  //
+  // "to" - index of the receiving LP
+  // "new_event" - the event to send.  The receiving LP takes
+  //       responsibility for it.
+  // Returns - "true" if the event was sent
+  bool SendEvent(uint32_t to, TimeWarpEvent *new_event);
+
+  // Holds output, e.g. writing a log record, until the event being
+  // dispatched is committed.  The output is dropped if the event is rolled
+  // back.  Outputs are committed in time order, on this LP's thread.
+  //
+  // "output" - called with no arguments once the event is committed
+  template <typename Callable>
+  void CommitOutput(Callable &&output) {
+    current_entry_->outputs.push_back(
+        new CallbackEvent(curr_time_, std::forward<Callable>(output)));
+  }
+
+  // Counters, for tuning.  Read them after the run.
+  //
+  // Returns - events dispatched, including those later rolled back
+  uint64_t dispatched_count() const { return dispatched_count_; }
+  // Returns - events committed
+  uint64_t committed_count() const { return committed_count_; }
+  // Returns - events rolled back
+  uint64_t rolled_back_count() const { return rolled_back_count_; }
+  // Returns - anti-messages sent
+  uint64_t anti_message_count() const { return anti_message_count_; }
+
+  // Returns - the LP dispatching events on the calling thread, or nullptr
+  static TimeWarpProcess *current() { return current_; }
+
+ private:
+  friend class TimeWarpExec;
+
+  // An event that was sent: where to, its identity, and its time
+  struct SentRecord {
+    uint32_t to;
+    uint64_t message_key;
+    SimTick time;
+  };
+
+  // A dispatched event, with what is needed to undo it
+  struct ProcessedEntry {
+    TimeWarpEvent *event;
+    // The LP's state before the event
+    LpState *saved_state;
+    std::vector<SentRecord> sent;
+    std::vector<CallbackEvent *> outputs;
+  };
+
+  // A message in the inbox.  Anti-messages have no event.
+  struct InboxEntry {
+    TimeWarpEvent *event;
+    uint64_t message_key;
+    SimTick time;
+  };
+
+  // Called by the sending LP, on its own thread.
+  //
+  // "entry" - the message, or anti-message
+  void Deliver(const InboxEntry &entry);
+
+  // Handles the messages in the inbox, rolling back if any of them is a
+  // straggler, or cancels an event already dispatched.
+  //
+  // Returns - the inbox version that was drained, for WaitForInbox()
+  uint64_t DrainInbox();
+
+  // Blocks until the inbox changes from "version", "wake" is set, or
+  // "timeout" passes.
+  //
+  // "version" - the version returned by DrainInbox()
+  // "wake" - flag that ends the wait early
+  // "timeout" - longest wait
+  // Returns - "false" if the wait timed out
+  template <typename Flag>
+  bool WaitForInbox(uint64_t version, const Flag &wake,
+                    std::chrono::microseconds timeout) {
+    std::unique_lock<std::mutex> lock(inbox_mutex_);
+    return inbox_changed_.wait_for(lock, timeout, [this, version, &wake] {
+      return (inbox_version_ != version) || wake;
+    });
+  }
+
+  // Wakes WaitForInbox(), e.g. when the executive starts a GVT round.
+  void Wake();
+
+  // Returns - the time of the earliest pending event, or "kNever"
+  SimTick NextEventTicks();
+
+  // Saves the state, and dispatches the earliest pending event.
+  void DispatchNext();
+
+  // Handles a message that arrived from another LP, or this one.
+  //
+  // "event" - the message
+  // "message_key" - its identity
+  void Receive(TimeWarpEvent *event, uint64_t message_key);
+
+  // Cancels the event with "message_key", rolling back if it was already
+  // dispatched.
+  //
+  // "message_key" - identity of the event to cancel
+  void Annihilate(uint64_t message_key);
+
+  // Undoes the most recently dispatched event, and puts it back in the
+  // pending events.
+  void UndoLast();
+
+  // Only valid while no LP is sending.
+  //
+  // "cancel_minimum" - receives the time of the earliest anti-message in
+  //       the inbox, or "kNever"
+  // Returns - the earliest time this LP could still roll back to: its
+  //       next pending event, or the earliest message in its inbox.
+  SimTick LocalMinimum(SimTick *cancel_minimum);
+
+  // Commits, and reclaims, every dispatched event earlier than "gvt",
+  // and those at "gvt" if "commit_at_gvt".
+  //
+  // "gvt" - global virtual time
+  // "commit_at_gvt" - "true" if no anti-message at "gvt" is waiting in
+  //       any inbox
+  void FossilCollect(SimTick gvt, bool commit_at_gvt);
+
+  // Index of this LP in its executive
+  uint32_t id_;
+  // Every LP of the executive
+  const std::vector<TimeWarpProcess *> *lps_;
+  // Time of the event being, or most recently, dispatched
+  SimTime curr_time_;
+  // Time of the latest committed event
+  SimTime committed_time_;
+  LpState *state_;
+  // Events waiting to be dispatched.  Rolled back events go back here,
+  // earlier than events already dispatched, so this must be a set that
+  // accepts any time, which rules out the monotone sets.
+  EventHeap pending_;
+  // Dispatched events that may still be rolled back, in dispatch order
+  std::deque<ProcessedEntry> processed_;
+  // Entry of the event being dispatched
+  ProcessedEntry *current_entry_;
+  // Events received, and not yet committed or cancelled, by identity
+  std::unordered_map<uint64_t, TimeWarpEvent *> live_;
+  // Number of events sent so far, for their identities
+  uint64_t send_count_;
+
+  // The inbox, guarded by "inbox_mutex_".  "inbox_version_" changes with
+  // every message.
+  std::mutex inbox_mutex_;
+  std::condition_variable inbox_changed_;
+  std::vector<InboxEntry> inbox_;
+  uint64_t inbox_version_;
+  // Scratch space for draining the inbox, kept to avoid allocating
+  std::vector<InboxEntry> drained_;
+
+  uint64_t dispatched_count_;
+  uint64_t committed_count_;
+  uint64_t rolled_back_count_;
+  uint64_t anti_message_count_;
+
+  // The LP dispatching events on the calling thread
+  static thread_local TimeWarpProcess *current_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(TimeWarpProcess);
+}; // class TimeWarpProcess
+
+#endif   // SIM_DESIM_TIME_WARP_PROCESS_HPP_
@@ -0,0 +1,318 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the hierarchical timing wheel pending event set for the
+*     Discrete Event Simulation system.  See timing_wheel.hpp for an
+*     overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "timing_wheel.hpp"
+
+const unsigned int TimingWheel::kSlotBits;
+const size_t TimingWheel::kSlotCount;
+const size_t TimingWheel::kWheelCount;
+const size_t TimingWheel::kBitmapWords;
+
+// Number of tick bits covered by all of the wheels together
+constexpr static unsigned int kHorizonBits = 32;
+
+
+// Returns - the tick count of "event"
+static SimTime::SimTick EventTicks(const SimBaseEvent *event) {
+  return event->event_time().ticks();
+}
+
+
+// Returns - "true" if "ticks" is within the horizon of the wheels, when
+//       their current time is "now"
+static bool WithinHorizon(SimTime::SimTick ticks, SimTime::SimTick now) {
+  return ((ticks ^ now) >> kHorizonBits) == 0;
+}
+
+
+// "overflow" - the (empty) set that will hold events beyond the horizon
+//       of the wheels.  The wheel takes ownership of this set.
+TimingWheel::TimingWheel(PendingEventSet *overflow)
+    : now_(0), head_(0), wheel_count_(0), overflow_(overflow) {
+  static_assert(kSlotBits * kWheelCount == kHorizonBits,
+                "Wheel geometry does not match the horizon");
+  for (size_t wheel = 0; wheel < kWheelCount; ++wheel) {
+    slots_[wheel].resize(kSlotCount);
+  }
+  ResetWheels();
+}
+
+
+// The wheel doesn't own the events, but it does own the overflow set.
+TimingWheel::~TimingWheel() {
+  delete overflow_;
+}
+
+
+// Events in the past, relative to the wheels, force the wheels to be
+// rebuilt.  Otherwise, this is a straight placement.
+//
+// "new_event" - the event to place in the set
+void TimingWheel::Push(SimBaseEvent *new_event) {
+  const SimTime::SimTick ticks = EventTicks(new_event);
+  if (ticks < now_) {
+    Rebase(ticks);
+  }
+  Place(new_event);
+}
+
+
+// Returns - the earliest event, from the current slot of the first wheel
+SimBaseEvent *TimingWheel::PopMin() {
+  Advance();
+  --wheel_count_;
+  return slots_[0][SlotIndex(now_, 0)][head_++];
+}
+
+
+// Returns - the earliest event, without removing it.
+SimBaseEvent *TimingWheel::PeekMin() {
+  Advance();
+  return slots_[0][SlotIndex(now_, 0)][head_];
+}
+
+
+// An event's time determines its wheel and slot, or that it is in the
+// overflow set, so only one slot needs to be searched.  Erasing keeps the
+// order of the events that remain.
+//
+// "event" - the event to remove
+// Returns - "true" if the event was in the set
+bool TimingWheel::Remove(SimBaseEvent *event) {
+  const SimTime::SimTick ticks = EventTicks(event);
+  if (!WithinHorizon(ticks, now_)) {
+    return overflow_->Remove(event);
+  }
+  if (ticks < now_) {
+    return false;
+  }
+  const size_t wheel = WheelIndex(ticks);
+  const size_t slot = SlotIndex(ticks, wheel);
+  Slot &events_in_slot = slots_[wheel][slot];
+  const bool current = (wheel == 0) && (slot == SlotIndex(now_, 0));
+  for (size_t i = current ? head_ : 0; i < events_in_slot.size(); ++i) {
+    if (events_in_slot[i] == event) {
+      events_in_slot.erase(events_in_slot.begin() + i);
+      // The current slot is tidied up by Advance(), once it is used up
+      if (events_in_slot.empty() && !current) {
+        occupied_[wheel][slot / 64] &= ~(static_cast<uint64_t>(1) <<
+                                         (slot % 64));
+      }
+      --wheel_count_;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// Every event on the wheels is earlier than every event in the overflow
+// set, so the wheel events are sorted, and the overflow events follow.
+// The sort is stable, and each slot is in FIFO order, so FIFO order is
+// preserved.
+//
+// "events" - receives the ordered events.
+void TimingWheel::OrderedEvents(std::vector<SimBaseEvent *> *events) const {
+  GatherWheels(events);
+  std::stable_sort(events->begin(), events->end(),
+                   [](const SimBaseEvent *left, const SimBaseEvent *right) {
+                     return left->EarlierThan(*right);
+                   });
+  std::vector<SimBaseEvent *> overflow_events;
+  overflow_->OrderedEvents(&overflow_events);
+  events->insert(events->end(), overflow_events.begin(),
+                 overflow_events.end());
+}
+
+
+// Deletes every event on the wheels and in the overflow set
+void TimingWheel::Clear() {
+  std::vector<SimBaseEvent *> events;
+  GatherWheels(&events);
+  for (SimBaseEvent *event : events) {
+    delete event;
+  }
+  ResetWheels();
+  overflow_->Clear();
+  now_ = 0;
+}
+
+
+// Empties the wheels and the overflow set without touching the events.
+void TimingWheel::Discard() {
+  ResetWheels();
+  overflow_->Discard();
+  now_ = 0;
+}
+
+
+// The wheel is chosen by the highest bit in which the event's time
+// differs from "now_".  Events at "now_" itself go into the current slot
+// of the first wheel.
+//
+// "event" - the event to place.  Must not be earlier than "now_".
+void TimingWheel::Place(SimBaseEvent *event) {
+  const SimTime::SimTick ticks = EventTicks(event);
+  if (!WithinHorizon(ticks, now_)) {
+    overflow_->Push(event);
+    return;
+  }
+  const size_t wheel = WheelIndex(ticks);
+  const size_t slot = SlotIndex(ticks, wheel);
+  slots_[wheel][slot].push_back(event);
+  occupied_[wheel][slot / 64] |= static_cast<uint64_t>(1) << (slot % 64);
+  ++wheel_count_;
+}
+
+
+// Slots before the current slot of each wheel are always empty, so the
+// next events are in the first occupied slot after it on the finest wheel
+// that has one.  On the first wheel, that slot is a single tick, so
+// "now_" simply moves to it.  On a coarser wheel, "now_" moves to the
+// start of the slot, and the slot is cascaded onto the finer wheels.
+// When the wheels are empty, "now_" jumps to the earliest overflow event,
+// and everything within the new horizon is moved onto the wheels.
+void TimingWheel::Advance() {
+  while (true) {
+    const size_t current = SlotIndex(now_, 0);
+    Slot &current_slot = slots_[0][current];
+    if (head_ < current_slot.size()) {
+      return;
+    }
+    if (!current_slot.empty()) {
+      current_slot.clear();
+      occupied_[0][current / 64] &= ~(static_cast<uint64_t>(1) <<
+                                      (current % 64));
+    }
+    head_ = 0;
+
+    if (wheel_count_ == 0) {
+      // The overflow set is in dispatch order, so same time events reach
+      // their slot in FIFO order.
+      now_ = EventTicks(overflow_->PeekMin());
+      while (!overflow_->Empty() &&
+             WithinHorizon(EventTicks(overflow_->PeekMin()), now_)) {
+        Place(overflow_->PopMin());
+      }
+      continue;
+    }
+
+    for (size_t wheel = 0; wheel < kWheelCount; ++wheel) {
+      const size_t slot = NextOccupied(wheel);
+      if (slot == kSlotCount) {
+        continue;
+      }
+      const unsigned int shift = kSlotBits * wheel;
+      now_ = ((now_ >> (shift + kSlotBits)) << (shift + kSlotBits)) |
+             (static_cast<SimTime::SimTick>(slot) << shift);
+      if (wheel > 0) {
+        // Swapping with "cascade_" leaves both the slot and "cascade_"
+        // with storage to reuse.  Nothing cascades onto a wheel as coarse
+        // as this one, so the slot stays empty while the events are placed.
+        cascade_.swap(slots_[wheel][slot]);
+        occupied_[wheel][slot / 64] &= ~(static_cast<uint64_t>(1) <<
+                                         (slot % 64));
+        wheel_count_ -= cascade_.size();
+        for (SimBaseEvent *event : cascade_) {
+          Place(event);
+        }
+        cascade_.clear();
+      }
+      break;
+    }
+  }
+}
+
+
+// The first wheel holds events at "now_", as well as those that differ
+// from it only in the lowest bits.
+//
+// "ticks" - time of the event, within the horizon
+// Returns - the index of the wheel for an event at "ticks"
+size_t TimingWheel::WheelIndex(SimTime::SimTick ticks) const {
+  const SimTime::SimTick differ = ticks ^ now_;
+  return (differ == 0) ? 0 : (63 - __builtin_clzll(differ)) / kSlotBits;
+}
+
+
+// "wheel" - the wheel to search
+// Returns - the index of the first occupied slot after the slot for
+//       "now_", or "kSlotCount" if there is none
+size_t TimingWheel::NextOccupied(size_t wheel) const {
+  const size_t start = SlotIndex(now_, wheel) + 1;
+  for (size_t word = start / 64; word < kBitmapWords; ++word) {
+    uint64_t bits = occupied_[wheel][word];
+    if (word == start / 64) {
+      bits &= ~static_cast<uint64_t>(0) << (start % 64);
+    }
+    if (bits != 0) {
+      return word * 64 + __builtin_ctzll(bits);
+    }
+  }
+  return kSlotCount;
+}
+
+
+// Events already removed from the current slot are skipped.
+//
+// "events" - receives the events.  Any previous contents are discarded.
+void TimingWheel::GatherWheels(std::vector<SimBaseEvent *> *events) const {
+  events->clear();
+  events->reserve(wheel_count_);
+  const size_t current = SlotIndex(now_, 0);
+  for (size_t wheel = 0; wheel < kWheelCount; ++wheel) {
+    for (size_t slot = 0; slot < kSlotCount; ++slot) {
+      const Slot &events_in_slot = slots_[wheel][slot];
+      const size_t first = ((wheel == 0) && (slot == current)) ? head_ : 0;
+      if (first < events_in_slot.size()) {
+        events->insert(events->end(), events_in_slot.begin() + first,
+                       events_in_slot.end());
+      }
+    }
+  }
+}
+
+
+// Empties every slot, and the bitmaps, without deleting any events
+void TimingWheel::ResetWheels() {
+  for (size_t wheel = 0; wheel < kWheelCount; ++wheel) {
+    for (Slot &slot : slots_[wheel]) {
+      slot.clear();
+    }
+    std::fill(occupied_[wheel], occupied_[wheel] + kBitmapWords, 0);
+  }
+  head_ = 0;
+  wheel_count_ = 0;
+}
+
+
+// Events that fall outside the horizon of the earlier "now_" go to the
+// overflow set.  They are all earlier than anything already there, since
+// the overflow set only ever holds events beyond the old horizon.
+//
+// "new_now" - the new, earlier, current time
+void TimingWheel::Rebase(SimTime::SimTick new_now) {
+  std::vector<SimBaseEvent *> events;
+  GatherWheels(&events);
+  ResetWheels();
+  now_ = new_now;
+  for (SimBaseEvent *event : events) {
+    Place(event);
+  }
+}
@@ -0,0 +1,144 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the hierarchical timing wheel pending event set
+*     for the Discrete Event Simulation system.
+*     TimingWheel sits in front of another PendingEventSet, the overflow
+*     set, and holds all events within a fixed horizon of the current
+*     time in a hierarchy of wheels.  Each wheel has 256 slots.  A slot in
+*     the first wheel is a single tick, and each slot in the next wheel
+*     spans a whole turn of the one below it.  An event goes into the
+*     finest wheel that can tell its time apart from the current time, so
+*     insertion is O(1), and timers a few ticks out land directly in the
+*     slot for their tick.  As time advances, slots of the coarser wheels
+*     are cascaded down into the finer ones.
+*
+*     Only events beyond the horizon of the coarsest wheel (2^32 ticks)
+*     are pushed onto the overflow set.  When the wheels run dry, the
+*     overflow events that fall within the new horizon are moved onto the
+*     wheels in dispatch order.  Every event on the wheels is therefore
+*     earlier than every event in the overflow set, and events with the
+*     same time always share a slot, in the order in which they were
+*     pushed (FIFO).
+*
+*     Like the radix heap, the wheels depend upon the executive never
+*     scheduling events in the past.  A push earlier than the current
+*     time of the wheels is handled, but costs O(n).
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_TIMING_WHEEL_HPP_
+#define SIM_DESIM_TIMING_WHEEL_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+
+
+class TimingWheel : public PendingEventSet {
+ public:
+  // "overflow" - the (empty) set that will hold events beyond the horizon
+  //       of the wheels.  The wheel takes ownership of this set.
+  explicit TimingWheel(PendingEventSet *overflow);
+  virtual ~TimingWheel();
+
+  // PendingEventSet interface.  See pending_event_set.hpp for details.
+  virtual void Push(SimBaseEvent *new_event);
+  virtual SimBaseEvent *PopMin();
+  virtual SimBaseEvent *PeekMin();
+  virtual bool Remove(SimBaseEvent *event);
+  virtual size_t Size() const { return wheel_count_ + overflow_->Size(); }
+  virtual void OrderedEvents(std::vector<SimBaseEvent *> *events) const;
+  virtual void Clear();
+  virtual void Discard();
+
+#ifdef TEST_HARNESS
+  // Returns - the number of events held in the overflow set
+  size_t overflow_count() const { return overflow_->Size(); }
+#endif
+
+ private:
+  typedef std::vector<SimBaseEvent *> Slot;
+
+  // Geometry of the wheels.  The horizon is 2^(kSlotBits * kWheelCount)
+  // ticks.
+  static const unsigned int kSlotBits = 8;
+  static const size_t kSlotCount = 1 << kSlotBits;
+  static const size_t kWheelCount = 4;
+  // Words in the bitmap of occupied slots for each wheel
+  static const size_t kBitmapWords = kSlotCount / 64;
+
+  // Returns - the slot index of "ticks" on "wheel"
+  static size_t SlotIndex(SimTime::SimTick ticks, size_t wheel) {
+    return static_cast<size_t>(ticks >> (kSlotBits * wheel)) &
+           (kSlotCount - 1);
+  }
+
+  // Returns - the finest wheel that distinguishes "ticks", which must be
+  //       within the horizon, from "now_"
+  size_t WheelIndex(SimTime::SimTick ticks) const;
+
+  // Places "event" on the finest wheel that distinguishes its time from
+  // "now_", or on the overflow set if it is beyond the horizon.  The
+  // event must not be earlier than "now_".
+  void Place(SimBaseEvent *event);
+
+  // Makes sure the current slot of the first wheel holds the earliest
+  // events, advancing "now_" and cascading slots as needed.  The set must
+  // not be empty.
+  void Advance();
+
+  // Finds the first occupied slot on "wheel" after the slot for "now_".
+  //
+  // Returns - the slot index, or "kSlotCount" if there is none
+  size_t NextOccupied(size_t wheel) const;
+
+  // Copies every event on the wheels into "events", keeping the order of
+  // each slot.
+  void GatherWheels(std::vector<SimBaseEvent *> *events) const;
+
+  // Empties every slot, without deleting the events.
+  void ResetWheels();
+
+  // Moves every event on the wheels to reflect an earlier "now_".  Used
+  // when a push breaks the "no events in the past" rule.
+  //
+  // "new_now" - the new, earlier, current time
+  void Rebase(SimTime::SimTick new_now);
+
+  // The slots of every wheel, finest first, and bitmaps of the occupied
+  // slots.
+  std::vector<Slot> slots_[kWheelCount];
+  uint64_t occupied_[kWheelCount][kBitmapWords];
+  // Current time of the wheels.  Every event on the wheels is at, or
+  // after, "now_", and shares all bits above the horizon with it.
+  SimTime::SimTick now_;
+  // Number of events in the current slot of the first wheel that have
+  // already been removed
+  size_t head_;
+  // Number of events still on the wheels
+  size_t wheel_count_;
+  // Events beyond the horizon
+  PendingEventSet *overflow_;
+  // Holds the events of a coarse slot while they cascade.  Kept so that
+  // its storage is reused.
+  Slot cascade_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(TimingWheel);
+}; // class TimingWheel
+
+#endif   // SIM_DESIM_TIMING_WHEEL_HPP_
@@ -0,0 +1,132 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the synchronous, window based, parallel executive for the
+*     Discrete Event Simulation system.  See window_exec.hpp for an
+*     overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <sstream>
+#include <thread>
+
+#include "window_exec.hpp"
+#include "common_messages.hpp"
+#include "pending_event_set.hpp"
+
+
+// "lp_count" - number of LPs, at least one
+// "lookahead" - width of a window
+// "event_set_name" - name of the pending event set for each LP
+WindowExec::WindowExec(uint32_t lp_count, SimTime::UserTime lookahead,
+                       const std::string &event_set_name)
+    : lookahead_(SimTime(lookahead).ticks()),
+      next_minimum_(LogicalProcess::kNever), window_start_(0),
+      window_count_(0), barrier_(lp_count) {
+  if (lp_count == 0) {
+    UtilFatalErrorAndDie("WindowExec needs at least one LP.");
+  }
+  if (lookahead_ == 0) {
+    std::stringstream message;
+    message << "Invalid lookahead " << lookahead << " for WindowExec.  The "
+               "lookahead must be positive.";
+    UtilFatalErrorAndDie(message.str());
+  }
+  for (uint32_t id = 0; id < lp_count; ++id) {
+    PendingEventSet *event_set = PendingEventSet::NewEventSet(event_set_name);
+    if (event_set == nullptr) {
+      UtilFatalErrorAndDie("Unknown pending event set: \"" + event_set_name +
+                           "\".\nKnown sets: " +
+                           PendingEventSet::KnownNames());
+    }
+    lps_.push_back(new LogicalProcess(id, lp_count, event_set));
+  }
+  for (LogicalProcess *from : lps_) {
+    for (LogicalProcess *to : lps_) {
+      if (from != to) {
+        from->AddOutLink(to, lookahead_);
+      }
+    }
+  }
+}
+
+
+WindowExec::~WindowExec() {
+  for (LogicalProcess *lp : lps_) {
+    delete lp;
+  }
+}
+
+
+// With a single LP there is nothing to synchronize, so it runs on the
+// calling thread.
+//
+// "run_until_tm" - time at which the run ends
+// Returns - the time when the simulation ended
+SimTime WindowExec::Run(const SimTime &run_until_tm) {
+  const SimTick end = run_until_tm.ticks();
+  if (lps_.size() == 1) {
+    RunLp(lps_[0], end);
+  } else {
+    std::vector<std::thread> threads;
+    for (LogicalProcess *lp : lps_) {
+      threads.push_back(std::thread(&WindowExec::RunLp, this, lp, end));
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+  SimTime last_time(0.0);
+  for (LogicalProcess *lp : lps_) {
+    if (last_time.EarlierThan(lp->curr_time())) {
+      last_time = lp->curr_time();
+    }
+  }
+  return last_time.AsEarlyAs(run_until_tm) ? last_time : run_until_tm;
+}
+
+
+// Each window: take in what was sent during the last one, report the next
+// event time, and once every LP has, dispatch everything before the end of
+// the window.  The second barrier keeps any LP from draining its inbox
+// while another may still be sending to it.  The links' promises aren't
+// needed, since the windows alone keep the LPs in step.
+//
+// "lp" - the LP to run
+// "end" - time at which the run ends, in ticks
+void WindowExec::RunLp(LogicalProcess *lp, SimTick end) {
+  LogicalProcess::current_ = lp;
+  for (;;) {
+    uint64_t version;
+    lp->DrainInbox(&version);
+    const SimTick next = lp->NextEventTicks();
+    SimTick minimum = next_minimum_;
+    while ((next < minimum) &&
+           !next_minimum_.compare_exchange_weak(minimum, next)) {
+    }
+    barrier_.Arrive([this, end] {
+      window_start_ = next_minimum_;
+      next_minimum_ = LogicalProcess::kNever;
+      if (window_start_ <= end) {
+        ++window_count_;
+      }
+    });
+    if (window_start_ > end) {
+      break;
+    }
+    const SimTick window_end = (window_start_ > LogicalProcess::kNever -
+                                lookahead_) ? LogicalProcess::kNever :
+                               window_start_ + lookahead_;
+    lp->DispatchUntil(window_end, end);
+    barrier_.Arrive();
+  }
+  LogicalProcess::current_ = nullptr;
+}
@@ -0,0 +1,103 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file declaring the synchronous, window based, parallel
+*     executive for the Discrete Event Simulation system.
+*     WindowExec runs a model partitioned into logical processes (see
+*     LogicalProcess), each on its own thread, in global time windows, in
+*     the manner of YAWNS.  Each window starts at the earliest pending
+*     event time T over all LPs, and covers [T, T + lookahead).  Every LP
+*     dispatches its events in the window concurrently with the others;
+*     anything it sends to another LP is at least one lookahead later, so
+*     it falls in a later window.  At the end of the window the LPs meet at
+*     a barrier, take in the events sent to them, and agree on the next T.
+*
+*     Compared with ConservativeExec, there are no null messages and no
+*     per-link promises, only two barriers per window, and every link has
+*     the same lookahead.  It works best when windows hold many events.
+*
+*     Results are the same as in a sequential run, with the same caveat as
+*     for ConservativeExec about events at exactly the same time.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_DESIM_WINDOW_EXEC_HPP_
+#define SIM_DESIM_WINDOW_EXEC_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "logical_process.hpp"
+#include "thread_barrier.hpp"
+
+
+class WindowExec {
+ public:
+  // Creates the LPs, each with its own pending event set, and links every
+  // LP to every other with "lookahead".  A fatal error is generated if
+  // "event_set_name" is not recognized, or the lookahead isn't positive.
+  //
+  // "lp_count" - number of LPs, at least one
+  // "lookahead" - least delay between an LP's current time and the time
+  //       of any event it sends to another LP, and the width of a window
+  // "event_set_name" - name of the pending event set for each LP, as
+  //       known to PendingEventSet::NewEventSet()
+  WindowExec(uint32_t lp_count, SimTime::UserTime lookahead,
+             const std::string &event_set_name = "HEAP");
+  // Deletes the LPs, and any events they still hold.
+  ~WindowExec();
+
+  // Returns - the LP with index "id", for scheduling the initial events
+  LogicalProcess *lp(uint32_t id) { return lps_[id]; }
+  // Returns - the number of LPs
+  uint32_t lp_count() const { return static_cast<uint32_t>(lps_.size()); }
+
+  // Runs every LP on its own thread, window by window, until no event is
+  // left before "run_until_tm".  As with SimExec, events later than
+  // "run_until_tm" are not dispatched.
+  //
+  // "run_until_tm" - time at which the run ends
+  // Returns - the time when the simulation ended: the time of the last
+  //       event dispatched, or "run_until_tm", whichever is earlier.
+  SimTime Run(const SimTime &run_until_tm);
+
+  // Returns - the number of windows processed
+  uint64_t window_count() const { return window_count_; }
+
+ private:
+  typedef LogicalProcess::SimTick SimTick;
+
+  // The window loop for one LP, on its own thread.
+  //
+  // "lp" - the LP to run
+  // "end" - time at which the run ends, in ticks
+  void RunLp(LogicalProcess *lp, SimTick end);
+
+  std::vector<LogicalProcess *> lps_;
+  // Width of a window, in ticks
+  SimTick lookahead_;
+
+  // Least next event time reported for the coming window
+  std::atomic<SimTick> next_minimum_;
+  // Start of the current window.  Written while every LP is stopped.
+  SimTick window_start_;
+  uint64_t window_count_;
+  ThreadBarrier barrier_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(WindowExec);
+}; // class WindowExec
+
+#endif   // SIM_DESIM_WINDOW_EXEC_HPP_
@@ -0,0 +1,66 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the main() function for the stim_convert program.
+*     stim_convert.exe converts a text event stimulus file, as read by
+*     text_event.exe, to the binary stimulus format read by
+*     BinaryStimTextEventLoader.  The text file is checked for malformed
+*     records, and for time order, during the conversion, so the loader
+*     doesn't have to check them on every run.
+*
+*     Usage:  stim_convert.exe <text stimulus file> <binary stimulus file>
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+#include "common_utilities.hpp"
+#include "binary_stim_text_event_loader.hpp"
+
+// Display the copyright notice on cout.
+void CopyrightLicenseNotice() {
+  std::cout << kCommonCopyright << std::endl;
+  std::cout << kCommonLicense << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "\n***************************************************"
+               "\n***  Welcome to the Stimulus Conversion Tool!  ***"
+               "\n***************************************************"
+            << std::endl;
+  CopyrightLicenseNotice();
+
+  if (argc != 3) {
+    std::cout << "Usage:  stim_convert.exe <text stimulus file> "
+                 "<binary stimulus file>\n" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string csv_path(argv[1]);
+  const std::string binary_path(argv[2]);
+  if (!UtilFileExistsRead(csv_path)) {
+    UtilStdMsg(kCommonStrError, "The specified Stimulus File: \"" +
+                                csv_path + "\" could not be read.");
+    return EXIT_FAILURE;
+  }
+
+  const long long records = BinaryStimConverter::ConvertCsv(csv_path,
+                                                            binary_path);
+  if (records < 0) {
+    return EXIT_FAILURE;
+  }
+  std::cout << kCommonStrNote << "Converted " << records
+            << " stimulus records from \"" << csv_path << "\" to \""
+            << binary_path << "\"." << std::endl;
+  return EXIT_SUCCESS;
+}
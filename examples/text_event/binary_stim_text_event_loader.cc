@@ -0,0 +1,312 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the binary stimulus converter and loader for the text event
+*     example.  See binary_stim_text_event_loader.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+#include "sim_text_event.hpp"
+#include "mapped_stim_text_event_loader.hpp"
+#include "binary_stim_text_event_loader.hpp"
+
+const char kBinaryStimMagic[8] = {'D', 'S', 'I', 'M', 'S', 'T', 'I', 'M'};
+
+constexpr SimTime::UserTime kReadPeriod = 1.0E3;
+
+// Returns - "value" rounded up to a multiple of eight, for the offsets
+static uint64_t AlignColumn(uint64_t value) {
+  return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+
+// The whole text is read, and checked, before anything is written, so a
+// bad file never leaves a partial binary file behind.
+//
+// "csv_path" - pathname of the text stimulus file
+// "binary_path" - pathname of the binary file to write
+// Returns - the number of records converted, or -1 on error
+long long BinaryStimConverter::ConvertCsv(const std::string &csv_path,
+                                          const std::string &binary_path) {
+  std::ifstream csv_file(csv_path, std::ios::binary);
+  if (!csv_file.is_open()) {
+    UtilStdMsg(kCommonStrError, "Unable to open stimulus file \"" +
+                                csv_path + "\".");
+    return -1;
+  }
+  std::stringstream contents;
+  contents << csv_file.rdbuf();
+  const std::string text = contents.str();
+  StimCsvTokenizer tokenizer(text.data(), text.data() + text.size());
+
+  SimTime::UserTime time;
+  const char *payload;
+  size_t payload_size;
+  bool read_success = tokenizer.NextRecord(&time, &payload, &payload_size);
+  if (!read_success) {
+    // Possibly a header line, skip it and try again
+    tokenizer.Seek(0);
+    tokenizer.SkipLine();
+    read_success = tokenizer.NextRecord(&time, &payload, &payload_size);
+  }
+  if (!read_success) {
+    UtilStdMsg(kCommonStrError, "Could not read stimulus from:  \"" +
+                                csv_path + "\".");
+    return -1;
+  }
+
+  std::vector<uint64_t> deltas;
+  std::vector<uint64_t> offsets;
+  std::string payloads;
+  const uint64_t base_ticks = SimTime(time).ticks();
+  uint64_t last_ticks = base_ticks;
+  uint64_t largest_delta = 0;
+  do {
+    const uint64_t ticks = SimTime(time).ticks();
+    if (ticks < last_ticks) {
+      std::stringstream message;
+      message << "Stimulus record " << (deltas.size() + 1) << " in \""
+              << csv_path << "\" is out of time order.\nIts time, " << time
+              << ", is earlier than the record before it.\nThe binary "
+                 "format needs records in time order.";
+      UtilStdMsg(kCommonStrError, message.str());
+      return -1;
+    }
+    deltas.push_back(ticks - last_ticks);
+    largest_delta = (ticks - last_ticks > largest_delta) ?
+                    ticks - last_ticks : largest_delta;
+    last_ticks = ticks;
+    offsets.push_back(payloads.size());
+    payloads.append(payload, payload_size);
+  } while (tokenizer.NextRecord(&time, &payload, &payload_size));
+  if (tokenizer.failed()) {
+    std::stringstream message;
+    message << "Malformed stimulus record in \"" << csv_path
+            << "\", at byte " << tokenizer.position() << ".";
+    UtilStdMsg(kCommonStrError, message.str());
+    return -1;
+  }
+  offsets.push_back(payloads.size());
+
+  BinaryStimHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kBinaryStimMagic, sizeof(header.magic));
+  header.version = kBinaryStimVersion;
+  header.header_size = sizeof(header);
+  header.ticks_per_unit = SimTime(1.0).ticks();
+  header.payload_kind = kBinaryStimTextPayload;
+  header.delta_width = (largest_delta <= UINT8_MAX) ? 1 :
+                       (largest_delta <= UINT16_MAX) ? 2 :
+                       (largest_delta <= UINT32_MAX) ? 4 : 8;
+  header.record_count = deltas.size();
+  header.base_ticks = base_ticks;
+  header.deltas_offset = sizeof(header);
+  header.offsets_offset = AlignColumn(header.deltas_offset +
+                                      header.record_count *
+                                      header.delta_width);
+  header.payloads_offset = header.offsets_offset +
+                           offsets.size() * sizeof(uint64_t);
+  header.file_size = header.payloads_offset + payloads.size();
+
+  // Each difference is narrowed to the chosen width, then the columns are
+  // written in order
+  std::vector<unsigned char> delta_column(header.offsets_offset -
+                                          header.deltas_offset, 0);
+  for (size_t record = 0; record < deltas.size(); ++record) {
+    unsigned char *slot = &delta_column[record * header.delta_width];
+    const uint8_t delta8 = static_cast<uint8_t>(deltas[record]);
+    const uint16_t delta16 = static_cast<uint16_t>(deltas[record]);
+    const uint32_t delta32 = static_cast<uint32_t>(deltas[record]);
+    switch (header.delta_width) {
+      case 1: memcpy(slot, &delta8, sizeof(delta8)); break;
+      case 2: memcpy(slot, &delta16, sizeof(delta16)); break;
+      case 4: memcpy(slot, &delta32, sizeof(delta32)); break;
+      default: memcpy(slot, &deltas[record], sizeof(uint64_t)); break;
+    }
+  }
+  std::ofstream binary_file(binary_path,
+                            std::ios::binary | std::ios::trunc);
+  binary_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  binary_file.write(reinterpret_cast<const char *>(delta_column.data()),
+                    delta_column.size());
+  binary_file.write(reinterpret_cast<const char *>(offsets.data()),
+                    offsets.size() * sizeof(uint64_t));
+  binary_file.write(payloads.data(), payloads.size());
+  binary_file.close();
+  if (binary_file.fail()) {
+    UtilStdMsg(kCommonStrError, "Unable to write binary stimulus file \"" +
+                                binary_path + "\".");
+    return -1;
+  }
+  return static_cast<long long>(header.record_count);
+}  // ConvertCsv
+
+
+// Every column is checked against the file size here, once, so that
+// reading the records needs no checks at all.  That includes a pass over
+// the payload offsets, since a single one out of order would make a
+// payload run past the end of the mapping.
+//
+// "stimulus_path" - pathname to the binary stimulus file.
+BinaryStimTextEventLoader::BinaryStimTextEventLoader(
+    const std::string &stimulus_path)
+    : StimLoader(), stim_ticks_(0), stim_payload_(nullptr),
+      stim_payload_size_(0), mapping_(nullptr), mapping_size_(0),
+      header_(nullptr), deltas_(nullptr), offsets_(nullptr),
+      payloads_(nullptr), next_record_(0) {
+  ResetStimData();
+  const int fd = open(stimulus_path.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if ((fd >= 0) && (fstat(fd, &file_stat) == 0) &&
+      (static_cast<size_t>(file_stat.st_size) >= sizeof(BinaryStimHeader))) {
+    mapping_size_ = static_cast<size_t>(file_stat.st_size);
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping_ == MAP_FAILED) {
+      mapping_ = nullptr;
+    } else {
+      madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+    }
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (mapping_ == nullptr) {
+    UtilFatalErrorAndDie("Unable to open stimulus file \"" + stimulus_path +
+                         ".\"\nSimulation cannot proceed without "
+                         "stimulus.");
+  }
+  const char *file = static_cast<const char *>(mapping_);
+  header_ = static_cast<const BinaryStimHeader *>(mapping_);
+  const uint64_t count = header_->record_count;
+  const uint32_t width = header_->delta_width;
+  const bool header_ok =
+      (memcmp(header_->magic, kBinaryStimMagic, sizeof(header_->magic)) ==
+       0) &&
+      (header_->version == kBinaryStimVersion) &&
+      (header_->header_size == sizeof(BinaryStimHeader)) &&
+      (header_->ticks_per_unit == SimTime(1.0).ticks()) &&
+      (header_->payload_kind == kBinaryStimTextPayload) &&
+      ((width == 1) || (width == 2) || (width == 4) || (width == 8)) &&
+      (header_->file_size == mapping_size_) && (count > 0) &&
+      (count < mapping_size_);
+  // The columns must follow each other, and end with the file.  Each
+  // column's offset is checked to be within the file first, and "count" is
+  // less than the file size, so none of the sums can overflow.
+  bool columns_ok = header_ok &&
+      (header_->deltas_offset >= sizeof(BinaryStimHeader)) &&
+      (header_->deltas_offset <= mapping_size_) &&
+      (header_->offsets_offset <= mapping_size_) &&
+      (header_->payloads_offset <= mapping_size_) &&
+      (header_->deltas_offset + count * width <= header_->offsets_offset) &&
+      ((header_->offsets_offset % sizeof(uint64_t)) == 0) &&
+      (header_->offsets_offset + (count + 1) * sizeof(uint64_t) ==
+       header_->payloads_offset);
+  if (columns_ok) {
+    deltas_ = reinterpret_cast<const unsigned char *>(
+        file + header_->deltas_offset);
+    offsets_ = reinterpret_cast<const uint64_t *>(
+        file + header_->offsets_offset);
+    payloads_ = file + header_->payloads_offset;
+    // The payloads fill the rest of the file, and follow each other, so
+    // every one lies within it
+    columns_ok = (offsets_[count] == mapping_size_ - header_->payloads_offset);
+    for (uint64_t record = 0; columns_ok && (record < count); ++record) {
+      columns_ok = (offsets_[record] <= offsets_[record + 1]);
+    }
+  }
+  if (!columns_ok) {
+    UtilFatalErrorAndDie("\"" + stimulus_path + "\" is not a binary "
+                         "stimulus file of this version.\nConvert the "
+                         "text stimulus with stim_convert.exe.");
+  }
+  std::cout << kCommonStrNote << "Reading binary stimulus from file:  "
+            << stimulus_path << std::endl;
+  // The first difference is zero, so the first record starts from here
+  stim_ticks_ = header_->base_ticks;
+  stim_event_time_ = static_cast<SimTime::UserTime>(stim_ticks_) /
+                     header_->ticks_per_unit;
+  read_until_ = stim_event_time_ + kReadPeriod;
+  set_ready(true);
+}  // BinaryStimTextEventLoader
+
+
+// The prefetch thread reads the mapping, so it's stopped before the
+// mapping goes.
+BinaryStimTextEventLoader::~BinaryStimTextEventLoader() {
+  StopPrefetch();
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+}  // ~BinaryStimTextEventLoader
+
+
+// Returns - "true" while there are records left to load
+bool BinaryStimTextEventLoader::StimFileOK() {
+  return next_record_ < header_->record_count;
+}  // StimFileOK
+
+
+// Resets the "cached" stimulus data to prepare for reading another record.
+void BinaryStimTextEventLoader::ResetStimData() {
+  StimLoader::ResetStimData();
+  stim_payload_ = nullptr;
+  stim_payload_size_ = 0;
+}  // ResetStimData
+
+
+// Returns - "true" if there was a record left, otherwise "false".
+bool BinaryStimTextEventLoader::ReadStimRecord() {
+  if (next_record_ >= header_->record_count) {
+    return false;
+  }
+  const unsigned char *slot = deltas_ + next_record_ * header_->delta_width;
+  uint8_t delta8;
+  uint16_t delta16;
+  uint32_t delta32;
+  uint64_t delta;
+  switch (header_->delta_width) {
+    case 1: memcpy(&delta8, slot, sizeof(delta8)); delta = delta8; break;
+    case 2: memcpy(&delta16, slot, sizeof(delta16)); delta = delta16; break;
+    case 4: memcpy(&delta32, slot, sizeof(delta32)); delta = delta32; break;
+    default: memcpy(&delta, slot, sizeof(delta)); break;
+  }
+  stim_ticks_ += delta;
+  stim_event_time_ = static_cast<SimTime::UserTime>(stim_ticks_) /
+                     header_->ticks_per_unit;
+  stim_payload_ = payloads_ + offsets_[next_record_];
+  stim_payload_size_ = static_cast<size_t>(offsets_[next_record_ + 1] -
+                                           offsets_[next_record_]);
+  ++next_record_;
+  return true;
+}  // ReadStimRecord
+
+
+// Creates a new SimTextEvent from the current record, at exactly its
+// ticks, copying the payload straight from the mapping, and stages it, to
+// be scheduled with the rest of the window
+void BinaryStimTextEventLoader::PostEvent() {
+  // The loader, then the simulation executive, will be responsible for the
+  // memory.
+  StageEvent(new SimTextEvent(SimTime::FromTicks(stim_ticks_),
+                              stim_payload_, stim_payload_size_));
+}  // PostEvent
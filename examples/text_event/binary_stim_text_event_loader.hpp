@@ -0,0 +1,164 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file for the binary stimulus format of the text event example,
+*     its converter, and its loader.  A text stimulus file is converted
+*     once, and the binary file is then loaded by every run, without any
+*     parsing.
+*
+*     The format is columnar, in the host's byte order:
+*       - a BinaryStimHeader, which names the format and version, records
+*         the schema (ticks per time unit, payload kind, delta width), the
+*         record count, and where each column starts.
+*       - the tick column: the time of each record, in SimTime ticks, as
+*         the difference from the record before.  The first record's time
+*         is in the header.  The converter picks the narrowest width that
+*         holds every difference.
+*       - the offset column: record_count + 1 offsets into the payload
+*         column, so record "n"'s payload runs from offset "n" to offset
+*         "n + 1".
+*       - the payload column: the payloads, as written in the text file,
+*         one after another, without separators.
+*
+*     BinaryStimConverter - converts a text stimulus file, as read by
+*             StimTextEventLoader, to the binary format.  The records must
+*             be in time order: the converter checks this once, so that
+*             the loader doesn't have to.
+*
+*     BinaryStimTextEventLoader - maps a binary stimulus file read only,
+*             checks its header, and loads its records.  It loads the same
+*             events as StimTextEventLoader from the text file the binary
+*             file was converted from.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_EXAMPLES_TEXT_EVENT_BINARY_STIM_TEXT_EVENT_LOADER_HPP_
+#define SIM_EXAMPLES_TEXT_EVENT_BINARY_STIM_TEXT_EVENT_LOADER_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "stim_loader.hpp"
+
+
+// The start of every binary stimulus file
+struct BinaryStimHeader {
+  // "kBinaryStimMagic", without a terminator
+  char magic[8];
+  // "kBinaryStimVersion"
+  uint32_t version;
+  // sizeof(BinaryStimHeader), when written
+  uint32_t header_size;
+  // Schema: SimTime ticks per user time unit, the kind of payload, and
+  // the bytes in each tick difference: 1, 2, 4 or 8
+  uint64_t ticks_per_unit;
+  uint32_t payload_kind;
+  uint32_t delta_width;
+  uint64_t record_count;
+  // Time of the first record, in ticks
+  uint64_t base_ticks;
+  // Offsets, from the start of the file, of the columns
+  uint64_t deltas_offset;
+  uint64_t offsets_offset;
+  uint64_t payloads_offset;
+  // Size of the whole file
+  uint64_t file_size;
+};
+
+// Format name, version, and payload kinds
+extern const char kBinaryStimMagic[8];
+const uint32_t kBinaryStimVersion = 1;
+const uint32_t kBinaryStimTextPayload = 1;
+
+
+class BinaryStimConverter {
+ public:
+  // Converts a text stimulus file to the binary format.  A header line is
+  // skipped, as StimTextEventLoader skips it.  An error message is printed
+  // if the text file can't be read, holds a malformed record, or isn't in
+  // time order, or if the binary file can't be written.
+  //
+  // "csv_path" - pathname of the text stimulus file
+  // "binary_path" - pathname of the binary file to write
+  // Returns - the number of records converted, or -1 on error
+  static long long ConvertCsv(const std::string &csv_path,
+                              const std::string &binary_path);
+
+ private:
+  // Static only
+  BinaryStimConverter();
+  DISALLOW_COPY_AND_ASSIGN(BinaryStimConverter);
+}; // class BinaryStimConverter
+
+
+class BinaryStimTextEventLoader : public StimLoader {
+
+ public:
+  // Maps the binary stimulus file, and checks its header.  As with
+  // StimTextEventLoader, a fatal error is issued if the file can't be
+  // mapped, isn't a binary stimulus file of this version and schema, or
+  // holds no stimulus.
+  //
+  // "stimulus_path" - pathname to the binary stimulus file.
+  explicit BinaryStimTextEventLoader(const std::string &stimulus_path);
+  // Stops the prefetch thread, if any, and unmaps the file.
+  ~BinaryStimTextEventLoader();
+
+  // Returns - "true" while there are records left to load
+  virtual bool StimFileOK();
+
+  // Returns - "true" if the file is mapped
+  virtual bool StimSourceOpen() { return mapping_ != nullptr; };
+
+  // Returns - the number of records in the file
+  uint64_t record_count() const { return header_->record_count; };
+  // Returns - the bytes in each tick difference
+  uint32_t delta_width() const { return header_->delta_width; };
+
+ protected:
+  // Decodes the next record.  The converter checked the time order, so
+  // nothing is checked here.
+  //
+  // Returns - "true" if there was a record left, otherwise "false".
+  virtual bool ReadStimRecord();
+
+  // Stage a single event for the event queue.
+  virtual void PostEvent();
+
+  // Resets the stimulus data members back to initial states.
+  virtual void ResetStimData();
+
+  // Stimulus record field(s):
+  // The event time, exactly, in ticks
+  SimTime::SimTick stim_ticks_;
+  // String payload field, as a view into the mapping
+  const char *stim_payload_;
+  size_t stim_payload_size_;
+
+ private:
+  // The mapped file, or nullptr, and its header and columns
+  void *mapping_;
+  size_t mapping_size_;
+  const BinaryStimHeader *header_;
+  const unsigned char *deltas_;
+  const uint64_t *offsets_;
+  const char *payloads_;
+  // Index of the next record to load
+  uint64_t next_record_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(BinaryStimTextEventLoader);
+}; // class BinaryStimTextEventLoader
+
+#endif   // SIM_EXAMPLES_TEXT_EVENT_BINARY_STIM_TEXT_EVENT_LOADER_HPP_
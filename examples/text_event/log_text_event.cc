@@ -28,7 +28,8 @@
 // Constructor initializes staged data fields
 //
 // "log_path" - pathname for the log file.
-LogTextEvent::LogTextEvent(std::string log_path) : LogMgr(log_path) {
+LogTextEvent::LogTextEvent(std::string log_path) : LogMgr(log_path),
+                                                   records_written_(0) {
   // Call reset to set initial states for members
   Reset();
 }
@@ -58,15 +59,24 @@ void LogTextEvent::WriteHeaderOrDie() {
 // Write the data collected for one record.  Execution terminates if
 // the method encounters problems with the write.
 void LogTextEvent::WriteARecordOrDie() {
+  AppendARecordOrDie();
+  FlushOrDie();
+}  // WriteARecord
+
+
+// Write the data collected for one record to the stream's buffer.
+// Execution terminates if the method encounters problems with the write.
+void LogTextEvent::AppendARecordOrDie() {
   // Make sure that the data is ready to go
   if (VerifyStagedReady()) {
     if ((log_stream_->is_open()) && (log_stream_->good())) {
-      *log_stream_ << event_time_.GetUserTime() << "," << event_text_ 
-                      << std::endl;
+      *log_stream_ << event_time_.GetUserTime() << "," << event_text_
+                   << '\n';
       if (*log_stream_) {
         // The steam's status seems to be OK, so it's likely that the write
         // was successful.  We can reset the data fields
         Reset();
+        ++records_written_;
       } else {
         // Probably a logic error in the caller's code...
         UtilFatalErrorAndDie("Unable to write log record.\n"
@@ -84,7 +94,19 @@ void LogTextEvent::WriteARecordOrDie() {
     UtilFatalErrorAndDie("LogTextEvent: Unable to write log record.\n"
                          "Staged data not ready. (LogTextEvent)");
   }  // data ready
-}  // WriteARecord
+}  // AppendARecord
+
+
+// Flush the records written so far.  Execution terminates if the stream
+// reports a problem.
+void LogTextEvent::FlushOrDie() {
+  log_stream_->flush();
+  if (!(*log_stream_)) {
+    UtilFatalErrorAndDie("Unable to flush log records.\n"
+                         "Output stream returned bad status. "
+                         "(LogTextEvent)");
+  }
+}  // Flush
 
 
 // Set the staged flags to all "false", to prepare for another set of
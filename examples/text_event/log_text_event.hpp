@@ -50,10 +50,22 @@ class LogTextEvent : public LogMgr {
   // Failure signals something pretty serious so method generates a fatal
   // error message and terminates.
   void WriteARecordOrDie();
+  // Same as WriteARecordOrDie(), but the record is left in the stream's
+  // buffer, so that a batch of records can be written with one flush.
+  // Call FlushOrDie() after the last record of the batch.
+  void AppendARecordOrDie();
+  // Flush the records written so far to the log file.
+  // Failure signals something pretty serious so method generates a fatal
+  // error message and terminates.
+  void FlushOrDie();
 
   // Reset the staged data fields to prepare for another pass
   void Reset();
 
+  // Returns - the number of records written so far, not counting the
+  //       header
+  unsigned long records_written() const { return records_written_; };
+
   // Stage data for writing.  These methods prepare the raw data for output
   // to the appropriate data fields.
   // Of course, I recognize that caching is complete overkill for this
@@ -97,6 +109,8 @@ class LogTextEvent : public LogMgr {
   SimTime event_time_;
   // Flags denoting staged status of each data element
   bool data_staged_[kStagedCount];
+  // Number of records written so far
+  unsigned long records_written_;
   // As per the coding standard
   DISALLOW_COPY_AND_ASSIGN(LogTextEvent);
 };
@@ -0,0 +1,331 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the memory mapped stimulus loader for the text event example.
+*     See mapped_stim_text_event_loader.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+#include "sim_text_event.hpp"
+#include "mapped_stim_text_event_loader.hpp"
+
+constexpr SimTime::UserTime kReadPeriod = 1.0E3;
+
+// Significant digits that always fit in the 64 bit mantissa
+const int kExactDigits = 19;
+// Largest power of ten that a long double holds exactly
+const int kExactPowerOfTen = 27;
+// Longest number handed to strtold()
+const size_t kMaxNumberLength = 128;
+
+// Returns - "true" for the white space skipped between fields
+static inline bool IsStimWhiteSpace(char c) {
+  return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+// Returns - "true" for a decimal digit, whatever the locale
+static inline bool IsStimDigit(char c) {
+  return (c >= '0') && (c <= '9');
+}
+
+
+// The digits are gathered into an integer, and the decimal point and
+// exponent into a power of ten, so the only rounding is in the final
+// multiply or divide.
+//
+// "cursor" - start of the number, moved past it on success
+// "end" - end of the text
+// "value" - receives the number
+// Returns - "false" if there is no number at "cursor"
+bool StimCsvTokenizer::ParseUserTime(const char **cursor, const char *end,
+                                     SimTime::UserTime *value) {
+  const char *next = *cursor;
+  const bool negative = (next < end) && (*next == '-');
+  if ((next < end) && ((*next == '-') || (*next == '+'))) {
+    ++next;
+  }
+  uint64_t mantissa = 0;
+  int significant = 0;
+  int power = 0;
+  int digits = 0;
+  bool exact = true;
+  for (; (next < end) && IsStimDigit(*next); ++next, ++digits) {
+    if (significant < kExactDigits) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*next - '0');
+      significant += (mantissa != 0) ? 1 : 0;
+    } else {
+      ++power;
+      exact = false;
+    }
+  }
+  if ((next < end) && (*next == '.')) {
+    for (++next; (next < end) && IsStimDigit(*next); ++next, ++digits) {
+      if (significant < kExactDigits) {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*next - '0');
+        significant += (mantissa != 0) ? 1 : 0;
+        --power;
+      } else {
+        exact = false;
+      }
+    }
+  }
+  if (digits == 0) {
+    return false;
+  }
+  if ((next < end) && ((*next == 'e') || (*next == 'E'))) {
+    const char *exponent_start = next + 1;
+    const bool exponent_negative = (exponent_start < end) &&
+                                   (*exponent_start == '-');
+    if ((exponent_start < end) &&
+        ((*exponent_start == '-') || (*exponent_start == '+'))) {
+      ++exponent_start;
+    }
+    if ((exponent_start < end) && IsStimDigit(*exponent_start)) {
+      int exponent = 0;
+      for (next = exponent_start; (next < end) && IsStimDigit(*next);
+           ++next) {
+        if (exponent < 100000) {
+          exponent = exponent * 10 + (*next - '0');
+        }
+      }
+      power += exponent_negative ? -exponent : exponent;
+    }
+  }
+  if (mantissa == 0) {
+    *value = negative ? -0.0L : 0.0L;
+  } else if (exact && (power >= -kExactPowerOfTen) &&
+             (power <= kExactPowerOfTen)) {
+    SimTime::UserTime scale = 1.0L;
+    for (int step = (power < 0) ? -power : power; step > 0; --step) {
+      scale *= 10.0L;
+    }
+    SimTime::UserTime magnitude = static_cast<SimTime::UserTime>(mantissa);
+    magnitude = (power < 0) ? magnitude / scale : magnitude * scale;
+    *value = negative ? -magnitude : magnitude;
+  } else {
+    // Too long, or too large, to convert exactly here
+    const size_t length = static_cast<size_t>(next - *cursor);
+    if (length >= kMaxNumberLength) {
+      return false;
+    }
+    char buffer[kMaxNumberLength];
+    std::copy(*cursor, next, buffer);
+    buffer[length] = '\0';
+    *value = strtold(buffer, nullptr);
+  }
+  *cursor = next;
+  return true;
+}
+
+
+// "time" - receives the record's time
+// "payload" - receives a pointer to the record's payload
+// "payload_size" - receives the length of the payload
+// Returns - "true" if a record was read
+bool StimCsvTokenizer::NextRecord(SimTime::UserTime *time,
+                                  const char **payload,
+                                  size_t *payload_size) {
+  if (failed_) {
+    return false;
+  }
+  SkipWhiteSpace();
+  if (cursor_ == end_) {
+    return false;
+  }
+  const char *record_start = cursor_;
+  const char *next = cursor_;
+  failed_ = true;
+  if (!ParseUserTime(&next, end_, time)) {
+    return false;
+  }
+  cursor_ = next;
+  SkipWhiteSpace();
+  if ((cursor_ == end_) || (*cursor_ != ',')) {
+    cursor_ = record_start;
+    return false;
+  }
+  ++cursor_;
+  SkipWhiteSpace();
+  const char *field_start = cursor_;
+  if ((cursor_ < end_) && (*cursor_ == '"')) {
+    // A doubled quote is part of the field, a single one closes it
+    for (++cursor_; cursor_ < end_; ++cursor_) {
+      if (*cursor_ == '"') {
+        if ((cursor_ + 1 < end_) && (cursor_[1] == '"')) {
+          ++cursor_;
+        } else {
+          break;
+        }
+      }
+    }
+    if (cursor_ == end_) {
+      cursor_ = record_start;
+      return false;
+    }
+    ++cursor_;
+  }
+  // As with the stream extraction, the field runs to the next white space
+  while ((cursor_ < end_) && !IsStimWhiteSpace(*cursor_)) {
+    ++cursor_;
+  }
+  if (cursor_ == field_start) {
+    cursor_ = record_start;
+    return false;
+  }
+  *payload = field_start;
+  *payload_size = static_cast<size_t>(cursor_ - field_start);
+  failed_ = false;
+  return true;
+}
+
+
+void StimCsvTokenizer::SkipLine() {
+  while ((cursor_ < end_) && (*cursor_ != '\n')) {
+    ++cursor_;
+  }
+  if (cursor_ < end_) {
+    ++cursor_;
+  }
+  failed_ = false;
+}
+
+
+// Returns - "true" if nothing but white space is left
+bool StimCsvTokenizer::AtEnd() const {
+  const char *next = cursor_;
+  while ((next < end_) && IsStimWhiteSpace(*next)) {
+    ++next;
+  }
+  return next == end_;
+}
+
+
+void StimCsvTokenizer::SkipWhiteSpace() {
+  while ((cursor_ < end_) && IsStimWhiteSpace(*cursor_)) {
+    ++cursor_;
+  }
+}
+
+
+// The file is mapped read only and private, and the kernel is told it
+// will be read front to back, so it can read ahead.
+//
+// "stimulus_path" - pathname to the stimulus file.
+MappedStimTextEventLoader::MappedStimTextEventLoader(
+    const std::string &stimulus_path)
+    : StimLoader(), stim_payload_(nullptr), stim_payload_size_(0),
+      mapping_(nullptr), mapping_size_(0), tokenizer_(nullptr) {
+  ResetStimData();
+  const int fd = open(stimulus_path.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if ((fd >= 0) && (fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0)) {
+    mapping_size_ = static_cast<size_t>(file_stat.st_size);
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping_ == MAP_FAILED) {
+      mapping_ = nullptr;
+    } else {
+      madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+    }
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  bool read_success = false;
+  if (mapping_ != nullptr) {
+    const char *text = static_cast<const char *>(mapping_);
+    tokenizer_ = new StimCsvTokenizer(text, text + mapping_size_);
+    std::cout << kCommonStrNote << "Reading stimulus from file:  "
+              << stimulus_path << std::endl;
+    // The first record sets the time baseline, and is read again by the
+    // first window
+    read_success = ReadStimRecord();
+    if (!read_success) {
+      // Possibly a header line, skip it and try again
+      tokenizer_->Seek(0);
+      tokenizer_->SkipLine();
+      const size_t first_record = tokenizer_->position();
+      read_success = ReadStimRecord();
+      tokenizer_->Seek(first_record);
+      if (read_success) {
+        std::cout << kCommonStrNote
+                  << "Stimulus file header line skipped.\n";
+      }
+    } else {
+      std::cout << "Base Time is:  " << stim_event_time_ << std::endl;
+      tokenizer_->Seek(0);
+    }
+  }
+  if (!read_success) {
+    std::string error("Unable to open stimulus file \"");
+    error.append(stimulus_path).append(".\"\nSimulation cannot proceed "
+                                      "without stimulus.");
+    UtilFatalErrorAndDie(error);
+  }
+  read_until_ = stim_event_time_ + kReadPeriod;
+  set_ready(true);
+}  // MappedStimTextEventLoader
+
+
+// The prefetch thread reads the mapping, so it's stopped before the
+// mapping goes.
+MappedStimTextEventLoader::~MappedStimTextEventLoader() {
+  StopPrefetch();
+  delete tokenizer_;
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+}  // ~MappedStimTextEventLoader
+
+
+// Returns - "true" while there are records left to read
+bool MappedStimTextEventLoader::StimFileOK() {
+  return (tokenizer_ != nullptr) && !tokenizer_->failed() &&
+         !tokenizer_->AtEnd();
+}  // StimFileOK
+
+
+// Resets the "cached" stimulus data to prepare for reading another record.
+void MappedStimTextEventLoader::ResetStimData() {
+  StimLoader::ResetStimData();
+  stim_payload_ = nullptr;
+  stim_payload_size_ = 0;
+}  // ResetStimData
+
+
+// Read a single record from the mapping.
+//
+// Returns - "true" if all fields are read correctly, "false" otherwise.
+bool MappedStimTextEventLoader::ReadStimRecord() {
+  return tokenizer_->NextRecord(&stim_event_time_, &stim_payload_,
+                                &stim_payload_size_);
+}  // ReadStimRecord
+
+
+// Creates a new SimTextEvent from the current record, copying the payload
+// straight from the mapping, and stages it, to be scheduled with the rest
+// of the window
+void MappedStimTextEventLoader::PostEvent() {
+  // The loader, then the simulation executive, will be responsible for the
+  // memory.
+  StageEvent(new SimTextEvent(stim_event_time_, stim_payload_,
+                              stim_payload_size_));
+}  // PostEvent
@@ -0,0 +1,154 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file for a stimulus loader that reads the text event example's
+*     CSV stimulus through a memory mapping, rather than a stream.
+*
+*     StimCsvTokenizer - splits the records of a CSV stimulus file, held in
+*             memory, into a time and a payload, in place.  Times are
+*             parsed by hand, without the locale, and payloads are handed
+*             out as pointers into the file, without copying.
+*
+*     MappedStimTextEventLoader - maps the stimulus file read only, and
+*             reads its records with a StimCsvTokenizer.  It loads the same
+*             events as StimTextEventLoader from the same file, but without
+*             the stream extraction, and the string copy, per record.
+*
+*     A payload is the whole of the field after the time, as written,
+*     including its quotes, just as StimTextEventLoader reads it.  A
+*     quoted payload may hold separators, white space, and doubled quotes.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_EXAMPLES_TEXT_EVENT_MAPPED_STIM_TEXT_EVENT_LOADER_HPP_
+#define SIM_EXAMPLES_TEXT_EVENT_MAPPED_STIM_TEXT_EVENT_LOADER_HPP_
+
+#include <cstddef>
+#include <string>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "stim_loader.hpp"
+
+
+class StimCsvTokenizer {
+ public:
+  // "begin" / "end" - the text to read.  It must outlast the tokenizer.
+  StimCsvTokenizer(const char *begin, const char *end)
+      : begin_(begin), cursor_(begin), end_(end), failed_(false) {};
+  ~StimCsvTokenizer() {};
+
+  // Reads the next record.  White space, including line breaks, is
+  // skipped between fields, as the stream extraction does.
+  //
+  // "time" - receives the record's time
+  // "payload" - receives a pointer to the record's payload, in the text
+  // "payload_size" - receives the length of the payload
+  // Returns - "true" if a record was read.  "false" at the end of the
+  //       text, or if the record is malformed, in which case failed() is
+  //       set, and the position is left at the start of the record.
+  bool NextRecord(SimTime::UserTime *time, const char **payload,
+                  size_t *payload_size);
+
+  // Moves past the end of the current line, e.g. to skip a header, and
+  // clears failed().
+  void SkipLine();
+
+  // Returns - "true" if nothing but white space is left
+  bool AtEnd() const;
+  // Returns - "true" if the last NextRecord() found a malformed record
+  bool failed() const { return failed_; };
+
+  // Returns - the current position, as an offset into the text
+  size_t position() const { return static_cast<size_t>(cursor_ - begin_); };
+  // Moves to a position returned by position(), and clears failed().
+  //
+  // "position" - offset into the text
+  void Seek(size_t position) {
+    cursor_ = begin_ + position;
+    failed_ = false;
+  };
+
+  // Parses a decimal number: an optional sign, digits with an optional
+  // fraction, and an optional exponent.  Up to 19 significant digits, and
+  // exponents up to 27, are converted exactly, then rounded once, so the
+  // result matches the stream extraction.  Longer numbers fall back to
+  // strtold().
+  //
+  // "cursor" - start of the number, moved past it on success
+  // "end" - end of the text
+  // "value" - receives the number
+  // Returns - "false" if there is no number at "cursor"
+  static bool ParseUserTime(const char **cursor, const char *end,
+                            SimTime::UserTime *value);
+
+ private:
+  // Moves past spaces, tabs and line breaks.
+  void SkipWhiteSpace();
+
+  const char *begin_;
+  const char *cursor_;
+  const char *end_;
+  bool failed_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(StimCsvTokenizer);
+}; // class StimCsvTokenizer
+
+
+class MappedStimTextEventLoader : public StimLoader {
+
+ public:
+  // Maps the stimulus file, and reads its first record to set the time
+  // baseline, skipping a header line, if there is one.  As with
+  // StimTextEventLoader, a fatal error is issued if the file can't be
+  // mapped, or holds no stimulus.
+  //
+  // "stimulus_path" - pathname to the stimulus file.
+  explicit MappedStimTextEventLoader(const std::string &stimulus_path);
+  // Stops the prefetch thread, if any, and unmaps the file.
+  ~MappedStimTextEventLoader();
+
+  // Returns - "true" while there are records left to read
+  virtual bool StimFileOK();
+
+  // Returns - "true" if the file is mapped
+  virtual bool StimSourceOpen() { return mapping_ != nullptr; };
+
+ protected:
+  // Reads the next record from the mapping.
+  //
+  // Returns - "true" if read succeeded for all record fields,
+  //       otherwise "false".
+  virtual bool ReadStimRecord();
+
+  // Stage a single event for the event queue.
+  virtual void PostEvent();
+
+  // Resets the stimulus data members back to initial states.
+  virtual void ResetStimData();
+
+  // Stimulus record field(s):
+  // String payload field, as a view into the mapping
+  const char *stim_payload_;
+  size_t stim_payload_size_;
+
+ private:
+  // The mapped file, or nullptr
+  void *mapping_;
+  size_t mapping_size_;
+  StimCsvTokenizer *tokenizer_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(MappedStimTextEventLoader);
+}; // class MappedStimTextEventLoader
+
+#endif   // SIM_EXAMPLES_TEXT_EVENT_MAPPED_STIM_TEXT_EVENT_LOADER_HPP_
@@ -0,0 +1,111 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Defines the classes that let several simulations of the text event
+*     example share one parsed copy of a stimulus file.  See
+*     shared_stim_text_event_loader.hpp for an overview.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+#include "sim_text_event.hpp"
+#include "shared_stim_text_event_loader.hpp"
+
+constexpr SimTime::UserTime kReadPeriod = 1.0E3;
+
+// Records are read just as StimTextEventLoader::ReadStimRecord() reads
+// them, so that both loaders see the same stimulus.  If the first record
+// can't be read, the first line is taken to be a header, and skipped.
+//
+// "stimulus_path" - pathname to the stimulus file.
+SharedTextStimulus::SharedTextStimulus(const std::string &stimulus_path) {
+  std::ifstream stim_file(stimulus_path);
+  Record record;
+  // separator for the CSV stimulus file
+  char separator;
+  bool read_success = stim_file.is_open() &&
+      (stim_file >> record.time >> separator >> record.payload);
+  if (stim_file.is_open() && !read_success) {
+    // Possibly a header line, skip it and try again
+    stim_file.clear();
+    stim_file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    read_success = static_cast<bool>(
+        stim_file >> record.time >> separator >> record.payload);
+    if (read_success) {
+      std::cout << kCommonStrNote << "Stimulus file header line skipped.\n";
+    }
+  }
+  if (!read_success) {
+    std::string error("Could not read stimulus from:  \"");
+    error.append(stimulus_path).append("\"\nSimulation cannot proceed "
+                                      "without stimulus.");
+    UtilFatalErrorAndDie(error);
+  }
+  do {
+    records_.push_back(record);
+  } while (stim_file >> record.time >> separator >> record.payload);
+}  // SharedTextStimulus
+
+
+// The records were validated as they were read, so the loader is ready
+// as soon as the time baseline is set from the first one.
+//
+// "stimulus" - the records to load.  They must outlast the loader.
+SharedStimTextEventLoader::SharedStimTextEventLoader(
+    const SharedTextStimulus *stimulus)
+    : StimLoader(), stimulus_(stimulus), next_record_(0) {
+  ResetStimData();
+  stim_event_time_ = stimulus_->records().front().time;
+  read_until_ = stim_event_time_ + kReadPeriod;
+  set_ready(true);
+}  // SharedStimTextEventLoader
+
+
+// Returns - "true" while there are records left to load
+bool SharedStimTextEventLoader::StimFileOK() {
+  return next_record_ < stimulus_->records().size();
+}  // StimFileOK
+
+
+// Resets the "cached" stimulus data to prepare for reading another record.
+void SharedStimTextEventLoader::ResetStimData() {
+  StimLoader::ResetStimData();
+  stim_payload_.clear();
+}  // ResetStimData
+
+
+// Copies the next record into the stim_* data members.
+//
+// Returns - "true" if there was a record left, otherwise "false".
+bool SharedStimTextEventLoader::ReadStimRecord() {
+  if (!StimFileOK()) {
+    return false;
+  }
+  const SharedTextStimulus::Record &record =
+      stimulus_->records()[next_record_++];
+  stim_event_time_ = record.time;
+  stim_payload_ = record.payload;
+  return true;
+}  // ReadStimRecord
+
+
+// Creates a new SimTextEvent from the current record and stages it, to be
+// scheduled with the rest of the window
+void SharedStimTextEventLoader::PostEvent() {
+  // The loader, then the simulation executive, will be responsible for the
+  // memory.
+  StageEvent(new SimTextEvent(stim_event_time_, stim_payload_));
+}  // PostEvent
@@ -0,0 +1,109 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     Header file describing the classes that let several simulations of
+*     the text event example share one parsed copy of a stimulus file.
+*     This file declares:
+*
+*     SharedTextStimulus - the records of a SimTextEvent stimulus file,
+*             read once, and then read only.  Any number of loaders, on
+*             any number of threads, may read from it at the same time.
+*
+*     SharedStimTextEventLoader - a stimulus loader that creates the
+*             SimTextEvents of a SharedTextStimulus, instead of reading
+*             the stimulus file itself.  Each simulation needs its own
+*             loader.
+*
+*     Replications of the same model only pay for parsing the stimulus
+*     once.  The loaders post the same events, at the same times, as
+*     StimTextEventLoader does for the same file.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#ifndef SIM_EXAMPLES_TEXT_EVENT_SHARED_STIM_TEXT_EVENT_LOADER_HPP_
+#define SIM_EXAMPLES_TEXT_EVENT_SHARED_STIM_TEXT_EVENT_LOADER_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "sim_time.hpp"
+#include "stim_loader.hpp"
+
+
+class SharedTextStimulus {
+ public:
+  // One stimulus record
+  struct Record {
+    SimTime::UserTime time;
+    std::string payload;
+  };
+
+  // Reads every record of the stimulus file, skipping a header line, if
+  // there is one.  As with StimTextEventLoader, a fatal error is issued
+  // if the file can't be read, or holds no stimulus.
+  //
+  // "stimulus_path" - pathname to the stimulus file.
+  explicit SharedTextStimulus(const std::string &stimulus_path);
+  ~SharedTextStimulus() {};
+
+  // Returns - the records, in the order they were read
+  const std::vector<Record> &records() const { return records_; };
+
+ private:
+  std::vector<Record> records_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(SharedTextStimulus);
+}; // class SharedTextStimulus
+
+
+class SharedStimTextEventLoader : public StimLoader {
+
+ public:
+  // "stimulus" - the records to load.  They must outlast the loader.
+  explicit SharedStimTextEventLoader(const SharedTextStimulus *stimulus);
+  ~SharedStimTextEventLoader() {};
+
+  // Returns - "true" while there are records left to load
+  virtual bool StimFileOK();
+
+  // Returns - "true", the records are always available
+  virtual bool StimSourceOpen() { return true; };
+
+ protected:
+  // Takes the next record from the shared stimulus.
+  //
+  // Returns - "true" if there was a record left, otherwise "false".
+  virtual bool ReadStimRecord();
+
+  // Stage a single event for the event queue.
+  virtual void PostEvent();
+
+  // Resets the stimulus data members back to initial states.
+  virtual void ResetStimData();
+
+  // Stimulus record field(s):
+  // String payload field
+  std::string stim_payload_;
+
+ private:
+  // The records, shared with other loaders
+  const SharedTextStimulus *stimulus_;
+  // Index of the next record to load
+  size_t next_record_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(SharedStimTextEventLoader);
+}; // class SharedStimTextEventLoader
+
+#endif   // SIM_EXAMPLES_TEXT_EVENT_SHARED_STIM_TEXT_EVENT_LOADER_HPP_
@@ -25,16 +25,38 @@
 #include "sim_exec.hpp"
 #include "log_text_event.hpp"
 
+const uint16_t SimTextEvent::kEventTypeId;
+
+thread_local LogTextEvent *SimTextEvent::log_manager_ = nullptr;
+
+// The log manager is only bound for the length of a typed run, so it can't
+// outlive the executive that owns it.  It is bound per thread, since each
+// thread may be running its own simulation.
+//
+// "exec" - the executive starting a run, or nullptr as it finishes
+void SimTextEvent::BindToExec(SimExec *exec) {
+  log_manager_ = (exec != nullptr) ?
+                 dynamic_cast<LogTextEvent*>(exec->log_manager()) : nullptr;
+}
+
+// Returns - the log manager bound for a typed run, if any.  Otherwise,
+//       the log manager of the executive running on this thread.
+//       "static_cast" would be more efficient, but dynamic might be a tad
+//       bit safer.
+static LogTextEvent *TextLogManager(LogTextEvent *bound) {
+  if (bound != nullptr) {
+    return bound;
+  }
+  return dynamic_cast<LogTextEvent*>(SimExec::current()->log_manager());
+}
+
 //
 void SimTextEvent::Dispatch() const {
 #ifdef TEST_HARNESS
   std::cout << kCommonStrNote << "Dispatched - " << event_text_ << " at: "
             << this->event_time().GetUserTime() << std::endl;
 #endif
-  // Get a pointer to the log manager.  "static_cast" would be more 
-  // efficient, but dynamic might be a tad bit safer.
-  LogTextEvent *log_mgr = dynamic_cast<LogTextEvent*>
-                                       (SimExec::the_exec()->log_manager());
+  LogTextEvent *log_mgr = TextLogManager(log_manager_);
   // Stage the data from this event for logging
   log_mgr->StageEventTime(event_time_);
   log_mgr->StageEventText(event_text_);
@@ -42,6 +64,27 @@ void SimTextEvent::Dispatch() const {
   log_mgr->WriteARecordOrDie();
 }
 
+// The records are appended to the log stream's buffer, which is flushed
+// once, after the last of them.
+//
+// "events" - the events to dispatch, in order, all SimTextEvents
+// "count" - the number of events
+void SimTextEvent::DispatchBatch(const SimBaseEvent *const *events,
+                                 size_t count) const {
+  LogTextEvent *log_mgr = TextLogManager(log_manager_);
+  for (size_t i = 0; i < count; ++i) {
+    const SimTextEvent *event = static_cast<const SimTextEvent *>(events[i]);
+#ifdef TEST_HARNESS
+    std::cout << kCommonStrNote << "Dispatched - " << event->event_text_
+              << " at: " << event->event_time().GetUserTime() << std::endl;
+#endif
+    log_mgr->StageEventTime(event->event_time_);
+    log_mgr->StageEventText(event->event_text_);
+    log_mgr->AppendARecordOrDie();
+  }
+  log_mgr->FlushOrDie();
+}
+
 #ifdef TEST_HARNESS
   // Debug support for dumping the queue to std out.  Should never be present
   // in production code, but needed for test harness.
@@ -6,6 +6,9 @@
 *     This class provides a very simple example of an actual event object.
 *     beyond the base class member data, it includes a string that may
 *     contain a textual payload.
+*     The class is final, with its own type id, so that it can be listed
+*     in an EventRegistry for SimExec::RunTyped().  Text events at the same
+*     time are logged in batches.
 *     
 *   STATUS:  Prototype
 *   VERSION:  1.00
@@ -20,23 +23,55 @@
 #ifndef SIM_EXAMPLES_TEXT_EVENT_SIM_TEXT_EVENT_HPP_
 #define SIM_EXAMPLES_TEXT_EVENT_SIM_TEXT_EVENT_HPP_
 
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
 #include "sim_time.hpp"
 #include "sim_base_event.hpp"
 
-class SimTextEvent : public SimBaseEvent {
+class LogTextEvent;
+
+class SimTextEvent final : public SimBaseEvent {
 // Class that represents events containing a textual payload
  public:
+  // Type id for EventRegistry
+  static const uint16_t kEventTypeId = 1;
+
   // "event_time" - time that the event will be "dispatched" by the simulation
   //       executive
   // "event_text" - the string that represents the object's data payload
   SimTextEvent(const SimTime &event_time, const std::string &event_text)
-      : SimBaseEvent(event_time), event_text_(event_text) {};
+      : SimBaseEvent(event_time, kEventTypeId, true),
+        event_text_(event_text) {};
+  // As above, copying the payload straight from a loader's buffer.
+  //
+  // "event_text" - the text of the payload, not terminated
+  // "text_size" - length of the payload
+  SimTextEvent(const SimTime &event_time, const char *event_text,
+               size_t text_size)
+      : SimBaseEvent(event_time, kEventTypeId, true),
+        event_text_(event_text, text_size) {};
   virtual ~SimTextEvent() {};
 
   // Called by dispatch loop as each event is executed from the event queue
   //   NOTE:  This method MUST be redefined for all derived classes.
   virtual void Dispatch() const;
 
+  // Logs a run of text events at the same time with one lookup of the
+  // log manager, and one flush of the log file.
+  //
+  // "events" - the events to dispatch, in order, all SimTextEvents
+  // "count" - the number of events
+  virtual void DispatchBatch(const SimBaseEvent *const *events,
+                             size_t count) const;
+
+  // Binds the executive's log manager for a typed run, so that Dispatch()
+  // doesn't have to find, and cast, it for every event.
+  //
+  // "exec" - the executive starting a run, or nullptr as it finishes
+  static void BindToExec(SimExec *exec);
+
   // Accessor for the event's text object
   //
   // Returns - const reference to the event's text payload
@@ -49,6 +84,10 @@ class SimTextEvent : public SimBaseEvent {
 #endif
 
  private:
+  // The log manager bound by BindToExec() on this thread, or nullptr
+  // outside a typed run
+  static thread_local LogTextEvent *log_manager_;
+
   // As per the coding standard
   DISALLOW_COPY_AND_ASSIGN(SimTextEvent);
 
@@ -29,7 +29,6 @@
 #include "common_messages.hpp"
 #include "sim_text_event.hpp"
 #include "stim_text_event_loader.hpp"
-#include "sim_exec.hpp"
 
 constexpr SimTime::UserTime kReadPeriod = 1.0E3;
 
@@ -90,9 +89,10 @@ bool StimTextEventLoader::ReadStimRecord() {
 
 
 // Creates a new SimTextEvent with data fields from the stimulus file and
-// schedules the new event with the simulation executive
+// stages the new event, to be scheduled with the rest of the window
 void StimTextEventLoader::PostEvent() {
   SimTextEvent *new_event = new SimTextEvent(stim_event_time_, stim_payload_);
-  // The simulation executive will be responsible for the memory.
-  SimExec::the_exec()->ScheduleEvent(new_event);
+  // The loader, then the simulation executive, will be responsible for the
+  // memory.
+  StageEvent(new_event);
 }  // PostEvent
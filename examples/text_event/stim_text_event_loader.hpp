@@ -45,7 +45,7 @@ class StimTextEventLoader : public StimLoader {
   //       otherwise "false".
   virtual bool ReadStimRecord();
   
-  // Post a single event to the event queue.
+  // Stage a single event for the event queue.
   virtual void PostEvent();
 
   // Resets the stimulus data members back to initial states.  Potentially
@@ -30,6 +30,7 @@
 #include "sim_time.hpp"
 #include "arg_parser.hpp"
 #include "sim_exec.hpp"
+#include "pending_event_set.hpp"
 #include "sim_text_event.hpp"
 #include "stim_text_event_loader.hpp"
 #include "log_text_event.hpp"
@@ -52,8 +53,9 @@ const std::string help_descr =
 // Handle setup for the simulation run.  Specific responsibilities include:
 // (1) Display welcome, copyright, license, etc. text.  
 // (2) Parse commandline arguments
-// (3) Initialize stimulus loader
-// (4) Initialize the simulation executive.
+// (3) Select the pending event set implementation
+// (4) Initialize stimulus loader
+// (5) Initialize the simulation executive.
 // Once this function completes successfully, the simulation should be 
 // ready to run
 // Exits with EXIT_FAILURE status if problems with the argument / stimulus
@@ -87,6 +89,19 @@ void InitSessionOrDie(long argc, char * argv[]) {
                          "Use -h for help");
   }
  
+  // Create the pending event set the user asked for.  Selecting it at
+  // startup lets different data structures be compared on identical
+  // stimulus without rebuilding.
+  PendingEventSet *event_set =
+      PendingEventSet::NewEventSet(the_args.parsed_args().event_set_);
+  if (event_set == nullptr) {
+    std::string message = "Unrecognized Event Set: \"" +
+                          the_args.parsed_args().event_set_ + "\"\n"
+                          "Recognized names are:  " +
+                          PendingEventSet::KnownNames();
+    UtilFatalErrorAndDie(message);
+  }
+
   // Create the stimulus loader for StimTextEvent(s).  The stimulus loader
   // is specific to each type of stimulus file, so it can't be generically
   // created in the exec's Init() method.
@@ -104,6 +119,8 @@ void InitSessionOrDie(long argc, char * argv[]) {
     // specified stimulus file.
     stim_text_event_loader = new 
                  StimTextEventLoader(the_args.parsed_args().stimulus_path_);
+    // With "-A", each window is read while the one before is simulated
+    stim_text_event_loader->set_prefetch(the_args.parsed_args().prefetch_);
   } else {
     std::string message = "The specified Stimulus File: \"" + 
                           the_args.parsed_args().stimulus_path_ + "\" ";
@@ -165,13 +182,16 @@ void InitSessionOrDie(long argc, char * argv[]) {
   SimExec::the_exec()->Init(SimTime(the_args.parsed_args().run_until_time_),
                             nullptr,
                             log_manager,
-                            stim_text_event_loader);
+                            stim_text_event_loader,
+                            event_set);
 }  // initSession
 
 int main(int argc, char *argv[]) {
   InitSessionOrDie(argc, argv);
-  // Run the discrete event simulation engine
-  SimTime sim_run = SimExec::the_exec()->Run();
+  // Run the discrete event simulation engine.  Text events are the only
+  // events of this example, apart from the stimulus timers, so they are
+  // dispatched directly.
+  SimTime sim_run = SimExec::the_exec()->RunTyped<SimTextEvent>();
 
   std::cout << "\n=>=>=>=>=>=>=>>> Simulation Complete at time " 
             << sim_run.GetUserTime() << " <<<=<=<=<=<=<=<=\n";
@@ -0,0 +1,350 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the initialization and main() function for the
+*     text_replications program.  text_replications.exe runs many
+*     replications of the text_event example in one process, on a pool of
+*     worker threads.  Every replication has its own simulation executive,
+*     pending event set, stimulus loader and log file, but the stimulus
+*     file is only parsed once, and shared, read only, by all of them.
+*     Once every replication is done, summary statistics across the
+*     replications are printed.
+*
+*     The text_event model is deterministic, so every replication of it
+*     reaches the same results.  RunReplication() is where a model with
+*     random elements would seed its generator, or set its parameters,
+*     from the replication number.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "basic_defs.hpp"
+#include "common_strings.hpp"
+#include "common_messages.hpp"
+#include "common_utilities.hpp"
+#include "sim_time.hpp"
+#include "arg_parser.hpp"
+#include "sim_exec.hpp"
+#include "pending_event_set.hpp"
+#include "sim_text_event.hpp"
+#include "shared_stim_text_event_loader.hpp"
+#include "log_text_event.hpp"
+#include "display_help.hpp"
+#include "sim_version.hpp"
+
+// Display the copyright notice on cout.
+void CopyrightLicenseNotice() {
+  std::cout << kCommonCopyright << std::endl;
+  std::cout << kCommonLicense << std::endl;
+}
+
+// Description for the help
+const std::string help_descr =
+    "    text_replications.exe runs many replications of the text_event\n"
+    "    example, on a pool of threads, and summarizes the results.\n"
+    "    The stimulus file is read once, and shared by every replication.\n"
+    "    Replication \"n\" writes its log to the log pathname with \"_n\"\n"
+    "    added before the extension, e.g. \"./logfile_3.csv\".\n"
+    "\n"
+    "    In addition to the arguments above:\n"
+    "        \"-R\" Followed immediately by the number of replications.\n"
+    "             If this argument is not specified, 1 will be used.\n"
+    "        \"-P\" Followed immediately by the number of worker threads.\n"
+    "             If this argument is not specified, the number of\n"
+    "             hardware threads will be used.\n";
+
+// Everything the replications share, set up once by InitSessionOrDie()
+struct ReplicationSetup {
+  int replications;
+  int threads;
+  std::string log_path;
+  std::string event_set;
+  SimTime::UserTime run_until_time;
+  const SharedTextStimulus *stimulus;
+};
+
+// The outcome of one replication
+struct ReplicationResult {
+  // Time when the simulation ended
+  SimTime::UserTime end_time;
+  // Log records written
+  unsigned long records;
+  // Wall clock time to run the replication, in milliseconds
+  double wall_ms;
+};
+
+// Reads a positive count from the remainder of a "-R" or "-P" switch.
+//
+// "arg_string" - the text following the switch
+// "name" - name of the count, for the error message
+// Returns - the count.  Issues a fatal error if it isn't a positive number.
+int PositiveCountOrDie(const char *arg_string, const std::string &name) {
+  char *end_ptr;
+  const long count = strtol(arg_string, &end_ptr, 10);
+  if ((*arg_string == 0) || (*end_ptr != 0) || (count <= 0)) {
+    UtilFatalErrorAndDie("The " + name + " must be a positive whole "
+                         "number, not \"" + arg_string + "\".\n"
+                         "Use -h for help");
+  }
+  return static_cast<int>(count);
+}
+
+// Inserts "_<replication>" before the extension of "log_path".
+//
+// "log_path" - pathname of the log file given by the user
+// "replication" - number of the replication
+// Returns - the pathname of the replication's log file
+std::string ReplicationLogPath(const std::string &log_path, int replication) {
+  const std::string suffix = "_" + std::to_string(replication);
+  const size_t dot = log_path.find_last_of('.');
+  const size_t slash = log_path.find_last_of('/');
+  if ((dot == std::string::npos) ||
+      ((slash != std::string::npos) && (dot < slash))) {
+    return log_path + suffix;
+  }
+  return log_path.substr(0, dot) + suffix + log_path.substr(dot);
+}
+
+
+// Handle setup for the replications.  Specific responsibilities include:
+// (1) Display welcome, copyright, license, etc. text.
+// (2) Parse commandline arguments, taking out the "-R" and "-P" switches
+//     before the rest are handed to the ArgParser
+// (3) Check the pending event set name
+// (4) Read the stimulus file, once, for all of the replications
+// Exits with EXIT_FAILURE status if problems with the argument / stimulus
+// loading are encountered.
+//
+// "setup" - receives the settings shared by the replications
+void InitSessionOrDie(long argc, char * argv[], ReplicationSetup *setup) {
+
+  std::cout << "\n**************************************************"
+               "\n***  Welcome to the Text Replications Example!  ***"
+               "\n**************************************************"
+            << std::endl;
+
+  SimVersion version;
+  version.PrintVersion("Executing:");
+  std::cout << std::endl;
+
+  CopyrightLicenseNotice();
+
+  setup->replications = 1;
+  setup->threads = static_cast<int>(std::thread::hardware_concurrency());
+  if (setup->threads <= 0) {
+    setup->threads = 1;
+  }
+  std::vector<char *> sim_args;
+  for (long arg = 0; arg < argc; ++arg) {
+    const std::string arg_string(argv[arg]);
+    if ((arg > 0) && (arg_string.size() >= 2) && (arg_string[0] == '-') &&
+        (toupper(arg_string[1]) == 'R')) {
+      setup->replications = PositiveCountOrDie(argv[arg] + 2,
+                                               "replication count");
+    } else if ((arg > 0) && (arg_string.size() >= 2) &&
+               (arg_string[0] == '-') && (toupper(arg_string[1]) == 'P')) {
+      setup->threads = PositiveCountOrDie(argv[arg] + 2, "thread count");
+    } else {
+      sim_args.push_back(argv[arg]);
+    }
+  }
+
+  // Process the rest of the user specified arguments
+  ArgParser the_args;
+  if (the_args.ParseArgs(static_cast<long>(sim_args.size()),
+                         sim_args.data())) {
+    // The arguments appear OK, see if they specified the HELP switch
+    if (the_args.parsed_args().display_help_) {
+      DisplayHelp("text_replications.exe", help_descr);
+      // Since they asked for help, we'll disregard other args
+      exit(EXIT_SUCCESS);
+    }
+  } else {
+    // A problem was encountered in arg processing.  Proceeding beyond this
+    // point might have unexpected results.
+    UtilFatalErrorAndDie("Unrecognized, or improper argument(s).\n"
+                         "Use -h for help");
+  }
+  setup->log_path = the_args.parsed_args().log_path_;
+  setup->event_set = the_args.parsed_args().event_set_;
+  setup->run_until_time = the_args.parsed_args().run_until_time_;
+
+  // Each replication creates its own pending event set, so the name is
+  // checked once here, rather than failing on a worker thread.
+  PendingEventSet *event_set = PendingEventSet::NewEventSet(setup->event_set);
+  if (event_set == nullptr) {
+    std::string message = "Unrecognized Event Set: \"" +
+                          setup->event_set + "\"\n"
+                          "Recognized names are:  " +
+                          PendingEventSet::KnownNames();
+    UtilFatalErrorAndDie(message);
+  }
+  delete event_set;
+
+  // Read the stimulus once.  The replications each load their events
+  // from this copy, so none of them touch the stimulus file.
+  const std::string &stimulus_path = the_args.parsed_args().stimulus_path_;
+  if (!UtilFileExistsRead(stimulus_path)) {
+    UtilFatalErrorAndDie("The specified Stimulus File: \"" + stimulus_path +
+                         "\" could not be read.\nSimulation requires a "
+                         "valid stimulus file to execute.\nPlease check "
+                         "the Stimulus File pathname and try again.");
+  }
+  setup->stimulus = new SharedTextStimulus(stimulus_path);
+}  // InitSessionOrDie
+
+
+// Runs one replication, start to finish, on the calling thread, with its
+// own executive, event set, stimulus loader and log manager.
+//
+// "setup" - settings shared by the replications
+// "replication" - number of the replication
+// "result" - receives the outcome of the replication
+void RunReplication(const ReplicationSetup &setup, int replication,
+                    ReplicationResult *result) {
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  SimExec *exec = new SimExec;
+  LogTextEvent *log_manager =
+      new LogTextEvent(ReplicationLogPath(setup.log_path, replication));
+  exec->Init(SimTime(setup.run_until_time),
+             nullptr,
+             log_manager,
+             new SharedStimTextEventLoader(setup.stimulus),
+             PendingEventSet::NewEventSet(setup.event_set));
+  SimTime sim_run = exec->RunTyped<SimTextEvent>();
+  result->end_time = sim_run.GetUserTime();
+  result->records = log_manager->records_written();
+  // Also deletes the log manager, loader and event set
+  exec->TearDown();
+  result->wall_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+}  // RunReplication
+
+
+// A worker thread of the pool.  Takes the next replication that no other
+// worker has taken, until there are none left.
+//
+// "setup" - settings shared by the replications
+// "next_replication" - number of the next replication to run
+// "results" - outcome of each replication, indexed by its number
+void RunWorker(const ReplicationSetup *setup,
+               std::atomic<int> *next_replication,
+               std::vector<ReplicationResult> *results) {
+  for (int replication = (*next_replication)++;
+       replication < setup->replications;
+       replication = (*next_replication)++) {
+    RunReplication(*setup, replication, &(*results)[replication]);
+  }
+}  // RunWorker
+
+
+// Running summary of one statistic across the replications.  Welford's
+// method keeps the variance accurate without storing the samples.
+class SummaryStatistic {
+ public:
+  SummaryStatistic() : count_(0), mean_(0.0), m2_(0.0), min_(0.0),
+                       max_(0.0) {};
+
+  // "sample" - the value from one replication
+  void Add(double sample) {
+    ++count_;
+    if (count_ == 1) {
+      min_ = max_ = sample;
+    } else {
+      min_ = (sample < min_) ? sample : min_;
+      max_ = (sample > max_) ? sample : max_;
+    }
+    const double delta = sample - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (sample - mean_);
+  }
+
+  // Prints the statistic on one line.
+  //
+  // "label" - name of the statistic
+  void Print(const std::string &label) const {
+    const double std_dev = (count_ > 1) ? sqrt(m2_ / (count_ - 1)) : 0.0;
+    std::cout << std::left << std::setw(22) << label << std::right
+              << std::fixed << std::setprecision(3)
+              << "  mean " << std::setw(12) << mean_
+              << "  std dev " << std::setw(12) << std_dev
+              << "  min " << std::setw(12) << min_
+              << "  max " << std::setw(12) << max_ << "\n";
+  }
+
+ private:
+  long count_;
+  double mean_;
+  // Sum of squared differences from the mean
+  double m2_;
+  double min_;
+  double max_;
+};  // class SummaryStatistic
+
+
+int main(int argc, char *argv[]) {
+  ReplicationSetup setup;
+  InitSessionOrDie(argc, argv, &setup);
+  const int threads = (setup.threads < setup.replications) ? setup.threads :
+                                                             setup.replications;
+  std::cout << "\nRunning " << setup.replications << " replication(s) on "
+            << threads << " thread(s).\n";
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::vector<ReplicationResult> results(setup.replications);
+  std::atomic<int> next_replication(0);
+  if (threads == 1) {
+    RunWorker(&setup, &next_replication, &results);
+  } else {
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < threads; ++worker) {
+      workers.push_back(std::thread(RunWorker, &setup, &next_replication,
+                                    &results));
+    }
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+  }
+  const double wall_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  SummaryStatistic end_time;
+  SummaryStatistic records;
+  SummaryStatistic replication_ms;
+  for (const ReplicationResult &result : results) {
+    end_time.Add(result.end_time);
+    records.Add(static_cast<double>(result.records));
+    replication_ms.Add(result.wall_ms);
+  }
+  std::cout << "\n=>=>=>=>=>=>=>>> " << setup.replications
+            << " Replications Complete <<<=<=<=<=<=<=<=\n\n";
+  end_time.Print("Simulation end time");
+  records.Print("Log records");
+  replication_ms.Print("Replication ms");
+  std::cout << "\nTotal wall clock:  " << std::fixed << std::setprecision(1)
+            << wall_ms << " ms,  " << std::setprecision(2)
+            << (setup.replications * 1000.0 / wall_ms)
+            << " replications per second\n";
+
+  delete setup.stimulus;
+  return EXIT_SUCCESS;
+}  // main
@@ -0,0 +1,281 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for the binary stimulus format.
+*     In brief, this provides a main() that converts text stimulus files
+*     with BinaryStimConverter, checking that malformed and out of order
+*     files are refused, and that the narrowest tick difference width is
+*     chosen.  BinaryStimTextEventLoader must refuse binary files with
+*     corrupt column or payload offsets.  It then runs the text event
+*     example from each text file with StimTextEventLoader, and from its
+*     binary file with BinaryStimTextEventLoader, with and without
+*     prefetch, and every run must write the same log.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "common_strings.hpp"
+#include "common_utilities.hpp"
+#include "sim_time.hpp"
+#include "sim_exec.hpp"
+#include "sim_text_event.hpp"
+#include "stim_text_event_loader.hpp"
+#include "binary_stim_text_event_loader.hpp"
+#include "log_text_event.hpp"
+#include "shared_test_code.hpp"
+
+// The text event example's stimulus, which is not in time order
+const std::string kExampleStimulusPath("./test_ref/stim.csv");
+// Written by the test
+const std::string kOrderedStimulusPath("./test_out/ordered_stim.csv");
+const std::string kLargeStimulusPath("./test_out/large_stim.csv");
+const int kLargeRecordCount = 5000;
+const SimTime::UserTime kRunUntil = 1.0E5;
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n**********************************************"
+               "\n***  Welcome to the Binary Stimulus Test!  ***"
+               "\n**********************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Returns - the whole contents of the file at "path", or an empty string
+//       if it can't be read
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Writes "text" to the file at "path".
+void WriteFile(const std::string &path, const std::string &text) {
+  std::ofstream file(path, std::ios::binary);
+  file << text;
+}
+
+// Returns - the header of the binary file at "path", zeroed if the file
+//       can't be read
+BinaryStimHeader ReadHeader(const std::string &path) {
+  BinaryStimHeader header;
+  memset(&header, 0, sizeof(header));
+  std::ifstream file(path, std::ios::binary);
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  return header;
+}
+
+// Copies the binary file at "path", with the 64 bit value at "position"
+// replaced, then loads the copy in a child process, since the loader
+// exits when it refuses a file.
+//
+// "path" - pathname of a valid binary stimulus file
+// "position" - offset, in the file, of the value to replace
+// "value" - the replacement
+// Returns - "true" if the loader refused the copy
+bool LoaderRefuses(const std::string &path, size_t position,
+                   uint64_t value) {
+  const std::string copy_path("./test_out/corrupt.bin");
+  std::string contents = ReadFile(path);
+  memcpy(&contents[position], &value, sizeof(value));
+  WriteFile(copy_path, contents);
+  std::cout.flush();
+  const pid_t child = fork();
+  if (child == 0) {
+    // The refusal message is expected, so it isn't shown
+    if ((freopen("/dev/null", "w", stdout) == nullptr) ||
+        (freopen("/dev/null", "w", stderr) == nullptr)) {
+      _exit(EXIT_FAILURE);
+    }
+    BinaryStimTextEventLoader loader(copy_path);
+    _exit(EXIT_SUCCESS);
+  }
+  int status = 0;
+  return (child > 0) && (waitpid(child, &status, 0) == child) &&
+         WIFEXITED(status) && (WEXITSTATUS(status) != EXIT_SUCCESS);
+}
+
+// Writes a stimulus file, in time order, spanning several read windows,
+// with a mix of line endings and decimal places, and a gap that needs
+// wider tick differences.
+void WriteLargeStimulus() {
+  std::ofstream stim_file(kLargeStimulusPath);
+  stim_file << "\"TIME\",\"TEXT\"\n";
+  for (int record = 0; record < kLargeRecordCount; ++record) {
+    const SimTime::UserTime time = record * 0.73L +
+        ((record >= kLargeRecordCount / 2) ? 5000.0L : 0.0L);
+    stim_file << std::fixed << std::setprecision(2 + record % 3) << time
+              << ",\"Rec" << record << "\""
+              << (((record % 7) == 0) ? "\r\n" : "\n");
+  }
+}
+
+// Runs the text event example from a loader, on a new executive.
+//
+// "loader" - the loader to run from.  The executive takes it over.
+// "log_path" - pathname of the log file to write
+void RunTextEventSim(StimLoader *loader, const std::string &log_path) {
+  SimExec *exec = new SimExec;
+  LogTextEvent *log_mgr = new LogTextEvent(log_path);
+  log_mgr->WriteHeaderOrDie();
+  exec->Init(SimTime(kRunUntil), nullptr, log_mgr, loader);
+  exec->RunTyped<SimTextEvent>();
+  exec->TearDown();
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  // The converter
+  const std::string refused_path("./test_out/refused.bin");
+  Report("Out of order stimulus is refused",
+         (BinaryStimConverter::ConvertCsv(kExampleStimulusPath,
+                                          refused_path) == -1) &&
+         !UtilFileExists(refused_path), &passed, &failed);
+  WriteFile("./test_out/malformed.csv", "1.0,\"a\"\n2.0 \"b\"\n3.0,\"c\"\n");
+  Report("Malformed stimulus is refused",
+         (BinaryStimConverter::ConvertCsv("./test_out/malformed.csv",
+                                          refused_path) == -1) &&
+         !UtilFileExists(refused_path), &passed, &failed);
+  Report("Missing stimulus is refused",
+         BinaryStimConverter::ConvertCsv("./test_out/missing.csv",
+                                         refused_path) == -1,
+         &passed, &failed);
+
+  WriteFile(kOrderedStimulusPath,
+            "\"TIME\",\"TEXT\"\r\n1.0,\"Time1.0\"\r\n3.0,\"Time3.0\"\r\n"
+            "3.0,\"2Time3.0\"\n2.5e1,\"a,b\"\"c\"\"\"\n27.3,Plain\n");
+  const std::string ordered_binary("./test_out/ordered_stim.bin");
+  const long long ordered_count =
+      BinaryStimConverter::ConvertCsv(kOrderedStimulusPath, ordered_binary);
+  const BinaryStimHeader ordered = ReadHeader(ordered_binary);
+  Report("Ordered stimulus converted, past its header line",
+         (ordered_count == 5) && (ordered.record_count == 5) &&
+         (memcmp(ordered.magic, kBinaryStimMagic, sizeof(ordered.magic)) ==
+          0) && (ordered.version == kBinaryStimVersion) &&
+         (ordered.base_ticks == SimTime(1.0).ticks()), &passed, &failed);
+  Report("Tick differences up to 22.0 are two bytes wide",
+         ordered.delta_width == 2, &passed, &failed);
+  BinaryStimTextEventLoader ordered_loader(ordered_binary);
+  Report("Loader reads the header",
+         (ordered_loader.record_count() == 5) &&
+         (ordered_loader.delta_width() == 2) && ordered_loader.StimFileOK(),
+         &passed, &failed);
+
+  // Corrupt files are refused, rather than read past the end of the file
+  const size_t offsets_at = ordered.offsets_offset;
+  uint64_t first_offset = 0;
+  memcpy(&first_offset, ReadFile(ordered_binary).data() + offsets_at,
+         sizeof(first_offset));
+  Report("Loader accepts an unchanged copy",
+         !LoaderRefuses(ordered_binary, offsets_at, first_offset),
+         &passed, &failed);
+  Report("Loader refuses a payload offset past the end",
+         LoaderRefuses(ordered_binary, offsets_at + sizeof(uint64_t),
+                       ordered.file_size), &passed, &failed);
+  Report("Loader refuses payload offsets out of order",
+         LoaderRefuses(ordered_binary, offsets_at + 2 * sizeof(uint64_t),
+                       0), &passed, &failed);
+  Report("Loader refuses a column offset that wraps around",
+         LoaderRefuses(ordered_binary,
+                       offsetof(BinaryStimHeader, deltas_offset),
+                       ~static_cast<uint64_t>(0) - 7), &passed, &failed);
+
+  WriteFile("./test_out/wide_stim.csv", "1.0,\"a\"\n1.0e15,\"b\"\n");
+  const std::string wide_binary("./test_out/wide_stim.bin");
+  Report("Large tick differences are eight bytes wide",
+         (BinaryStimConverter::ConvertCsv("./test_out/wide_stim.csv",
+                                          wide_binary) == 2) &&
+         (ReadHeader(wide_binary).delta_width == 8), &passed, &failed);
+
+  // Whole runs, against the stream loader
+  WriteLargeStimulus();
+  const std::string large_binary("./test_out/large_stim.bin");
+  Report("Large stimulus converted, with four byte tick differences",
+         (BinaryStimConverter::ConvertCsv(kLargeStimulusPath,
+                                          large_binary) ==
+          kLargeRecordCount) &&
+         (ReadHeader(large_binary).delta_width == 4), &passed, &failed);
+  const std::string stimuli[] = {kOrderedStimulusPath, kLargeStimulusPath};
+  const std::string binaries[] = {ordered_binary, large_binary};
+  const std::string names[] = {"Ordered", "Large"};
+  for (int stimulus = 0; stimulus < 2; ++stimulus) {
+    const std::string prefix("./test_out/" + names[stimulus]);
+    RunTextEventSim(new StimTextEventLoader(stimuli[stimulus]),
+                    prefix + "_stream.csv");
+    RunTextEventSim(new BinaryStimTextEventLoader(binaries[stimulus]),
+                    prefix + "_binary.csv");
+    BinaryStimTextEventLoader *prefetching =
+        new BinaryStimTextEventLoader(binaries[stimulus]);
+    prefetching->set_prefetch(true);
+    RunTextEventSim(prefetching, prefix + "_prefetch.csv");
+    const std::string reference = ReadFile(prefix + "_stream.csv");
+    Report(names[stimulus] + " stimulus logged",
+           reference.size() > 50, &passed, &failed);
+    Report(names[stimulus] + " stimulus, binary, matches the stream loader",
+           ReadFile(prefix + "_binary.csv") == reference, &passed, &failed);
+    Report(names[stimulus] + " stimulus, binary and prefetched, matches",
+           ReadFile(prefix + "_prefetch.csv") == reference,
+           &passed, &failed);
+  }
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC BINARY STIMULUS TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
@@ -0,0 +1,453 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for running several simulations
+*     in one process.  In brief, this provides a main() that runs the text
+*     event example once through SimExec::the_exec(), as a single
+*     simulation program would, then runs the same simulation on several
+*     executives at once, each on its own thread, all reading the same
+*     stimulus file.  Every log must match the single run's, and each
+*     executive must be the current one on its own thread while it runs.
+*     Finally, two executives are initialized on one thread before either
+*     runs, to check that each stimulus loader feeds its own executive.
+*     Last, several simulations load their events from one shared, parsed
+*     copy of the stimulus, as the replication runner does, and each must
+*     log the same records as the single run.
+*     Simulations whose loader reads each window ahead, on a thread of its
+*     own, must also match the single run.  A long, dense stimulus is then
+*     run with prefetch, and the EventPool must not carve a slab for every
+*     few events, though each is created on the prefetch thread and
+*     deleted on the executive's.
+*     The inbox checks have producer threads inject events into a running
+*     executive, which must dispatch every one of them, none before its
+*     time, and late ones at the current time.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_exec.hpp"
+#include "event_pool.hpp"
+#include "sim_text_event.hpp"
+#include "stim_text_event_loader.hpp"
+#include "shared_stim_text_event_loader.hpp"
+#include "log_text_event.hpp"
+#include "shared_test_code.hpp"
+
+// Stimulus shared, read only, by every simulation
+const std::string kStimulusPath("./test_ref/stim.csv");
+const SimTime::UserTime kRunUntil = 1.0E4;
+// Time of the callback that checks the current executive
+const SimTime::UserTime kCheckTime = 1500.0;
+// Number of simulations run at once
+const int kSimCount = 4;
+// Threads injecting events into one executive, and events each injects
+const int kProducerCount = 3;
+const int kInjectedPerProducer = 20000;
+// The dense stimulus: records, and the time between them, so that every
+// read window holds "kDenseRecordsPerWindow" events
+const std::string kDenseStimulusPath("./test_out/dense_stim.csv");
+const int kDenseRecordCount = 120000;
+const SimTime::UserTime kDenseSpacing = 0.1;
+const int kDenseRecordsPerWindow = 10000;
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n*****************************************************"
+               "\n***  Welcome to the Concurrent Simulations Test!  ***"
+               "\n*****************************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Returns - the whole contents of the file at "path", or an empty string
+//       if it can't be read
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Initializes "exec" for the text event example.
+//
+// "exec" - the executive to initialize
+// "log_path" - pathname of the log file to write
+// "saw_own_exec" - set, by a callback at "kCheckTime", to whether "exec"
+//       was the current executive of the thread running it
+// "prefetch" - "true" to have the loader read each window ahead
+void InitTextEventSim(SimExec *exec, const std::string &log_path,
+                      bool *saw_own_exec, bool prefetch = false) {
+  LogTextEvent *log_mgr = new LogTextEvent(log_path);
+  log_mgr->WriteHeaderOrDie();
+  StimTextEventLoader *loader = new StimTextEventLoader(kStimulusPath);
+  loader->set_prefetch(prefetch);
+  exec->Init(SimTime(kRunUntil), nullptr, log_mgr, loader);
+  *saw_own_exec = false;
+  exec->ScheduleCallback(SimTime(kCheckTime), [exec, saw_own_exec] {
+    *saw_own_exec = (SimExec::current() == exec);
+  });
+}
+
+// Runs the text event example, start to finish, on a new executive.
+// Called on its own thread.
+//
+// "log_path" - pathname of the log file to write
+// "typed" - "true" to run with RunTyped(), "false" to run with Run()
+// "saw_own_exec" - receives whether the executive was current while
+//       running
+// "prefetch" - "true" to have the loader read each window ahead
+void RunTextEventSim(const std::string &log_path, bool typed,
+                     bool *saw_own_exec, bool prefetch = false) {
+  SimExec *exec = new SimExec;
+  InitTextEventSim(exec, log_path, saw_own_exec, prefetch);
+  if (typed) {
+    exec->RunTyped<SimTextEvent>();
+  } else {
+    exec->Run();
+  }
+  exec->TearDown();
+}
+
+// Writes the dense stimulus file, spanning many read windows.
+void WriteDenseStimulus() {
+  std::ofstream stim_file(kDenseStimulusPath);
+  stim_file << "\"TIME\",\"TEXT\"\n";
+  for (int record = 0; record < kDenseRecordCount; ++record) {
+    stim_file << std::fixed << std::setprecision(1)
+              << (1.0 + record * kDenseSpacing) << ",\"Rec" << record
+              << "\"\n";
+  }
+}
+
+// Runs the dense stimulus with prefetch, on this thread, and counts the
+// slabs the EventPool carves meanwhile.
+//
+// Returns - the number of slabs carved
+uint64_t DenseStimulusSlabs() {
+  const uint64_t slabs = EventPool::SlabCount();
+  SimExec *exec = new SimExec;
+  LogTextEvent *log_mgr = new LogTextEvent("./test_out/DENSE_PREFETCH.csv");
+  log_mgr->WriteHeaderOrDie();
+  StimTextEventLoader *loader = new StimTextEventLoader(kDenseStimulusPath);
+  loader->set_prefetch(true);
+  exec->Init(SimTime(kDenseRecordCount * kDenseSpacing + 10.0), nullptr,
+             log_mgr, loader);
+  std::ofstream discard("/dev/null");
+  std::streambuf *const stdout_buffer = std::cout.rdbuf(discard.rdbuf());
+  exec->RunTyped<SimTextEvent>();
+  std::cout.rdbuf(stdout_buffer);
+  exec->TearDown();
+  return EventPool::SlabCount() - slabs;
+}
+
+// Runs the text event example on a new executive, loading its events
+// from a shared copy of the stimulus.  Called on its own thread.
+//
+// "stimulus" - the parsed stimulus, shared with other simulations
+// "log_path" - pathname of the log file to write
+// "records" - receives the number of log records written
+void RunSharedStimulusSim(const SharedTextStimulus *stimulus,
+                          const std::string &log_path,
+                          unsigned long *records) {
+  SimExec *exec = new SimExec;
+  LogTextEvent *log_mgr = new LogTextEvent(log_path);
+  log_mgr->WriteHeaderOrDie();
+  exec->Init(SimTime(kRunUntil), nullptr, log_mgr,
+             new SharedStimTextEventLoader(stimulus));
+  exec->RunTyped<SimTextEvent>();
+  *records = log_mgr->records_written();
+  exec->TearDown();
+}
+
+// What the injected events saw as they were dispatched.  Only touched on
+// the thread running the executive.
+struct InjectionTally {
+  long dispatched;
+  // Dispatched earlier than the time they were injected for
+  long early;
+  // Dispatched at an earlier time than the event dispatched before them
+  long out_of_order;
+  SimTime last_time;
+};
+
+// Injects events into "exec", which is running on another thread, at
+// times spread from 0 to 100, so that some are late.  Retries whenever the
+// inbox is full.
+//
+// "exec" - the executive to inject into
+// "tally" - updated by the events as they are dispatched
+// "producers_done" - incremented once every event has been injected
+void InjectEvents(SimExec *exec, InjectionTally *tally,
+                  std::atomic<int> *producers_done) {
+  for (int event = 0; event < kInjectedPerProducer; ++event) {
+    const SimTime event_time((event % 1000) / 10.0);
+    SimBaseEvent *new_event = new CallbackEvent(event_time,
+        [exec, tally, event_time] {
+      tally->dispatched++;
+      if (exec->curr_time().EarlierThan(event_time)) {
+        tally->early++;
+      }
+      if (exec->curr_time().EarlierThan(tally->last_time)) {
+        tally->out_of_order++;
+      }
+      tally->last_time = exec->curr_time();
+    });
+    while (!exec->InjectEvent(new_event)) {
+      std::this_thread::yield();
+    }
+  }
+  (*producers_done)++;
+}
+
+// Keeps the run going, one time unit at a time, until every producer is
+// done.  The run then drains the last of the inbox, and ends once those
+// events are dispatched.
+//
+// "exec" - the executive being injected into
+// "producers_done" - number of producers that are done
+void ScheduleHeartbeat(SimExec *exec, std::atomic<int> *producers_done) {
+  exec->ScheduleCallback(SimTime(exec->curr_time().GetUserTime() + 1.0),
+                         [exec, producers_done] {
+    if (*producers_done < kProducerCount) {
+      std::this_thread::yield();
+      ScheduleHeartbeat(exec, producers_done);
+    }
+  });
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  // The reference run, as a single simulation program would do it
+  const std::string reference_path("./test_out/CONCURRENT_REF.csv");
+  bool reference_saw_own = false;
+  InitTextEventSim(SimExec::the_exec(), reference_path, &reference_saw_own);
+  SimExec::the_exec()->Run();
+  SimExec::the_exec()->TearDown();
+  const std::string reference = ReadFile(reference_path);
+  Report("Reference run logged", reference.size() > 1000, &passed, &failed);
+  Report("Reference run was current", reference_saw_own, &passed, &failed);
+  Report("No current executive after TearDown()",
+         SimExec::current() == nullptr, &passed, &failed);
+
+  // The same simulation, several at once, half of them typed
+  std::vector<std::thread> threads;
+  bool saw_own_exec[kSimCount];
+  for (int sim = 0; sim < kSimCount; ++sim) {
+    threads.push_back(std::thread(RunTextEventSim,
+        "./test_out/CONCURRENT_" + std::to_string(sim) + ".csv",
+        (sim % 2) == 1, &saw_own_exec[sim], false));
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  for (int sim = 0; sim < kSimCount; ++sim) {
+    const std::string label("Concurrent simulation " + std::to_string(sim));
+    Report(label + " log matches the reference",
+           ReadFile("./test_out/CONCURRENT_" + std::to_string(sim) +
+                    ".csv") == reference, &passed, &failed);
+    Report(label + " was current on its thread", saw_own_exec[sim],
+           &passed, &failed);
+  }
+  Report("Main thread still has no current executive",
+         SimExec::current() == nullptr, &passed, &failed);
+
+  // Two executives initialized on one thread before either runs.  The
+  // second Init() leaves the second one current, but the first one's
+  // stimulus must still reach the first one.
+  SimExec first;
+  SimExec second;
+  bool first_saw_own = false;
+  bool second_saw_own = false;
+  InitTextEventSim(&first, "./test_out/CONCURRENT_FIRST.csv", &first_saw_own);
+  InitTextEventSim(&second, "./test_out/CONCURRENT_SECOND.csv",
+                   &second_saw_own);
+  first.Run();
+  second.RunTyped<SimTextEvent>();
+  Report("First of two on one thread matches the reference",
+         first_saw_own &&
+         (ReadFile("./test_out/CONCURRENT_FIRST.csv") == reference),
+         &passed, &failed);
+  Report("Second of two on one thread matches the reference",
+         second_saw_own &&
+         (ReadFile("./test_out/CONCURRENT_SECOND.csv") == reference),
+         &passed, &failed);
+
+  // Reading each window ahead, alone and several at once
+  bool prefetch_saw_own = false;
+  RunTextEventSim("./test_out/CONCURRENT_PREFETCH.csv", false,
+                  &prefetch_saw_own, true);
+  Report("Prefetching simulation matches the reference",
+         prefetch_saw_own &&
+         (ReadFile("./test_out/CONCURRENT_PREFETCH.csv") == reference),
+         &passed, &failed);
+  std::vector<std::thread> prefetch_threads;
+  for (int sim = 0; sim < kSimCount; ++sim) {
+    prefetch_threads.push_back(std::thread(RunTextEventSim,
+        "./test_out/CONCURRENT_PREFETCH_" + std::to_string(sim) + ".csv",
+        (sim % 2) == 1, &saw_own_exec[sim], true));
+  }
+  for (std::thread &thread : prefetch_threads) {
+    thread.join();
+  }
+  bool prefetch_match = true;
+  for (int sim = 0; sim < kSimCount; ++sim) {
+    prefetch_match = prefetch_match && saw_own_exec[sim] &&
+        (ReadFile("./test_out/CONCURRENT_PREFETCH_" + std::to_string(sim) +
+                  ".csv") == reference);
+  }
+  Report("Concurrent prefetching simulations match the reference",
+         prefetch_match, &passed, &failed);
+
+  // At most two windows are alive at once, the one being dispatched and
+  // the one read ahead, plus what the threads' lists hold
+  WriteDenseStimulus();
+  const uint64_t dense_slabs = DenseStimulusSlabs();
+  std::cout << "Slabs carved for " << kDenseRecordCount
+            << " prefetched events: " << dense_slabs << "\n";
+  Report("Prefetched events don't grow the event pool without limit",
+         dense_slabs * EventPool::kBlocksPerSlab <=
+         3 * kDenseRecordsPerWindow + 2 * EventPool::kMaxCachedBlocks,
+         &passed, &failed);
+
+  // Several simulations loading from one parsed copy of the stimulus
+  const SharedTextStimulus stimulus(kStimulusPath);
+  Report("Shared stimulus holds every record",
+         stimulus.records().size() == 3000, &passed, &failed);
+  std::vector<std::thread> shared_threads;
+  unsigned long records[kSimCount];
+  for (int sim = 0; sim < kSimCount; ++sim) {
+    shared_threads.push_back(std::thread(RunSharedStimulusSim, &stimulus,
+        "./test_out/CONCURRENT_SHARED_" + std::to_string(sim) + ".csv",
+        &records[sim]));
+  }
+  for (std::thread &thread : shared_threads) {
+    thread.join();
+  }
+  for (int sim = 0; sim < kSimCount; ++sim) {
+    Report("Shared stimulus simulation " + std::to_string(sim) +
+           " matches the reference",
+           (records[sim] == stimulus.records().size()) &&
+           (ReadFile("./test_out/CONCURRENT_SHARED_" + std::to_string(sim) +
+                     ".csv") == reference), &passed, &failed);
+  }
+
+  // Inbox: injected before the run, from the executive's own thread.  The
+  // inbox is bounded, and a full one refuses the event.
+  SimExec *bounded = new SimExec;
+  InjectionTally bounded_tally = {0, 0, 0, SimTime(0.0)};
+  size_t accepted = 0;
+  SimBaseEvent *refused = nullptr;
+  for (size_t event = 0; event <= SimExec::kInboxCapacity; ++event) {
+    SimBaseEvent *new_event = new CallbackEvent(SimTime(5.0),
+        [&bounded_tally] { bounded_tally.dispatched++; });
+    if (bounded->InjectEvent(new_event)) {
+      accepted++;
+    } else {
+      refused = new_event;
+    }
+  }
+  Report("Inbox accepts events up to its capacity",
+         accepted == SimExec::kInboxCapacity, &passed, &failed);
+  Report("Full inbox refuses the next event", refused != nullptr,
+         &passed, &failed);
+  delete refused;
+  bounded->Init(SimTime(kRunUntil), nullptr,
+                new LogTextEvent("./test_out/CONCURRENT_BOUNDED.csv"),
+                new SharedStimTextEventLoader(&stimulus));
+  bounded->Run();
+  Report("Events injected before the run are all dispatched",
+         (bounded_tally.dispatched ==
+          static_cast<long>(SimExec::kInboxCapacity)) &&
+         (bounded->late_injection_count() == 0), &passed, &failed);
+  bounded->TearDown();
+
+  // Inbox: several producers injecting into a running executive
+  SimExec *injected = new SimExec;
+  InjectionTally tally = {0, 0, 0, SimTime(0.0)};
+  std::atomic<int> producers_done(0);
+  injected->Init(SimTime(SimTime::GetMaxUserTime()), nullptr,
+                 new LogTextEvent("./test_out/CONCURRENT_INJECTED.csv"),
+                 new SharedStimTextEventLoader(&stimulus));
+  ScheduleHeartbeat(injected, &producers_done);
+  std::thread exec_thread([injected] { injected->Run(); });
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducerCount; ++producer) {
+    producers.push_back(std::thread(InjectEvents, injected, &tally,
+                                    &producers_done));
+  }
+  for (std::thread &producer : producers) {
+    producer.join();
+  }
+  exec_thread.join();
+  Report("Every injected event was dispatched",
+         tally.dispatched == kProducerCount * kInjectedPerProducer,
+         &passed, &failed);
+  Report("No injected event was dispatched early", tally.early == 0,
+         &passed, &failed);
+  Report("Injected events were dispatched in time order",
+         tally.out_of_order == 0, &passed, &failed);
+  std::cout << "  (" << injected->late_injection_count()
+            << " injected events arrived late)\n";
+  injected->TearDown();
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC CONCURRENT SIMULATIONS TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
@@ -0,0 +1,342 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for the event handles of the
+*     simulation executive.  In brief, this provides a main() and code
+*     that schedules events, singly and in a batch, cancels and reschedules
+*     some of them, both before and during the run, then verifies which
+*     events were dispatched, in what order, and that every event was
+*     deleted.  The test is repeated for each pending event set, and once
+*     more with the events dispatched by type, through SimExec::RunTyped().
+*     Events that are dispatched in batches are checked to keep the same
+*     order.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "sim_exec.hpp"
+#include "pending_event_set.hpp"
+#include "sim_text_event.hpp"
+#include "stim_text_event_loader.hpp"
+#include "log_text_event.hpp"
+#include "shared_test_code.hpp"
+
+// Identifiers of the events dispatched so far, in dispatch order
+static std::vector<int> dispatched;
+// Number of HandleTestEvent objects created / deleted
+static int created = 0;
+static int destroyed = 0;
+
+// Handles used by the events that act on other events while dispatching
+static EventHandle too_late_handle;
+static EventHandle same_time_handle;
+// Results of those actions
+static bool reschedule_past_rejected = false;
+static bool same_time_cancelled = false;
+
+// Event that records its dispatch, and counts its own creation and
+// deletion.  The event with "kActorId" cancels and reschedules other
+// events when it is dispatched.
+class HandleTestEvent final : public SimBaseEvent {
+ public:
+  static const int kActorId = 6;
+  // Type id for EventRegistry
+  static const uint16_t kEventTypeId = SimTextEvent::kEventTypeId + 1;
+
+  // "event_time" - time at which the event is scheduled
+  // "id" - identifier recorded when the event is dispatched
+  HandleTestEvent(const SimTime &event_time, int id)
+      : SimBaseEvent(event_time, kEventTypeId), id_(id) { ++created; };
+  virtual ~HandleTestEvent() { ++destroyed; };
+
+  virtual void Dispatch() const {
+    dispatched.push_back(id_);
+    if (id_ == kActorId) {
+      SimExec *exec = SimExec::the_exec();
+      // Moving an event to before the current time must fail, and leave
+      // the event where it was
+      SimTime past(exec->curr_time().GetUserTime() - 5.0);
+      reschedule_past_rejected = !exec->RescheduleEvent(too_late_handle,
+                                                        past) &&
+                                 exec->IsScheduled(too_late_handle);
+      // An event at the current time, that hasn't been dispatched yet, can
+      // still be cancelled
+      same_time_cancelled = exec->CancelEvent(same_time_handle);
+    }
+  }
+
+ private:
+  // Identifier recorded when the event is dispatched
+  int id_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(HandleTestEvent);
+};  // class HandleTestEvent
+
+// Sizes of the batches passed to BatchTestEvent::DispatchBatch()
+static std::vector<size_t> batch_sizes;
+
+// Event that is dispatched in batches, and records its dispatch.  The
+// event with "kSpawnerId" schedules another at the same time.
+class BatchTestEvent final : public SimBaseEvent {
+ public:
+  static const int kSpawnerId = 1;
+  static const int kSpawnedId = 10;
+  // Type id for EventRegistry
+  static const uint16_t kEventTypeId = HandleTestEvent::kEventTypeId + 1;
+
+  // "event_time" - time at which the event is scheduled
+  // "id" - identifier recorded when the event is dispatched
+  BatchTestEvent(const SimTime &event_time, int id)
+      : SimBaseEvent(event_time, kEventTypeId, true), id_(id) {};
+  virtual ~BatchTestEvent() {};
+
+  virtual void Dispatch() const {
+    dispatched.push_back(id_);
+    if (id_ == kSpawnerId) {
+      SimExec *exec = SimExec::the_exec();
+      exec->ScheduleEvent(new BatchTestEvent(exec->curr_time(), kSpawnedId));
+    }
+  }
+
+  virtual void DispatchBatch(const SimBaseEvent *const *events,
+                             size_t count) const {
+    batch_sizes.push_back(count);
+    for (size_t i = 0; i < count; ++i) {
+      static_cast<const BatchTestEvent *>(events[i])->Dispatch();
+    }
+  }
+
+ private:
+  // Identifier recorded when the event is dispatched
+  int id_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(BatchTestEvent);
+};  // class BatchTestEvent
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n*******************************************"
+               "\n***  Welcome to the Event Handle Test!  ***"
+               "\n*******************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// "path" - pathname of a file
+// Returns - the contents of the file
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Runs the whole scenario on a fresh executive using the named event set.
+// The log is written to "./test_out/log_<label>.csv".
+//
+// "name" - name of the pending event set, as known to NewEventSet()
+// "typed" - "true" to run with RunTyped(), "false" to run with Run()
+// "passed" / "failed" - counters to update
+void TestHandles(const std::string &name, bool typed,
+                 int *passed, int *failed) {
+  const std::string label(typed ? (name + "_typed") : name);
+  dispatched.clear();
+  created = 0;
+  destroyed = 0;
+  reschedule_past_rejected = false;
+  same_time_cancelled = false;
+
+  SimExec *exec = SimExec::the_exec();
+  exec->Init(SimTime(100.0), nullptr,
+             new LogTextEvent("./test_out/log_" + label + ".csv"),
+             new StimTextEventLoader("./test_ref/stim.csv"),
+             PendingEventSet::NewEventSet(name));
+
+  EventHandle handle_1 = exec->ScheduleEvent(new HandleTestEvent(10.0, 1));
+  EventHandle handle_2 = exec->ScheduleEvent(new HandleTestEvent(20.0, 2));
+  exec->ScheduleEvent(new HandleTestEvent(20.0, 3));
+  EventHandle handle_4 = exec->ScheduleEvent(new HandleTestEvent(30.0, 4));
+  EventHandle handle_5 = exec->ScheduleEvent(new HandleTestEvent(40.0, 5));
+  exec->ScheduleEvent(new HandleTestEvent(50.0, HandleTestEvent::kActorId));
+  too_late_handle = exec->ScheduleEvent(new HandleTestEvent(60.0, 7));
+  same_time_handle = exec->ScheduleEvent(new HandleTestEvent(50.0, 8));
+
+  // Cancelled events are deleted immediately, and only once
+  const int destroyed_before = destroyed;
+  bool cancel_ok = exec->CancelEvent(handle_2) &&
+                   (destroyed == destroyed_before + 1) &&
+                   !exec->IsScheduled(handle_2) &&
+                   !exec->CancelEvent(handle_2) &&
+                   !exec->CancelEvent(EventHandle());
+  Report(label + " cancel", cancel_ok, passed, failed);
+
+  // The slot freed by the cancelled event is reused, but the old handle
+  // must stay stale
+  EventHandle handle_9 = exec->ScheduleEvent(new HandleTestEvent(70.0, 9));
+  Report(label + " stale handle after slot reuse",
+         exec->IsScheduled(handle_9) && !exec->IsScheduled(handle_2) &&
+         !exec->RescheduleEvent(handle_2, SimTime(80.0)),
+         passed, failed);
+
+  // Event 4 moves to 20.0, behind event 3, which was already there.  Event
+  // 1 moves earlier, and event 5 moves beyond the end of the run.
+  Report(label + " reschedule",
+         exec->RescheduleEvent(handle_4, SimTime(20.0)) &&
+         exec->RescheduleEvent(handle_1, SimTime(5.0)) &&
+         exec->RescheduleEvent(handle_5, SimTime(200.0)) &&
+         exec->IsScheduled(handle_4), passed, failed);
+
+  // A batch, out of time order.  Event 11 lands behind event 1, and event
+  // 10 behind event 4.  Batch handles work like any others.
+  std::vector<EventHandle> batch_handles;
+  exec->ScheduleEvents({new HandleTestEvent(20.0, 10),
+                        new HandleTestEvent(5.0, 11),
+                        new HandleTestEvent(20.0, 12)}, &batch_handles);
+  Report(label + " batch schedule",
+         (batch_handles.size() == 3) &&
+         exec->IsScheduled(batch_handles[0]) &&
+         exec->CancelEvent(batch_handles[2]), passed, failed);
+
+  if (typed) {
+    exec->RunTyped<SimTextEvent, HandleTestEvent>();
+  } else {
+    exec->Run();
+  }
+
+  const std::vector<int> expected = {1, 11, 3, 4, 10,
+                                     HandleTestEvent::kActorId, 7, 9};
+  Report(label + " dispatch order", dispatched == expected, passed, failed);
+  Report(label + " actions during dispatch",
+         reschedule_past_rejected && same_time_cancelled, passed, failed);
+  Report(label + " handles stale after dispatch",
+         !exec->IsScheduled(handle_1) && !exec->CancelEvent(handle_4) &&
+         exec->IsScheduled(handle_5), passed, failed);
+
+  exec->TearDown();
+  Report(label + " every event deleted", (created == destroyed) &&
+         (created == 12), passed, failed);
+}
+
+// Dispatches runs of batched events, split by an event of another type,
+// and checks that the order is the same as one at a time.  An event
+// scheduled by the first batch, at the same time, joins the next one.
+//
+// "name" - name of the pending event set, as known to NewEventSet()
+// "typed" - "true" to run with RunTyped(), "false" to run with Run()
+// "passed" / "failed" - counters to update
+void TestBatches(const std::string &name, bool typed,
+                 int *passed, int *failed) {
+  const std::string label(typed ? (name + "_typed") : name);
+  dispatched.clear();
+  batch_sizes.clear();
+
+  SimExec *exec = SimExec::the_exec();
+  exec->Init(SimTime(100.0), nullptr,
+             new LogTextEvent("./test_out/log_batch_" + label + ".csv"),
+             new StimTextEventLoader("./test_ref/stim.csv"),
+             PendingEventSet::NewEventSet(name));
+  exec->ScheduleEvent(new BatchTestEvent(10.0, BatchTestEvent::kSpawnerId));
+  exec->ScheduleEvent(new BatchTestEvent(10.0, 2));
+  exec->ScheduleEvent(new HandleTestEvent(10.0, 3));
+  exec->ScheduleEvent(new BatchTestEvent(10.0, 4));
+  exec->ScheduleEvent(new BatchTestEvent(10.0, 5));
+  exec->ScheduleEvent(new BatchTestEvent(20.0, 7));
+  exec->ScheduleEvent(new HandleTestEvent(20.0, 8));
+  exec->ScheduleEvents({new BatchTestEvent(10.0, 6),
+                        new BatchTestEvent(10.0, 9)});
+  if (typed) {
+    exec->RunTyped<SimTextEvent, HandleTestEvent, BatchTestEvent>();
+  } else {
+    exec->Run();
+  }
+  exec->TearDown();
+
+  const std::vector<int> expected = {1, 2, 3, 4, 5, 6, 9,
+                                     BatchTestEvent::kSpawnedId, 7, 8};
+  const std::vector<size_t> expected_sizes = {2, 5, 1};
+  Report(label + " batch dispatch order", dispatched == expected,
+         passed, failed);
+  Report(label + " batch sizes", batch_sizes == expected_sizes,
+         passed, failed);
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  const char *const kEventSetNames[] = {"HEAP", "LIST", "CALENDAR", "LADDER",
+                                        "RADIX", "WHEEL", "WHEEL+LADDER"};
+  for (const char *name : kEventSetNames) {
+    TestHandles(name, false, &passed, &failed);
+  }
+  for (const char *name : kEventSetNames) {
+    TestBatches(name, false, &passed, &failed);
+  }
+  TestBatches("HEAP", true, &passed, &failed);
+  // Dispatching by type changes nothing but the calls, so the log is the
+  // same, stimulus timers and all
+  TestHandles("HEAP", true, &passed, &failed);
+  Report("HEAP typed log", ReadFile("./test_out/log_HEAP_typed.csv") ==
+                           ReadFile("./test_out/log_HEAP.csv"),
+         &passed, &failed);
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC EVENT HANDLE TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
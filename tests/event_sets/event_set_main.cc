@@ -0,0 +1,632 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for the pending event set
+*     classes.  In brief, this provides a main() and code that pushes
+*     events onto each event set, then verifies that they are removed
+*     in time order, with events at the same time removed in the order
+*     in which they were pushed (FIFO).
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "pending_event_set.hpp"
+#include "event_heap.hpp"
+#include "calendar_queue.hpp"
+#include "ladder_queue.hpp"
+#include "radix_heap.hpp"
+#include "timing_wheel.hpp"
+#include "shared_test_code.hpp"
+
+// Minimal event that remembers the order in which it was created, so the
+// tests can confirm FIFO ordering among events with identical times.
+class OrderedTestEvent : public SimBaseEvent {
+ public:
+  // "event_time" - time at which the event is scheduled
+  // "order" - creation order of this event
+  OrderedTestEvent(const SimTime &event_time, unsigned int order)
+      : SimBaseEvent(event_time), order_(order) {};
+  virtual ~OrderedTestEvent() {};
+
+  // Nothing to do, these events are never dispatched
+  virtual void Dispatch() const {};
+
+  // Returns - the creation order of this event
+  unsigned int order() const { return order_; }
+
+ private:
+  // Creation order of this event
+  unsigned int order_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(OrderedTestEvent);
+};  // class OrderedTestEvent
+
+// Stimulus, or follow-up, event for the bursty load test.  Follow-ups
+// are marked so that they don't schedule follow-ups of their own.
+class BurstTestEvent : public OrderedTestEvent {
+ public:
+  // "event_time" - time at which the event is scheduled
+  // "order" - creation order of this event
+  // "follow_up" - "true" if this event was scheduled by another event
+  BurstTestEvent(const SimTime &event_time, unsigned int order,
+                 bool follow_up)
+      : OrderedTestEvent(event_time, order), follow_up_(follow_up) {};
+  virtual ~BurstTestEvent() {};
+
+  // Returns - "true" if this event was scheduled by another event
+  bool follow_up() const { return follow_up_; }
+
+ private:
+  // "true" if this event was scheduled by another event
+  bool follow_up_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(BurstTestEvent);
+};  // class BurstTestEvent
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n***********************************************"
+               "\n***  Welcome to the Pending Event Set Test!  ***"
+               "\n***********************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Creates "count" events with times drawn from a small range, so that
+// many of them share the same time.
+//
+// "count" - number of events to create
+// "events" - receives the new events, in creation order
+void MakeEvents(unsigned int count, std::vector<OrderedTestEvent *> *events) {
+  std::mt19937 generator(20140304);
+  std::uniform_int_distribution<int> hundredths(0, 5000);
+  for (unsigned int i = 0; i < count; ++i) {
+    SimTime::UserTime time = hundredths(generator) / 100.0L;
+    events->push_back(new OrderedTestEvent(SimTime(time), i));
+  }
+}
+
+// Checks that "event" may follow "previous" in dispatch order: times never
+// decrease, and events with the same time come out in creation order.
+//
+// Returns - "true" if the order is correct
+bool FollowsInOrder(const OrderedTestEvent &previous,
+                    const OrderedTestEvent &event) {
+  return !(event.EarlierThan(previous) ||
+           (event.SameTimeAs(previous) && event.order() < previous.order()));
+}
+
+// Pops every event from "event_set", checking the order of each pair.
+// Deletes the events as they are removed.
+//
+// "event_set" - the set to drain
+// "expected" - number of events that should be in the set
+// Returns - "true" if the ordering and the count were correct
+bool DrainInOrder(PendingEventSet *event_set, size_t expected) {
+  bool in_order = true;
+  size_t drained = 0;
+  OrderedTestEvent *previous = nullptr;
+  while (!event_set->Empty()) {
+    // PeekMin() must report the event that PopMin() removes
+    SimBaseEvent *peeked = event_set->PeekMin();
+    OrderedTestEvent *event =
+        static_cast<OrderedTestEvent *>(event_set->PopMin());
+    in_order = in_order && (peeked == event);
+    if (previous != nullptr) {
+      in_order = in_order && FollowsInOrder(*previous, *event);
+      delete previous;
+    }
+    previous = event;
+    ++drained;
+  }
+  delete previous;
+  return in_order && (drained == expected);
+}
+
+// Fills an event set with a batch of events, checks the dump order, then
+// drains it.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestOrdering(const std::string &label, PendingEventSet *event_set,
+                  int *passed, int *failed) {
+  const unsigned int kEventCount = 20000;
+  std::vector<OrderedTestEvent *> events;
+  MakeEvents(kEventCount, &events);
+  for (OrderedTestEvent *event : events) {
+    event_set->Push(event);
+  }
+  Report(label + " size after push", event_set->Size() == kEventCount,
+         passed, failed);
+
+  // The dump order must match the dispatch order
+  std::vector<SimBaseEvent *> ordered;
+  event_set->OrderedEvents(&ordered);
+  bool dump_ok = (ordered.size() == kEventCount);
+  for (size_t i = 1; dump_ok && (i < ordered.size()); ++i) {
+    dump_ok = FollowsInOrder(*static_cast<OrderedTestEvent *>(ordered[i - 1]),
+                             *static_cast<OrderedTestEvent *>(ordered[i]));
+  }
+  Report(label + " dump order", dump_ok, passed, failed);
+
+  Report(label + " time / FIFO order",
+         DrainInOrder(event_set, kEventCount), passed, failed);
+  delete event_set;
+}
+
+// Interleaves pushes and pops, the way the dispatch loop does: events
+// are only ever pushed at, or after, the time of the most recent pop.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestInterleaved(const std::string &label, PendingEventSet *event_set,
+                     int *passed, int *failed) {
+  std::mt19937 generator(1006);
+  std::uniform_int_distribution<int> delta(0, 3);
+  unsigned int order = 0;
+  for (int i = 0; i < 8; ++i) {
+    event_set->Push(new OrderedTestEvent(SimTime(0.0L), order++));
+  }
+  bool in_order = true;
+  OrderedTestEvent *previous = nullptr;
+  for (int i = 0; i < 10000; ++i) {
+    OrderedTestEvent *event =
+        static_cast<OrderedTestEvent *>(event_set->PopMin());
+    if (previous != nullptr) {
+      in_order = in_order && FollowsInOrder(*previous, *event);
+      delete previous;
+    }
+    previous = event;
+    // Schedule follow up events no earlier than "now"
+    SimTime now(event->event_time());
+    now.AddTime(static_cast<SimTime::UserTime>(delta(generator)));
+    event_set->Push(new OrderedTestEvent(now, order++));
+  }
+  delete previous;
+  Report(label + " interleaved push / pop order", in_order, passed, failed);
+  Report(label + " drain after interleaving", DrainInOrder(event_set, 8),
+         passed, failed);
+  delete event_set;
+}
+
+// Removes events from the middle of the set, both before and after the
+// set has started to reorganize itself by popping, then checks that the
+// rest are still removed in order.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestRemove(const std::string &label, PendingEventSet *event_set,
+                int *passed, int *failed) {
+  const unsigned int kEventCount = 3000;
+  std::vector<OrderedTestEvent *> events;
+  MakeEvents(kEventCount, &events);
+  for (OrderedTestEvent *event : events) {
+    event_set->Push(event);
+  }
+  // Every third event, before anything is popped
+  bool removed_ok = true;
+  std::set<SimBaseEvent *> gone;
+  for (size_t i = 0; i < events.size(); i += 3) {
+    removed_ok = removed_ok && event_set->Remove(events[i]);
+    // A second attempt must fail
+    removed_ok = removed_ok && !event_set->Remove(events[i]);
+    gone.insert(events[i]);
+  }
+  // Pop some, so that the set reorganizes itself, then remove more
+  for (int i = 0; i < 400; ++i) {
+    gone.insert(event_set->PopMin());
+  }
+  for (size_t i = 1; i < events.size(); i += 3) {
+    if (gone.count(events[i]) == 0) {
+      removed_ok = removed_ok && event_set->Remove(events[i]);
+      gone.insert(events[i]);
+    }
+  }
+  // Events no longer in the set can't be removed
+  for (size_t i = 0; i < events.size(); i += 3) {
+    removed_ok = removed_ok && !event_set->Remove(events[i]);
+  }
+  Report(label + " remove", removed_ok &&
+         (event_set->Size() == kEventCount - gone.size()), passed, failed);
+  Report(label + " time / FIFO order after remove",
+         DrainInOrder(event_set, kEventCount - gone.size()), passed, failed);
+  for (SimBaseEvent *event : gone) {
+    delete event;
+  }
+  delete event_set;
+}
+
+// Cancels most of the events while they wait, in rounds separated by
+// pops, the way a model that keeps rescheduling timeouts does.  Each
+// removed event is deleted at once, so a set that still held on to one
+// would touch freed memory.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestCancelHeavy(const std::string &label, PendingEventSet *event_set,
+                     int *passed, int *failed) {
+  const unsigned int kEventCount = 20000;
+  std::vector<OrderedTestEvent *> events;
+  MakeEvents(kEventCount, &events);
+  for (OrderedTestEvent *event : events) {
+    event_set->Push(event);
+  }
+  bool removed_ok = true;
+  size_t remaining = kEventCount;
+  std::vector<bool> gone(kEventCount, false);
+  // Three of every four events go, a quarter of them per round
+  for (unsigned int round = 1; round < 4; ++round) {
+    for (size_t i = round; i < kEventCount; i += 4) {
+      if (!gone[i]) {
+        removed_ok = removed_ok && event_set->Remove(events[i]);
+        delete events[i];
+        gone[i] = true;
+        --remaining;
+      }
+    }
+    for (int i = 0; i < 100; ++i) {
+      OrderedTestEvent *event =
+          static_cast<OrderedTestEvent *>(event_set->PopMin());
+      removed_ok = removed_ok && !gone[event->order()];
+      gone[event->order()] = true;
+      delete event;
+      --remaining;
+    }
+  }
+  Report(label + " cancel heavy", removed_ok &&
+         (event_set->Size() == remaining), passed, failed);
+  Report(label + " time / FIFO order after cancel heavy",
+         DrainInOrder(event_set, remaining), passed, failed);
+  delete event_set;
+}
+
+// Mixes batch pushes with single pushes.  Batches go into an empty set,
+// into a set smaller than the batch and into a set larger than the batch,
+// since an implementation may merge each case differently.  Events are
+// pushed in creation order, so FIFO order is creation order.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestPushBatch(const std::string &label, PendingEventSet *event_set,
+                   int *passed, int *failed) {
+  const unsigned int kEventCount = 6000;
+  std::vector<OrderedTestEvent *> events;
+  MakeEvents(kEventCount, &events);
+  // Boundaries of the batches.  The events in between are pushed singly.
+  const size_t kBatches[][2] = {{0, 500}, {1500, 5000}, {5000, 5500}};
+  size_t next = 0;
+  for (const size_t *batch : kBatches) {
+    for (; next < batch[0]; ++next) {
+      event_set->Push(events[next]);
+    }
+    event_set->PushBatch(std::vector<SimBaseEvent *>(events.begin() + batch[0],
+                                                     events.begin() +
+                                                     batch[1]));
+    next = batch[1];
+  }
+  for (; next < kEventCount; ++next) {
+    event_set->Push(events[next]);
+  }
+  event_set->PushBatch(std::vector<SimBaseEvent *>());
+  Report(label + " size after batch push", event_set->Size() == kEventCount,
+         passed, failed);
+  Report(label + " time / FIFO order after batch push",
+         DrainInOrder(event_set, kEventCount), passed, failed);
+  delete event_set;
+}
+
+// Clear() must empty the set, and delete the events.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestClear(const std::string &label, PendingEventSet *event_set,
+               int *passed, int *failed) {
+  std::vector<OrderedTestEvent *> events;
+  MakeEvents(100, &events);
+  for (OrderedTestEvent *event : events) {
+    event_set->Push(event);
+  }
+  event_set->Clear();
+  Report(label + " clear", event_set->Empty(), passed, failed);
+  delete event_set;
+}
+
+// Mimics the insertion pattern of StimLoader::LoadQueue(): a whole read
+// period of stimulus is pushed, in time order, in a single burst, followed
+// by the timer that loads the next period, at the time of the last record.
+// Half of the stimulus events schedule a follow-up when they are popped,
+// some shortly after, but most many read periods into the future.
+//
+// "label" - name of the event set for the result messages
+// "event_set" - the (empty) set to test.  Deleted before returning.
+// "passed" / "failed" - counters to update
+void TestBurstyLoad(const std::string &label, PendingEventSet *event_set,
+                    int *passed, int *failed) {
+  // Same period as StimLoader
+  const SimTime::UserTime kReadPeriod = 1.0E3;
+  const int kPeriodCount = 40;
+  const int kBurstSize = 500;
+  std::mt19937 generator(2005);
+  std::uniform_int_distribution<int> hundredths(0, kReadPeriod * 100 - 1);
+  std::uniform_int_distribution<int> follow_up(0, 3);
+  std::uniform_int_distribution<int> near_hundredths(0, 500);
+  std::uniform_int_distribution<int> far_periods(2, 50);
+
+  unsigned int order = 0;
+  int periods_loaded = 0;
+  size_t pushed = 0;
+  SimBaseEvent *timer = nullptr;
+  // Pushes the next read period of stimulus, and its timer
+  auto load_period = [&]() {
+    std::vector<int> offsets(kBurstSize);
+    for (int &offset : offsets) {
+      offset = hundredths(generator);
+    }
+    std::sort(offsets.begin(), offsets.end());
+    const SimTime::UserTime period_start = periods_loaded * kReadPeriod;
+    for (int offset : offsets) {
+      SimTime time(period_start + offset / 100.0L);
+      event_set->Push(new BurstTestEvent(time, order++, false));
+    }
+    SimTime last(period_start + offsets.back() / 100.0L);
+    timer = new BurstTestEvent(last, order++, false);
+    event_set->Push(timer);
+    pushed += kBurstSize + 1;
+    ++periods_loaded;
+  };
+
+  load_period();
+  bool in_order = true;
+  size_t popped = 0;
+  BurstTestEvent *previous = nullptr;
+  while (!event_set->Empty()) {
+    BurstTestEvent *event = static_cast<BurstTestEvent *>(event_set->PopMin());
+    ++popped;
+    if (previous != nullptr) {
+      in_order = in_order && FollowsInOrder(*previous, *event);
+      delete previous;
+    }
+    previous = event;
+    if (event == timer) {
+      timer = nullptr;
+      if (periods_loaded < kPeriodCount) {
+        load_period();
+      }
+    } else if (!event->follow_up()) {
+      SimTime later(event->event_time());
+      switch (follow_up(generator)) {
+        case 0:
+          later.AddTime(near_hundredths(generator) / 100.0L);
+          break;
+        case 1:
+          later.AddTime(far_periods(generator) * kReadPeriod);
+          break;
+        default:
+          // No follow-up for this one
+          continue;
+      }
+      event_set->Push(new BurstTestEvent(later, order++, true));
+      ++pushed;
+    }
+  }
+  delete previous;
+  Report(label + " bursty load order", in_order && (popped == pushed),
+         passed, failed);
+  delete event_set;
+}
+
+// Most of the events fall in a very narrow span of time, which should make
+// the ladder queue spawn extra rungs to break up the crowded buckets.
+//
+// "passed" / "failed" - counters to update
+void TestLadderRungs(int *passed, int *failed) {
+  const unsigned int kEventCount = 20000;
+  LadderQueue ladder;
+  std::mt19937 generator(2005);
+  std::uniform_int_distribution<int> narrow(0, 100);
+  std::uniform_int_distribution<int> wide(0, 10000000);
+  for (unsigned int i = 0; i < kEventCount; ++i) {
+    int hundredths = (i % 10 == 0) ? wide(generator) : narrow(generator);
+    ladder.Push(new OrderedTestEvent(SimTime(hundredths / 100.0L), i));
+  }
+  // Force the first transfer out of Top
+  ladder.PeekMin();
+  Report("LADDER spawns rungs for crowded buckets",
+         ladder.max_rung_count() > 1, passed, failed);
+  Report("LADDER skewed time / FIFO order",
+         DrainInOrder(&ladder, kEventCount), passed, failed);
+}
+
+// The radix heap is built for keys that never go backwards, but must still
+// order events correctly when one arrives earlier than the last one
+// removed.
+//
+// "passed" / "failed" - counters to update
+void TestRadixRebase(int *passed, int *failed) {
+  RadixHeap radix;
+  std::vector<OrderedTestEvent *> events;
+  MakeEvents(1000, &events);
+  for (OrderedTestEvent *event : events) {
+    radix.Push(event);
+  }
+  // Remove the earliest half, then push events before all of them
+  for (int i = 0; i < 500; ++i) {
+    delete radix.PopMin();
+  }
+  for (unsigned int i = 0; i < 100; ++i) {
+    radix.Push(new OrderedTestEvent(SimTime((i % 7) / 100.0L), 1000 + i));
+  }
+  Report("RADIX time / FIFO order after earlier push",
+         DrainInOrder(&radix, 600), passed, failed);
+}
+
+// Events beyond the horizon of the timing wheel go to the overflow set,
+// and must come back in order, ahead of any same time event pushed once
+// the wheel has caught up with them.
+//
+// "passed" / "failed" - counters to update
+void TestWheelOverflow(int *passed, int *failed) {
+  // Well past the 2^32 tick horizon
+  const SimTime::UserTime kFarTime = 5.0E7;
+  TimingWheel wheel(new EventHeap);
+  OrderedTestEvent *first = new OrderedTestEvent(SimTime(kFarTime), 0);
+  wheel.Push(first);
+  wheel.Push(new OrderedTestEvent(SimTime(kFarTime - 1.0E6), 1));
+  for (unsigned int i = 0; i < 1000; ++i) {
+    wheel.Push(new OrderedTestEvent(SimTime(i / 100.0L), 2 + i));
+  }
+  Report("WHEEL near events stay on the wheels",
+         wheel.overflow_count() == 2, passed, failed);
+  for (unsigned int i = 0; i < 1001; ++i) {
+    delete wheel.PopMin();
+  }
+  // The wheels have now caught up with the first far event
+  OrderedTestEvent *second = new OrderedTestEvent(SimTime(kFarTime), 1002);
+  wheel.Push(second);
+  SimBaseEvent *popped_first = wheel.PopMin();
+  SimBaseEvent *popped_second = wheel.PopMin();
+  Report("WHEEL FIFO across the overflow set",
+         (popped_first == first) && (popped_second == second) &&
+         wheel.Empty(), passed, failed);
+  delete popped_first;
+  delete popped_second;
+
+  // Times spread far beyond the horizon
+  std::mt19937 generator(1987);
+  std::uniform_int_distribution<int> thousands(0, 1000000);
+  for (unsigned int i = 0; i < 5000; ++i) {
+    SimTime::UserTime time = (thousands(generator) / 10) * 1000.0L;
+    wheel.Push(new OrderedTestEvent(SimTime(kFarTime + time), i));
+  }
+  Report("WHEEL widely spread time / FIFO order",
+         DrainInOrder(&wheel, 5000), passed, failed);
+}
+
+// The calendar queue must grow as events are pushed, re-estimate its day
+// width from the event spacing, and shrink again as it drains.
+//
+// "passed" / "failed" - counters to update
+void TestCalendarResize(int *passed, int *failed) {
+  const unsigned int kEventCount = 4096;
+  CalendarQueue calendar;
+  std::mt19937 generator(1988);
+  std::uniform_int_distribution<int> hundredths(0, 10000000);
+  for (unsigned int i = 0; i < kEventCount; ++i) {
+    SimTime::UserTime time = hundredths(generator) / 100.0L;
+    calendar.Push(new OrderedTestEvent(SimTime(time), i));
+  }
+  Report("CALENDAR grows with size",
+         calendar.bucket_count() >= kEventCount / 2, passed, failed);
+  Report("CALENDAR width estimated", calendar.bucket_width() > 1,
+         passed, failed);
+  Report("CALENDAR sparse time / FIFO order",
+         DrainInOrder(&calendar, kEventCount), passed, failed);
+  Report("CALENDAR shrinks when drained", calendar.bucket_count() <= 4,
+         passed, failed);
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  // Heaps with a few different arities
+  TestOrdering("HEAP(2)", new EventHeap(2), &passed, &failed);
+  TestOrdering("HEAP(7)", new EventHeap(7), &passed, &failed);
+
+  // Calendar geometry follows the queue contents
+  TestCalendarResize(&passed, &failed);
+  // Crowded buckets break into new rungs
+  TestLadderRungs(&passed, &failed);
+  // Out of order pushes are still ordered
+  TestRadixRebase(&passed, &failed);
+  // Far events overflow, and return in order
+  TestWheelOverflow(&passed, &failed);
+
+  // Every implementation known to the factory
+  const char *const kEventSetNames[] = {"HEAP", "LIST", "CALENDAR", "LADDER",
+                                        "RADIX", "WHEEL", "WHEEL+LADDER"};
+  for (const char *name : kEventSetNames) {
+    TestOrdering(name, PendingEventSet::NewEventSet(name), &passed, &failed);
+    TestInterleaved(name, PendingEventSet::NewEventSet(name),
+                    &passed, &failed);
+    TestBurstyLoad(name, PendingEventSet::NewEventSet(name),
+                   &passed, &failed);
+    TestRemove(name, PendingEventSet::NewEventSet(name), &passed, &failed);
+    TestCancelHeavy(name, PendingEventSet::NewEventSet(name),
+                    &passed, &failed);
+    TestPushBatch(name, PendingEventSet::NewEventSet(name), &passed, &failed);
+    TestClear(name, PendingEventSet::NewEventSet(name), &passed, &failed);
+  }
+  Report("Unknown name rejected",
+         (PendingEventSet::NewEventSet("NOSUCHSET") == nullptr) &&
+         (PendingEventSet::NewEventSet("WHEEL+NOSUCHSET") == nullptr),
+         &passed, &failed);
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC EVENT SET TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+
+  return failed;
+}  // main
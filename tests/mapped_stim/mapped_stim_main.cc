@@ -0,0 +1,241 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for the memory mapped stimulus
+*     loader.  In brief, this provides a main() that first checks the CSV
+*     tokenizer on records held in memory: times, quoted payloads, header
+*     lines, and malformed records.  It then runs the text event example
+*     from the same stimulus files with StimTextEventLoader and with
+*     MappedStimTextEventLoader, with and without prefetch, and every run
+*     must write the same log.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_exec.hpp"
+#include "sim_text_event.hpp"
+#include "stim_text_event_loader.hpp"
+#include "mapped_stim_text_event_loader.hpp"
+#include "log_text_event.hpp"
+#include "shared_test_code.hpp"
+
+// The text event example's stimulus, with its header and quoted payloads
+const std::string kExampleStimulusPath("./test_ref/stim.csv");
+// Written by the test, to cover several read windows
+const std::string kLargeStimulusPath("./test_out/large_stim.csv");
+const int kLargeRecordCount = 5000;
+const SimTime::UserTime kRunUntil = 1.0E5;
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n**********************************************"
+               "\n***  Welcome to the Mapped Stimulus Test!  ***"
+               "\n**********************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Returns - the whole contents of the file at "path", or an empty string
+//       if it can't be read
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Reads the first record of "text" with the tokenizer.
+//
+// "text" - the records
+// "time" / "payload" - receive the record's fields
+// Returns - "true" if the record was read
+bool TokenizeFirst(const std::string &text, SimTime::UserTime *time,
+                   std::string *payload) {
+  StimCsvTokenizer tokenizer(text.data(), text.data() + text.size());
+  const char *field;
+  size_t field_size;
+  if (!tokenizer.NextRecord(time, &field, &field_size)) {
+    return false;
+  }
+  payload->assign(field, field_size);
+  return true;
+}
+
+// Returns - "true" if the tokenizer parses "number" to exactly the same
+//       value as the stream extraction does
+bool ParsesLikeStream(const std::string &number) {
+  SimTime::UserTime streamed = 0.0;
+  std::istringstream stream(number);
+  stream >> streamed;
+  SimTime::UserTime parsed = 0.0;
+  const char *cursor = number.data();
+  return StimCsvTokenizer::ParseUserTime(&cursor, number.data() +
+                                         number.size(), &parsed) &&
+         (cursor == number.data() + number.size()) && (parsed == streamed);
+}
+
+// Writes a stimulus file spanning several read windows, with a mix of
+// line endings and number formats.
+void WriteLargeStimulus() {
+  std::ofstream stim_file(kLargeStimulusPath);
+  stim_file << "\"TIME\",\"TEXT\"\n";
+  for (int record = 0; record < kLargeRecordCount; ++record) {
+    const SimTime::UserTime time = record * 0.73L;
+    stim_file << std::setprecision(3 + record % 5) << time << ",\"Rec"
+              << record << "\"" << (((record % 7) == 0) ? "\r\n" : "\n");
+  }
+}
+
+// Runs the text event example from a loader, on a new executive.
+//
+// "loader" - the loader to run from.  The executive takes it over.
+// "log_path" - pathname of the log file to write
+void RunTextEventSim(StimLoader *loader, const std::string &log_path) {
+  SimExec *exec = new SimExec;
+  LogTextEvent *log_mgr = new LogTextEvent(log_path);
+  log_mgr->WriteHeaderOrDie();
+  exec->Init(SimTime(kRunUntil), nullptr, log_mgr, loader);
+  exec->RunTyped<SimTextEvent>();
+  exec->TearDown();
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  // The tokenizer, on records in memory
+  SimTime::UserTime time = 0.0;
+  std::string payload;
+  Report("Plain record",
+         TokenizeFirst("1.0,\"Time1.0\"\n", &time, &payload) &&
+         (time == 1.0) && (payload == "\"Time1.0\""), &passed, &failed);
+  Report("Quoted payload holding separators and spaces",
+         TokenizeFirst(" 2.5 , \"a, b c\"\n", &time, &payload) &&
+         (time == 2.5) && (payload == "\"a, b c\""), &passed, &failed);
+  Report("Quoted payload holding doubled quotes",
+         TokenizeFirst("3,\"say \"\"hi\"\"\"\r\n", &time, &payload) &&
+         (time == 3.0) && (payload == "\"say \"\"hi\"\"\""),
+         &passed, &failed);
+  Report("Unquoted payload, without a final line break",
+         TokenizeFirst("4.25e1,Plain", &time, &payload) &&
+         (time == 42.5) && (payload == "Plain"), &passed, &failed);
+  Report("Header line is not a record",
+         !TokenizeFirst("\"TIME\",\"TEXT\"\n1.0,\"x\"\n", &time, &payload),
+         &passed, &failed);
+  Report("Unterminated quote is not a record",
+         !TokenizeFirst("5.0,\"open\n", &time, &payload), &passed, &failed);
+  Report("Missing separator is not a record",
+         !TokenizeFirst("5.0 \"x\"\n", &time, &payload), &passed, &failed);
+
+  const std::string header_text("\"TIME\",\"TEXT\"\n1.5,\"x\"\n\n2.5,y\n");
+  StimCsvTokenizer tokenizer(header_text.data(),
+                             header_text.data() + header_text.size());
+  const char *field;
+  size_t field_size;
+  const bool header_failed =
+      !tokenizer.NextRecord(&time, &field, &field_size) &&
+      tokenizer.failed() && (tokenizer.position() == 0);
+  tokenizer.SkipLine();
+  const bool first = tokenizer.NextRecord(&time, &field, &field_size) &&
+                     (time == 1.5);
+  const bool second = tokenizer.NextRecord(&time, &field, &field_size) &&
+                      (time == 2.5) && (field_size == 1) && (*field == 'y');
+  Report("Header skipped, then every record read, across a blank line",
+         header_failed && first && second && tokenizer.AtEnd() &&
+         !tokenizer.NextRecord(&time, &field, &field_size) &&
+         !tokenizer.failed(), &passed, &failed);
+
+  const char *numbers[] = {"0", "7", "-3.25", "0.1", "1.2", "27.3",
+                           "1006.1", "2727.27", "2724.25", "3000.00",
+                           "1e3", "2.5E-2", "+12.5", "0.000001",
+                           "123456789.123456789", "98765432109876543210.5"};
+  bool all_match = true;
+  for (const char *number : numbers) {
+    if (!ParsesLikeStream(number)) {
+      std::cout << "  Parsed differently:  " << number << "\n";
+      all_match = false;
+    }
+  }
+  Report("Times parse as the stream extraction parses them", all_match,
+         &passed, &failed);
+
+  // Whole runs, against the stream loader
+  WriteLargeStimulus();
+  const std::string stimuli[] = {kExampleStimulusPath, kLargeStimulusPath};
+  const std::string names[] = {"Example", "Large"};
+  for (int stimulus = 0; stimulus < 2; ++stimulus) {
+    const std::string prefix("./test_out/" + names[stimulus]);
+    RunTextEventSim(new StimTextEventLoader(stimuli[stimulus]),
+                    prefix + "_stream.csv");
+    RunTextEventSim(new MappedStimTextEventLoader(stimuli[stimulus]),
+                    prefix + "_mapped.csv");
+    MappedStimTextEventLoader *prefetching =
+        new MappedStimTextEventLoader(stimuli[stimulus]);
+    prefetching->set_prefetch(true);
+    RunTextEventSim(prefetching, prefix + "_prefetch.csv");
+    const std::string reference = ReadFile(prefix + "_stream.csv");
+    Report(names[stimulus] + " stimulus logged",
+           reference.size() > 100, &passed, &failed);
+    Report(names[stimulus] + " stimulus, mapped, matches the stream loader",
+           ReadFile(prefix + "_mapped.csv") == reference, &passed, &failed);
+    Report(names[stimulus] + " stimulus, mapped and prefetched, matches",
+           ReadFile(prefix + "_prefetch.csv") == reference,
+           &passed, &failed);
+  }
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC MAPPED STIMULUS TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
@@ -0,0 +1,273 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for dispatching same-time events
+*     in parallel, by conflict key.  In brief, this provides a main() that
+*     runs a small model of accounts, whose events each declare their
+*     account as their conflict key, with 1, 2 and 4 dispatch threads.
+*     Every run must reach the same balances, and each account must see
+*     its events in the same order, as the single threaded run.  Audit
+*     events, which read every account, declare no key, and must always
+*     find the accounts consistent.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "sim_exec.hpp"
+#include "stim_text_event_loader.hpp"
+#include "log_text_event.hpp"
+#include "shared_test_code.hpp"
+
+// Size of the model
+const int kAccountCount = 16;
+const int kTimeCount = 200;
+// Transfers each initial event passes along, at the same time
+const int kTransferSteps = 3;
+// Busy work per event, so that there is something to run in parallel
+const int kEventWork = 2000;
+const SimTime::UserTime kRunUntil = 1.0E4;
+
+// One entry in an account's history: which event it saw
+struct HistoryEntry {
+  SimTime::SimTick time;
+  int step;
+  bool operator==(const HistoryEntry &other) const {
+    return (time == other.time) && (step == other.step);
+  }
+};
+
+// The model state.  Each account is only touched by events with its key,
+// so none of it needs locking.
+struct Accounts {
+  int64_t balance[kAccountCount];
+  std::vector<HistoryEntry> history[kAccountCount];
+  // Audits that found money missing
+  int bad_audits;
+  int audits;
+};
+
+static Accounts accounts;
+// Events that ran while their executive wasn't current on their thread
+static std::atomic<int> wrong_exec(0);
+// Keeps the busy work from being optimized away
+static thread_local uint64_t work_sink = 0;
+
+// Moves one unit from its account to the next, and has the next account
+// do the same, at the same time, "kTransferSteps" times.
+class TransferEvent final : public SimBaseEvent {
+ public:
+  TransferEvent(const SimTime &event_time, int account, int step)
+      : SimBaseEvent(event_time), account_(account), step_(step) {};
+  virtual ~TransferEvent() {};
+
+  virtual uint64_t conflict_key() const {
+    return static_cast<uint64_t>(account_);
+  }
+
+  virtual void Dispatch() const {
+    SimExec *exec = SimExec::current();
+    if ((exec == nullptr) || !event_time().SameAs(exec->curr_time())) {
+      wrong_exec++;
+      return;
+    }
+    for (int work = 0; work < kEventWork; ++work) {
+      work_sink = work_sink * 31 + work;
+    }
+    HistoryEntry entry = {event_time().ticks(), step_};
+    accounts.history[account_].push_back(entry);
+    if (step_ > 0) {
+      // A deposit from the previous account
+      accounts.balance[account_]++;
+    }
+    if (step_ < kTransferSteps) {
+      // The withdrawal, and the deposit, are each done by an event of the
+      // account they change
+      accounts.balance[account_]--;
+      exec->ScheduleEvent(new TransferEvent(event_time(),
+                                            (account_ + 1) % kAccountCount,
+                                            step_ + 1));
+    }
+  }
+
+ private:
+  int account_;
+  // Zero for the initial event, then the number of deposits so far
+  int step_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransferEvent);
+};
+
+// Checks that no money was lost or made, once the transfers at a time are
+// done.  Declares no key, so it runs with no transfer running.
+class AuditEvent final : public SimBaseEvent {
+ public:
+  explicit AuditEvent(const SimTime &event_time)
+      : SimBaseEvent(event_time) {};
+  virtual ~AuditEvent() {};
+
+  virtual void Dispatch() const {
+    int64_t total = 0;
+    for (int account = 0; account < kAccountCount; ++account) {
+      total += accounts.balance[account];
+    }
+    accounts.audits++;
+    if (total != 0) {
+      accounts.bad_audits++;
+    }
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AuditEvent);
+};
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n************************************************"
+               "\n***  Welcome to the Parallel Dispatch Test!  ***"
+               "\n************************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Runs the model on a new executive.
+//
+// "threads" - dispatch threads
+// "parallel_dispatches" - receives the number of events dispatched in
+//       parallel groups
+// Returns - wall clock time of the run, in milliseconds
+double RunAccounts(unsigned threads, uint64_t *parallel_dispatches) {
+  for (int account = 0; account < kAccountCount; ++account) {
+    accounts.balance[account] = 0;
+    accounts.history[account].clear();
+  }
+  accounts.bad_audits = 0;
+  accounts.audits = 0;
+
+  SimExec *exec = new SimExec;
+  exec->Init(SimTime(kRunUntil), nullptr,
+             new LogTextEvent("./test_out/log_" + std::to_string(threads) +
+                              ".csv"),
+             new StimTextEventLoader("./test_ref/stim.csv"));
+  exec->set_dispatch_threads(threads);
+  for (int time = 0; time < kTimeCount; ++time) {
+    for (int account = 0; account < kAccountCount; ++account) {
+      exec->ScheduleEvent(new TransferEvent(SimTime(10.0 + time), account,
+                                            0));
+    }
+    exec->ScheduleEvent(new AuditEvent(SimTime(10.5 + time)));
+  }
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  exec->Run();
+  const double wall_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+  *parallel_dispatches = exec->parallel_dispatch_count();
+  exec->TearDown();
+  return wall_ms;
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  // The single threaded reference
+  uint64_t parallel_dispatches = 0;
+  const double reference_ms = RunAccounts(1, &parallel_dispatches);
+  Accounts reference = accounts;
+  Report("Single thread dispatches nothing in parallel",
+         parallel_dispatches == 0, &passed, &failed);
+  Report("Single thread audits all pass",
+         (reference.audits == kTimeCount) && (reference.bad_audits == 0),
+         &passed, &failed);
+  // Every initial event is followed by "kTransferSteps" deposits
+  Report("Single thread dispatches every transfer",
+         reference.history[0].size() ==
+             static_cast<size_t>(kTimeCount * (kTransferSteps + 1)),
+         &passed, &failed);
+
+  const unsigned thread_counts[] = {2, 4};
+  for (unsigned threads : thread_counts) {
+    const std::string label(std::to_string(threads) + " threads");
+    const double wall_ms = RunAccounts(threads, &parallel_dispatches);
+    bool same_history = true;
+    bool same_balance = true;
+    for (int account = 0; account < kAccountCount; ++account) {
+      same_history = same_history &&
+          (accounts.history[account] == reference.history[account]);
+      same_balance = same_balance &&
+          (accounts.balance[account] == reference.balance[account]);
+    }
+    Report(label + " dispatch in parallel", parallel_dispatches > 0,
+           &passed, &failed);
+    Report(label + " keep each account's order", same_history,
+           &passed, &failed);
+    Report(label + " reach the same balances", same_balance,
+           &passed, &failed);
+    Report(label + " audits all pass",
+           (accounts.audits == kTimeCount) && (accounts.bad_audits == 0),
+           &passed, &failed);
+    std::cout << "  (" << std::fixed << std::setprecision(1) << wall_ms
+              << " ms, against " << reference_ms << " ms on one thread)\n";
+  }
+  Report("Every event saw its executive as current", wrong_exec == 0,
+         &passed, &failed);
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC PARALLEL DISPATCH TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
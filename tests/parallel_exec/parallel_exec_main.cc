@@ -0,0 +1,526 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for the parallel executives.  In
+*     brief, this provides a main() that runs a synthetic many-entity model
+*     (PHOLD: tokens hop from entity to entity, each hop a random delay
+*     later) partitioned into different numbers of logical processes, and
+*     checks that every partitioning reaches the same results as a single
+*     LP, with every LP dispatching its events in time order, both with
+*     null messages and in barrier synchronized windows.  The same model,
+*     with its state kept per LP, is then run optimistically, where the
+*     results must match too, and output must only be committed for events
+*     that aren't rolled back.  Finally, with some work added to every
+*     event, the speedup of each executive over one LP is reported; it is
+*     not checked, since it depends on the machine.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "logical_process.hpp"
+#include "conservative_exec.hpp"
+#include "window_exec.hpp"
+#include "time_warp_process.hpp"
+#include "time_warp_exec.hpp"
+#include "shared_test_code.hpp"
+
+// Model parameters
+const uint32_t kEntityCount = 64;
+const uint32_t kTokenCount = 256;
+const SimTime::UserTime kLookahead = 1.0;
+const SimTime::UserTime kRunUntil = 500.0;
+// Random numbers drawn per event, as busy work, for the speedup benchmark
+const uint32_t kBenchmarkWork = 2000;
+
+// State of one entity.  Both fields are sums, so they don't depend on the
+// order of tokens that arrive at the same time.
+struct EntityState {
+  uint64_t visits;
+  uint64_t checksum;
+};
+
+// Results of one run
+struct ModelResults {
+  std::vector<EntityState> entities;
+  uint64_t dispatched;
+  uint64_t out_of_order;
+  uint64_t null_messages;
+  // Time Warp only: events rolled back, and committed outputs that were
+  // missing, extra, or out of time order
+  uint64_t rolled_back;
+  uint64_t bad_outputs;
+  SimTime end_time;
+  double elapsed_ms;
+};
+
+// The model's state.  Each entity, and each LP's slot, is only touched by
+// the thread of the LP that owns it.
+static std::vector<EntityState> entities;
+static std::vector<SimTime::SimTick> last_dispatch;
+static std::vector<uint64_t> out_of_order;
+static uint32_t partitions = 1;
+// Busy work per event, and somewhere to put its result so that it isn't
+// optimized away
+static uint32_t work_per_event = 0;
+static thread_local uint64_t work_sink = 0;
+
+// Advances a splitmix64 generator.
+//
+// "state" - the generator's state
+// Returns - the next pseudo-random number
+uint64_t NextRandom(uint64_t *state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// A token arriving at an entity.  The token carries its own random state,
+// so its path doesn't depend on what else is happening.
+class TokenEvent : public SimBaseEvent {
+ public:
+  // "event_time" - time at which the token arrives
+  // "entity" - the entity it arrives at
+  // "seed" - the token's random state
+  // "hops" - number of hops so far
+  TokenEvent(const SimTime &event_time, uint32_t entity, uint64_t seed,
+             uint32_t hops)
+      : SimBaseEvent(event_time), entity_(entity), seed_(seed),
+        hops_(hops) {};
+  virtual ~TokenEvent() {};
+
+  // Records the visit, then sends the token on to a random entity
+  virtual void Dispatch() const {
+    LogicalProcess *lp = LogicalProcess::current();
+    const uint32_t id = lp->id();
+    if (event_time_.ticks() < last_dispatch[id]) {
+      ++out_of_order[id];
+    }
+    last_dispatch[id] = event_time_.ticks();
+    EntityState &state = entities[entity_];
+    ++state.visits;
+    state.checksum += seed_ ^ (event_time_.ticks() * (hops_ + 1));
+    uint64_t work = seed_;
+    for (uint32_t count = 0; count < work_per_event; ++count) {
+      work_sink += NextRandom(&work);
+    }
+
+    uint64_t seed = seed_;
+    const uint64_t random = NextRandom(&seed);
+    const uint32_t next_entity = static_cast<uint32_t>(random % kEntityCount);
+    SimTime next_time(event_time_);
+    next_time.AddTime(kLookahead + ((random >> 40) % 400) / 100.0L);
+    lp->SendEvent(next_entity % partitions,
+                  new TokenEvent(next_time, next_entity, seed, hops_ + 1));
+  }
+
+ private:
+  uint32_t entity_;
+  uint64_t seed_;
+  uint32_t hops_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(TokenEvent);
+};  // class TokenEvent
+
+// The Time Warp version of the model keeps the entities in the state of
+// each LP, so that they can be rolled back.  Only the entities the LP owns
+// are ever touched.
+class PholdState : public LpState {
+ public:
+  PholdState() : entities(kEntityCount, EntityState()) {};
+  virtual ~PholdState() {};
+
+  virtual LpState *Clone() const {
+    PholdState *copy = new PholdState();
+    copy->entities = entities;
+    return copy;
+  }
+  virtual void Restore(const LpState &saved) {
+    entities = static_cast<const PholdState &>(saved).entities;
+  }
+
+  std::vector<EntityState> entities;
+
+ private:
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(PholdState);
+};  // class PholdState
+
+// Times of the committed outputs, per LP.  Only appended to by the LP's
+// own thread, when it commits.
+static std::vector<std::vector<SimTime::SimTick> > committed_outputs;
+
+// The same token as TokenEvent, for TimeWarpExec.  Each visit also hands
+// an output to the LP, which stands in for a log record.
+class WarpTokenEvent : public TimeWarpEvent {
+ public:
+  // "event_time" - time at which the token arrives
+  // "entity" - the entity it arrives at
+  // "seed" - the token's random state
+  // "hops" - number of hops so far
+  WarpTokenEvent(const SimTime &event_time, uint32_t entity, uint64_t seed,
+                 uint32_t hops)
+      : TimeWarpEvent(event_time), entity_(entity), seed_(seed),
+        hops_(hops) {};
+  virtual ~WarpTokenEvent() {};
+
+  // Records the visit, then sends the token on to a random entity
+  virtual void Dispatch() const {
+    TimeWarpProcess *lp = TimeWarpProcess::current();
+    PholdState *state = static_cast<PholdState *>(lp->state());
+    EntityState &entity = state->entities[entity_];
+    ++entity.visits;
+    entity.checksum += seed_ ^ (event_time_.ticks() * (hops_ + 1));
+    const uint32_t id = lp->id();
+    const SimTime::SimTick ticks = event_time_.ticks();
+    lp->CommitOutput([id, ticks] {
+      committed_outputs[id].push_back(ticks);
+    });
+
+    uint64_t seed = seed_;
+    const uint64_t random = NextRandom(&seed);
+    const uint32_t next_entity = static_cast<uint32_t>(random % kEntityCount);
+    SimTime next_time(event_time_);
+    next_time.AddTime(kLookahead + ((random >> 40) % 400) / 100.0L);
+    lp->SendEvent(next_entity % partitions,
+                  new WarpTokenEvent(next_time, next_entity, seed, hops_ + 1));
+  }
+
+ private:
+  uint32_t entity_;
+  uint64_t seed_;
+  uint32_t hops_;
+
+  // As per the coding standard
+  DISALLOW_COPY_AND_ASSIGN(WarpTokenEvent);
+};  // class WarpTokenEvent
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n***********************************************"
+               "\n***  Welcome to the Parallel Executive Test!  ***"
+               "\n***********************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Resets the model for a run with "lp_count" LPs.
+//
+// "lp_count" - number of LPs the entities are spread over
+void ResetModel(uint32_t lp_count) {
+  partitions = lp_count;
+  EntityState initial = {0, 0};
+  entities.assign(kEntityCount, initial);
+  last_dispatch.assign(lp_count, 0);
+  out_of_order.assign(lp_count, 0);
+}
+
+// Returns - the results of the run just finished
+ModelResults CollectResults() {
+  ModelResults results;
+  results.entities = entities;
+  results.dispatched = 0;
+  results.out_of_order = 0;
+  for (uint32_t id = 0; id < partitions; ++id) {
+    results.out_of_order += out_of_order[id];
+  }
+  for (const EntityState &state : entities) {
+    results.dispatched += state.visits;
+  }
+  results.null_messages = 0;
+  results.rolled_back = 0;
+  results.bad_outputs = 0;
+  results.elapsed_ms = 0.0;
+  return results;
+}
+
+// Schedules the initial tokens, each on the LP owning its entity.
+//
+// "exec" - ConservativeExec or WindowExec, with "partitions" LPs
+template <typename Exec>
+void ScheduleTokens(Exec *exec) {
+  for (uint32_t token = 0; token < kTokenCount; ++token) {
+    const uint32_t entity = token % kEntityCount;
+    exec->lp(entity % partitions)->ScheduleEvent(
+        new TokenEvent(SimTime((token % 100) / 100.0L), entity,
+                       0x5EED0000ULL + token, 0));
+  }
+}
+
+// Runs the model with ConservativeExec.  Entity "e" belongs to LP
+// "e % lp_count", and every LP has a link to every other.
+//
+// "lp_count" - number of LPs
+// "event_set_name" - pending event set for each LP
+// Returns - the results of the run
+ModelResults RunConservative(uint32_t lp_count,
+                             const std::string &event_set_name) {
+  ResetModel(lp_count);
+  ConservativeExec exec(lp_count, event_set_name);
+  for (uint32_t from = 0; from < lp_count; ++from) {
+    for (uint32_t to = 0; to < lp_count; ++to) {
+      if (from != to) {
+        exec.AddLink(from, to, kLookahead);
+      }
+    }
+  }
+  ScheduleTokens(&exec);
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const SimTime end_time = exec.Run(SimTime(kRunUntil));
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  ModelResults results = CollectResults();
+  results.null_messages = exec.null_message_count();
+  results.end_time = end_time;
+  results.elapsed_ms = elapsed.count();
+  return results;
+}
+
+// Runs the model with WindowExec, partitioned as for RunConservative().
+//
+// "lp_count" - number of LPs
+// "event_set_name" - pending event set for each LP
+// Returns - the results of the run
+ModelResults RunWindowed(uint32_t lp_count,
+                         const std::string &event_set_name) {
+  ResetModel(lp_count);
+  WindowExec exec(lp_count, kLookahead, event_set_name);
+  ScheduleTokens(&exec);
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const SimTime end_time = exec.Run(SimTime(kRunUntil));
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  ModelResults results = CollectResults();
+  results.end_time = end_time;
+  results.elapsed_ms = elapsed.count();
+  return results;
+}
+
+// Compares a run with the single LP reference.
+//
+// "label" - text describing the run
+// "results" - results of the run
+// "reference" - results of the single LP run
+// "passed" / "failed" - counters to update
+void CheckResults(const std::string &label, const ModelResults &results,
+                  const ModelResults &reference, int *passed, int *failed) {
+  bool same = (results.dispatched == reference.dispatched);
+  for (uint32_t entity = 0; entity < kEntityCount; ++entity) {
+    same = same && (results.entities[entity].visits ==
+                    reference.entities[entity].visits) &&
+           (results.entities[entity].checksum ==
+            reference.entities[entity].checksum);
+  }
+  std::cout << label << ": " << results.dispatched << " events, "
+            << results.null_messages << " null messages, "
+            << results.elapsed_ms << " ms\n";
+  Report(label + " matches one LP", same, passed, failed);
+  Report(label + " dispatches in time order", results.out_of_order == 0,
+         passed, failed);
+  Report(label + " end time", results.end_time.SameAs(SimTime(kRunUntil)),
+         passed, failed);
+}
+
+// Runs the model with TimeWarpExec, partitioned as for RunConservative().
+// Since rolled back events are dispatched again, "out_of_order" isn't
+// counted.
+//
+// "lp_count" - number of LPs
+// Returns - the results of the run
+ModelResults RunTimeWarp(uint32_t lp_count) {
+  ResetModel(lp_count);
+  TimeWarpExec exec(lp_count);
+  committed_outputs.assign(lp_count, std::vector<SimTime::SimTick>());
+  for (uint32_t id = 0; id < lp_count; ++id) {
+    exec.lp(id)->set_state(new PholdState());
+  }
+  for (uint32_t token = 0; token < kTokenCount; ++token) {
+    const uint32_t entity = token % kEntityCount;
+    TimeWarpProcess *lp = exec.lp(entity % lp_count);
+    lp->SendEvent(lp->id(),
+                  new WarpTokenEvent(SimTime((token % 100) / 100.0L), entity,
+                                     0x5EED0000ULL + token, 0));
+  }
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  const SimTime end_time = exec.Run(SimTime(kRunUntil));
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  ModelResults results = CollectResults();
+  uint64_t committed = 0;
+  for (uint32_t id = 0; id < lp_count; ++id) {
+    TimeWarpProcess *lp = exec.lp(id);
+    const PholdState *state = static_cast<const PholdState *>(lp->state());
+    for (uint32_t entity = id; entity < kEntityCount; entity += lp_count) {
+      results.entities[entity] = state->entities[entity];
+      results.dispatched += state->entities[entity].visits;
+    }
+    const std::vector<SimTime::SimTick> &outputs = committed_outputs[id];
+    for (size_t index = 1; index < outputs.size(); ++index) {
+      if (outputs[index] < outputs[index - 1]) {
+        ++results.bad_outputs;
+      }
+    }
+    committed += lp->committed_count();
+    results.rolled_back += lp->rolled_back_count();
+  }
+  // Every committed event must have exactly one committed output
+  uint64_t output_count = 0;
+  for (const std::vector<SimTime::SimTick> &outputs : committed_outputs) {
+    output_count += outputs.size();
+  }
+  if ((output_count != committed) || (committed != results.dispatched)) {
+    ++results.bad_outputs;
+  }
+  std::cout << "Time Warp, " << lp_count << " LPs: " << exec.gvt_round_count()
+            << " GVT rounds, " << results.rolled_back << " rolled back\n";
+  results.end_time = end_time;
+  results.elapsed_ms = elapsed.count();
+  return results;
+}
+
+// Checks that events breaking the lookahead, or sent without a link, are
+// rejected.
+//
+// "passed" / "failed" - counters to update
+void TestRejections(int *passed, int *failed) {
+  ResetModel(3);
+  ConservativeExec exec(3);
+  exec.AddLink(0, 1, kLookahead);
+  LogicalProcess *lp = exec.lp(0);
+  Report("Send within the lookahead rejected",
+         !lp->SendEvent(1, new TokenEvent(SimTime(kLookahead / 2), 1, 0, 0)),
+         passed, failed);
+  Report("Send without a link rejected",
+         !lp->SendEvent(2, new TokenEvent(SimTime(kLookahead * 2), 2, 0, 0)),
+         passed, failed);
+  Report("Send over a link accepted",
+         lp->SendEvent(1, new TokenEvent(SimTime(kLookahead), 1, 0, 0)),
+         passed, failed);
+}
+
+// Reports the speedup of the conservative and window executives over one
+// LP, with busy work added to every event so that there is something to
+// run in parallel.
+void BenchmarkSpeedup() {
+  std::cout << "\nSpeedup benchmark: " << kEntityCount << " entities, "
+            << kBenchmarkWork << " random numbers per event, "
+            << std::thread::hardware_concurrency() << " hardware threads\n";
+  work_per_event = kBenchmarkWork;
+  const uint32_t kLpCounts[] = {1, 2, 4, 8};
+  double conservative_base = 0.0;
+  double window_base = 0.0;
+  for (uint32_t lp_count : kLpCounts) {
+    const double conservative_ms =
+        RunConservative(lp_count, "HEAP").elapsed_ms;
+    const double window_ms = RunWindowed(lp_count, "HEAP").elapsed_ms;
+    if (lp_count == 1) {
+      conservative_base = conservative_ms;
+      window_base = window_ms;
+    }
+    std::cout << std::setw(2) << lp_count << " LPs:  conservative "
+              << std::setw(9) << conservative_ms << " ms ("
+              << conservative_base / conservative_ms << "x),  windowed "
+              << std::setw(9) << window_ms << " ms ("
+              << window_base / window_ms << "x)\n";
+  }
+  work_per_event = 0;
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+  std::cout << std::fixed << std::setprecision(2);
+
+  TestRejections(&passed, &failed);
+
+  const ModelResults reference = RunConservative(1, "HEAP");
+  CheckResults("Conservative, 1 LP", reference, reference, &passed, &failed);
+  const uint32_t kLpCounts[] = {2, 4, 8};
+  for (uint32_t lp_count : kLpCounts) {
+    CheckResults("Conservative, " + std::to_string(lp_count) + " LPs",
+                 RunConservative(lp_count, "HEAP"), reference,
+                 &passed, &failed);
+  }
+  CheckResults("Conservative, 4 LPs, LADDER", RunConservative(4, "LADDER"),
+               reference, &passed, &failed);
+  for (uint32_t lp_count : kLpCounts) {
+    CheckResults("Windowed, " + std::to_string(lp_count) + " LPs",
+                 RunWindowed(lp_count, "HEAP"), reference,
+                 &passed, &failed);
+  }
+  CheckResults("Windowed, 4 LPs, CALENDAR", RunWindowed(4, "CALENDAR"),
+               reference, &passed, &failed);
+  const uint32_t kWarpLpCounts[] = {1, 2, 4, 8};
+  for (uint32_t lp_count : kWarpLpCounts) {
+    const std::string label("Time Warp, " + std::to_string(lp_count) +
+                            " LPs");
+    const ModelResults results = RunTimeWarp(lp_count);
+    CheckResults(label, results, reference, &passed, &failed);
+    Report(label + " commits output once per event, in time order",
+           results.bad_outputs == 0, &passed, &failed);
+  }
+  BenchmarkSpeedup();
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC PARALLEL EXECUTIVE TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
@@ -0,0 +1,288 @@
+/*****************************************************************************
+*
+*   DESCRIPTION:
+*     File containing the test scaffolding for the multiple process
+*     executive.  In brief, this provides a main() that launches a token
+*     passing model over 1, 2 and 4 worker processes.  Each token hops
+*     from LP to LP, with a delay of at least the lookahead, through the
+*     shared memory channels.  Each worker checks that its LP dispatched
+*     exactly the events that a sequential walk of the tokens gives it, in
+*     time order, and reports the result as its exit status.
+*
+*     There are many more tokens than a channel has slots, so a sender
+*     running ahead of its receiver fills the channel, and has to wait.
+*     Finally, one worker of a run fails before its LP starts, and the
+*     launcher must stop the others, which would wait for it forever.
+*
+*   STATUS:  Prototype
+*   VERSION:  1.00
+*   CODER:  Dean Stevens
+*
+*   LICENSE:  The MIT License (MIT)
+*             See LICENSE.txt in the root (sim) directory of this project.
+*   Copyright (c) 2014 Spinnaker Advisory Group, Inc.
+*
+*****************************************************************************/
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include "common_strings.hpp"
+#include "sim_time.hpp"
+#include "sim_base_event.hpp"
+#include "shm_exec.hpp"
+#include "shm_launcher.hpp"
+#include "shared_test_code.hpp"
+
+const char kSegmentName[] = "/desim_shm_exec_test";
+// Size of the model
+const int kTokenCount = 2048;
+const int kHopCount = 20;
+const SimTime::UserTime kLookahead = 1.0;
+// Ends the run part way through the tokens' hops, so that some sends are
+// dropped for being after the end
+const SimTime::UserTime kRunUntil = 25.0;
+
+// What a worker's LP saw: the count of its events, and an order
+// independent checksum of them
+struct LpTally {
+  uint64_t dispatched;
+  uint64_t checksum;
+};
+
+// The tally of the worker's own LP, and whether its events ever went
+// back in time
+static LpTally tally = {0, 0};
+static SimTime::SimTick last_ticks = 0;
+static bool out_of_order = false;
+
+// The model's routing and timing, shared by the events and the sequential
+// walk.
+//
+// Returns - the LP that a token starts on
+uint32_t FirstLp(int token, uint32_t lp_count) {
+  return static_cast<uint32_t>(token) % lp_count;
+}
+// Returns - the LP that a token hops to next
+uint32_t NextLp(uint32_t lp, int token, int hop, uint32_t lp_count) {
+  return (lp + 1 + static_cast<uint32_t>((token + hop) % 3)) % lp_count;
+}
+// Returns - the time at which a token starts, in ticks
+SimTime::SimTick StartTicks(int token) {
+  return SimTime(1.0).ticks() + static_cast<SimTime::SimTick>(token % 100);
+}
+// Returns - the delay before a token's next hop, in ticks
+SimTime::SimTick HopDelay(int token, int hop) {
+  return SimTime(kLookahead).ticks() +
+         static_cast<SimTime::SimTick>(((token * 7 + hop) % 5) * 25);
+}
+// Returns - one event's part of the checksum
+uint64_t EventHash(SimTime::SimTick ticks, int token, int hop) {
+  uint64_t hash = ticks * 0x9E3779B97F4A7C15ULL;
+  hash ^= static_cast<uint64_t>(token) * 1000003ULL + hop;
+  return hash * 0xBF58476D1CE4E5B9ULL;
+}
+
+// One hop of a token.  Sent between the LPs, so it can be serialized.
+class TokenEvent final : public SimBaseEvent {
+ public:
+  static const uint16_t kEventTypeId = 1;
+
+  TokenEvent(const SimTime &event_time, int32_t token, int32_t hop)
+      : SimBaseEvent(event_time), token_(token), hop_(hop) {};
+  virtual ~TokenEvent() {};
+
+  virtual bool Serialize(char *buffer, size_t capacity, size_t *size) const {
+    if (capacity < sizeof(token_) + sizeof(hop_)) {
+      return false;
+    }
+    memcpy(buffer, &token_, sizeof(token_));
+    memcpy(buffer + sizeof(token_), &hop_, sizeof(hop_));
+    *size = sizeof(token_) + sizeof(hop_);
+    return true;
+  }
+
+  static SimBaseEvent *Deserialize(const SimTime &event_time,
+                                   const char *payload, size_t size) {
+    int32_t token;
+    int32_t hop;
+    if (size != sizeof(token) + sizeof(hop)) {
+      return nullptr;
+    }
+    memcpy(&token, payload, sizeof(token));
+    memcpy(&hop, payload + sizeof(token), sizeof(hop));
+    return new TokenEvent(event_time, token, hop);
+  }
+
+  virtual void Dispatch() const {
+    const SimTime::SimTick ticks = event_time().ticks();
+    out_of_order = out_of_order || (ticks < last_ticks);
+    last_ticks = ticks;
+    tally.dispatched++;
+    tally.checksum += EventHash(ticks, token_, hop_);
+    if (hop_ < kHopCount) {
+      ShmExec *exec = ShmExec::current();
+      const uint32_t next = NextLp(exec->id(), token_, hop_,
+                                   exec->lp_count());
+      exec->SendEvent(next, new TokenEvent(
+          SimTime::FromTicks(ticks + HopDelay(token_, hop_)), token_,
+          hop_ + 1));
+    }
+  }
+
+ private:
+  int32_t token_;
+  int32_t hop_;
+
+  DISALLOW_COPY_AND_ASSIGN(TokenEvent);
+};
+
+void CopyrightNotice() {
+  std::cout << kCommonCopyright << std::endl <<std::endl;
+}
+
+void InitSession(long argc, char * argv[]) {
+
+  std::cout << "\n**********************************************"
+               "\n***  Welcome to the Shared Memory Test!    ***"
+               "\n**********************************************"
+            << std::endl;
+
+  CopyrightNotice();
+}
+
+// Prints the result of one check and updates the counters.
+//
+// "label" - text describing the check
+// "result" - "true" if the check passed
+// "passed" / "failed" - counters to update
+void Report(const std::string &label, bool result,
+            int *passed, int *failed) {
+  const int indent = 3;
+  std::cout << label << ":";
+  if (result) {
+    std::cout << std::setw(indent) << ' ' << "Passed!\n";
+    (*passed)++;
+  } else {
+    std::cout << "!!! FAILED !!!\n";
+    (*failed)++;
+  }
+}
+
+// Walks every token through its hops, without an executive.
+//
+// "lp_count" - number of LPs
+// "id" - the LP to tally
+// Returns - what LP "id" should see
+LpTally SequentialTally(uint32_t lp_count, uint32_t id) {
+  const SimTime::SimTick end = SimTime(kRunUntil).ticks();
+  LpTally expected = {0, 0};
+  for (int token = 0; token < kTokenCount; ++token) {
+    uint32_t lp = FirstLp(token, lp_count);
+    SimTime::SimTick ticks = StartTicks(token);
+    for (int hop = 0; (hop <= kHopCount) && (ticks <= end); ++hop) {
+      if (lp == id) {
+        expected.dispatched++;
+        expected.checksum += EventHash(ticks, token, hop);
+      }
+      ticks += HopDelay(token, hop);
+      lp = NextLp(lp, token, hop, lp_count);
+    }
+  }
+  return expected;
+}
+
+// Runs one worker's LP.  Called in the worker's own process.
+//
+// "lp_count" - number of LPs
+// "id" - index of the worker's LP
+// Returns - zero if the LP saw what it should have
+int RunWorker(uint32_t lp_count, uint32_t id) {
+  ShmExec exec(kSegmentName, id, kLookahead);
+  exec.RegisterEventType<TokenEvent>();
+  for (int token = 0; token < kTokenCount; ++token) {
+    if (FirstLp(token, lp_count) == id) {
+      exec.lp()->ScheduleEvent(new TokenEvent(
+          SimTime::FromTicks(StartTicks(token)), token, 0));
+    }
+  }
+  bool ok = true;
+  if ((lp_count > 1) && (id == 0)) {
+    // Within the lookahead, so it must be refused
+    ok = !exec.SendEvent(1, new TokenEvent(SimTime(0.5), 0, 0));
+  }
+  exec.Run(SimTime(kRunUntil));
+  const LpTally expected = SequentialTally(lp_count, id);
+  ok = ok && !out_of_order && (tally.dispatched == expected.dispatched) &&
+       (tally.checksum == expected.checksum) &&
+       (exec.lp()->dispatched_count() == expected.dispatched);
+  if (lp_count > 1) {
+    ok = ok && (exec.sent_count() > 0) && (exec.received_count() > 0);
+  }
+  std::cout << "  LP " << id << " of " << lp_count << ": dispatched "
+            << tally.dispatched << " (expected " << expected.dispatched
+            << "), sent " << exec.sent_count() << ", received "
+            << exec.received_count() << ", null messages "
+            << exec.null_message_count() << "\n";
+  return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+  InitSession(argc, argv);
+  // Results counters
+  int passed = 0;
+  int failed = 0;
+
+  const SimTime::SimTick odd_ticks = 12345;
+  Report("Times survive a round trip through ticks",
+         SimTime::FromTicks(odd_ticks).ticks() == odd_ticks,
+         &passed, &failed);
+
+  const uint32_t process_counts[] = {1, 2, 4};
+  for (uint32_t lp_count : process_counts) {
+    for (int pin = 0; pin < 2; ++pin) {
+      const std::string label(std::to_string(lp_count) + " processes" +
+                              (pin ? ", pinned," : ""));
+      const uint32_t worker_failures = ShmLauncher::Launch(
+          kSegmentName, lp_count, pin != 0,
+          [lp_count](uint32_t id) { return RunWorker(lp_count, id); });
+      Report(label + " match the sequential walk", worker_failures == 0,
+             &passed, &failed);
+    }
+  }
+  const uint32_t kFailingCount = 4;
+  const uint32_t kFailingId = 2;
+  const uint32_t stopped_failures = ShmLauncher::Launch(
+      kSegmentName, kFailingCount, false, [kFailingCount](uint32_t id) {
+        return (id == kFailingId) ? 1 : RunWorker(kFailingCount, id);
+      });
+  Report("A failed worker stops the run", stopped_failures == kFailingCount,
+         &passed, &failed);
+  const int segment = shm_open(kSegmentName, O_RDWR, 0600);
+  Report("The launcher removes the segment", segment < 0, &passed, &failed);
+  if (segment >= 0) {
+    close(segment);
+    ShmExec::RemoveSegment(kSegmentName);
+  }
+
+  std::cout << "\n\n";
+  // Results for the test(s) that just ran
+  std::string label("AUTOMATIC SHARED MEMORY EXECUTIVE TEST RESULTS");
+  SharedPrintFinalResults(label, passed, failed);
+  // The script reads the pass count from a file
+  SharedExportPassCount(passed);
+
+  // Summary
+  if (failed == 0) {
+    std::cout << "\nSUCCESSS!\n\n";
+  } else {
+    std::cout << "\n!!! FAILURE !!!\n\n";
+  }
+  return failed;
+}
@@ -47,7 +47,9 @@ ParsedArgs::ParsedArgs() {
   config_path_ = "./setup.txt";
   log_path_ = "./logfile.csv";
   stimulus_path_ = "./stim.csv";
+  event_set_ = "HEAP";
   run_until_time_ = 1.0E5;
+  prefetch_ = false;
   display_help_ = false;
 }
 
@@ -60,6 +62,12 @@ ParsedArgs::~ParsedArgs() {
 #ifdef TEST_HARNESS
 // Dump the member data for debugging.
 void ParsedArgs::Dump() {
+  std::string prefetch;
+  if (prefetch_) {
+    prefetch = "YES";
+  } else {
+    prefetch = "NO";
+  }
   std::string show_help;
   if (display_help_) {
     show_help = "YES";
@@ -69,7 +77,9 @@ void ParsedArgs::Dump() {
   std::cout << "\nConfig Path:  " << config_path_
             << "\nStimul Path:  " << stimulus_path_
             << "\nLog    Path:  " << log_path_
+            << "\nEvent Set:    " << event_set_
             << "\nRun Until:    " << run_until_time_
+            << "\nPrefetch:     " << prefetch
             << "\nShow Help:    " << show_help
             << std::endl;
 }
@@ -244,6 +254,18 @@ bool ArgParser::ParseArgs(long argc, char *argv[]) {
       // by extracting the "-*", where '*' represents the flag and using
       // the remaining substring.
       switch (*(*argv + 1) = toupper(*(*argv + 1))) {
+        case 'A':
+          // Read the stimulus ahead.  As with help, the full word is
+          // accepted too.  Not "-P", which text_replications.exe takes
+          // for its thread count.
+          if (strlen(*argv) == 2) {
+            parsed_args_.prefetch_ = true;
+          } else if (strlen(*argv) == 6 && CheckArg(*argv, "-AHEAD")) {
+            parsed_args_.prefetch_ = true;
+          } else {
+            bad_arg = true;
+          }
+          break;
         case 'C':
           // Configuration file name
           if (0 != *(*argv + 2))
@@ -270,6 +292,16 @@ bool ArgParser::ParseArgs(long argc, char *argv[]) {
           if (0 != *(*argv + 2))
             parsed_args_.log_path_ = (*argv + 2);
           break;
+        case 'Q':
+          // Pending event set (queue) implementation.  Names are case
+          // insensitive, so store the upper case form.
+          if (0 != *(*argv + 2)) {
+            parsed_args_.event_set_ = (*argv + 2);
+            std::transform(parsed_args_.event_set_.begin(),
+                           parsed_args_.event_set_.end(),
+                           parsed_args_.event_set_.begin(), toupper);
+          }
+          break;
         case 'S':
           // Stimulus file name
           if (0 != *(*argv + 2))
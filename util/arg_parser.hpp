@@ -48,7 +48,12 @@ class ParsedArgs {
   std::string config_path_;
   std::string log_path_;
   std::string stimulus_path_;
+  // Upper case name of the pending event set implementation.  Validated
+  // by the simulation executive, not the parser.
+  std::string event_set_;
   SimTime::UserTime run_until_time_;
+  // "true" to read each stimulus window ahead, on a thread of its own
+  bool prefetch_;
   bool display_help_;
  private:
   // As per the coding standard
@@ -43,7 +43,7 @@ void DisplayHelp(const std::string &exe_name,
   "\n"
   "Usage:  " << exe_name << " [-CPathToConfigFile] [-LPathToLogFile]\n"
   "                      [-SPathToStimulusFile] [-TRunUntilTime]\n"
-  "                      [-h]\n"
+  "                      [-QEventSet] [-A] [-h]\n"
   "\n"
   "    Required Arguments:\n"
   "\n"
@@ -51,6 +51,9 @@ void DisplayHelp(const std::string &exe_name,
   "\n"
   "    Optional Arguments:\n"
   "\n"
+  "        \"-A\" Optionally followed immediately by the string \"HEAD\"\n"
+  "             reads each window of stimulus ahead, on a thread of its\n"
+  "             own, while the previous window is simulated.\n"
   "        \"-C\" Followed immediately by a string specifying the pathname\n"
   "             for the parameter configuration file.\n"
   "             If this argument is not specified, \"./setup.txt\" will\n"
@@ -59,6 +62,19 @@ void DisplayHelp(const std::string &exe_name,
   "             for the data log file.\n"
   "             If this argument is not specified, \"./logfile.csv\" will\n"
   "             be used.\n"
+  "        \"-Q\" Followed immediately by a string naming the data\n"
+  "             structure that holds the pending simulation events.\n"
+  "             Recognized names are \"HEAP\" (a 4-ary heap),\n"
+  "             \"LIST\" (a sorted linked list), \"CALENDAR\" (a\n"
+  "             self-resizing calendar queue), \"LADDER\" (a ladder\n"
+  "             queue, for bursty or skewed event times), and\n"
+  "             \"RADIX\" (a monotone radix heap on the tick count), in\n"
+  "             any case.  \"WHEEL\" puts a hierarchical timing wheel\n"
+  "             for near future events in front of a \"HEAP\", and\n"
+  "             \"WHEEL+\" followed by one of the other names puts it\n"
+  "             in front of that set instead.\n"
+  "             If this argument is not specified, \"HEAP\" will be\n"
+  "             used.\n"
   "        \"-S\" Followed immediately by a string specifying the pathname\n"
   "             for the the stimulus file.\n"
   "             If this argument is not specified, \"./stim.csv\" will\n"
@@ -56,6 +56,15 @@ SimTime::SimTime(const SimTime::UserTime to_time) {
 }
 
 
+// Sets the ticks directly, so that the time survives a round trip
+// through ticks() exactly.
+SimTime SimTime::FromTicks(SimTime::SimTick ticks) {
+  SimTime result;
+  result.ticks_ = ticks;
+  return result;
+}
+
+
 // Copy Ctor, copies time from 'other'.
 // Although this violates the coding standard, it seemed reasonable for the
 // sake of efficiency, since time objects are often embedded in other
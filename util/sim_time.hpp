@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <string>
 
 #include "basic_defs.hpp"
 
@@ -38,7 +39,7 @@ class SimTime {
 
   // Type representing the internal simulator "ticks" - This is only public so
   // that the typedef can be used for internal module const static 
-  // initialization.
+  // initialization, and by the simulation executive's event sets.
   // Don't use this in your code, as future changes may break your code.
   typedef uint64_t SimTick;
 
@@ -137,13 +138,22 @@ class SimTime {
   // Returns - a string representing max UserTime
   static std::string GetMaxUserTimeLongString();
 
-#ifdef TEST_HARNESS
-  // Test/debug accessor for the simulation ticks.  Should never be used in
-  // production code, but needed for test harness.
+  // Accessor for the simulation ticks.  Intended for the simulation
+  // executive's pending event sets, which key their buckets directly on
+  // the integral tick count.  Model code should stick to UserTime.
   //
   // Returns - number of ticks represented by this object
   SimTick ticks() const { return ticks_; }
 
+  // Builds a time from a tick count, e.g. one read back from an event sent
+  // between processes.  As with ticks(), meant for the simulation
+  // executive, not model code.
+  //
+  // "ticks" - number of simulation ticks
+  // Returns - the time that "ticks" represents
+  static SimTime FromTicks(SimTick ticks);
+
+#ifdef TEST_HARNESS
   // Test/debug accessor for the ticks/user time unit factor.  Probably
   // shouldn't be used in production code, but useful for the test harness.
   //